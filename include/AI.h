@@ -3,19 +3,22 @@
 
 #include "Board.h"
 #include "Piece.h"
+#include "Move.h"
+#include "SearchStats.h"
+#include <atomic>
+#include <functional>
+#include <random>
 #include <vector>
 #include <tuple>
 
-struct Move {
-    int fromRow, fromCol;
-    int toRow, toCol;
+class OpeningExplorer;
+
+// A root move together with the score it received in the last iteration
+struct ScoredMove {
+    Move move;
     int score = 0;
 
-    bool operator==(const Move& other) const {
-        return fromRow == other.fromRow && fromCol == other.fromCol &&
-               toRow == other.toRow && toCol == other.toCol;
-    }
-    bool operator<(const Move& other) const {
+    bool operator<(const ScoredMove& other) const {
         return score > other.score;
     }
 };
@@ -24,21 +27,48 @@ class AI {
 public:
     AI(Color aiColor, int maxDepth);
     std::tuple<int, int, int, int> getBestMove(const Board& board);
+    // Same search, returning the move with its flags; Move::none() if there is none
+    Move findBestMove(const Board& board);
+
+    // Searches poll this flag and return the best move of the last completed
+    // iteration once it is set. Used when the AI runs on a worker thread.
+    void setStopFlag(const std::atomic<bool>* stop) { stopFlag = stop; }
+    // Called after every completed iterative deepening iteration
+    void setProgressCallback(std::function<void(const DepthStats&, Move)> callback) { progressCallback = std::move(callback); }
+    // While the position is in the book, a book move is played without searching
+    void setOpeningBook(const OpeningExplorer* book, uint32_t seed) { openingBook = book; bookRng.seed(seed); }
+    // Nodes visited by the last getBestMove call
+    uint64_t getNodeCount() const { return stats.nodes; }
+    // Statistics of the last getBestMove call; see SearchStats.h
+    const SearchStats& getSearchStats() const { return stats; }
+    // Static evaluation in centipawns from aiColor's point of view
+    int evaluateBoard(const Board& board);
 
 private:
     Color aiColor;
     int maxDepth;
     Color opponentColor;
+    SearchStats stats;
+    const std::atomic<bool>* stopFlag = nullptr;
+    bool aborted = false;
+    std::function<void(const DepthStats&, Move)> progressCallback;
+    const OpeningExplorer* openingBook = nullptr;
+    std::mt19937 bookRng;
+
+    // Root moves of the current search, re-sorted best-first after every
+    // iteration so the next depth searches the previous best move first.
+    std::vector<ScoredMove> rootMoves;
 
-    Move minimaxRoot(const Board& board, int depth);
+    ScoredMove minimaxRoot(const Board& board, int depth, int alpha, int beta);
+    ScoredMove searchWithAspiration(const Board& board, int depth, int previousScore);
     int minimax(Board board, int depth, int alpha, int beta, bool isMaximizingPlayer);
 
-    int evaluateBoard(const Board& board);
     int getPieceValue(PieceType type);
 
-    std::vector<Move> generateLegalMoves(const Board& board, Color color);
+    void generateLegalMoves(const Board& board, Color color, MoveList& moves);
+    void orderMoves(const Board& board, MoveList& moves);
 
-    bool applyMoveSimulation(Board& board, const Move& move);
+    bool applyMoveSimulation(Board& board, Move move);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+#include "MappedFile.h"
+#include "Move.h"
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Board;
+
+// One engine result as stored on disk
+struct AnalysisRecord {
+    uint64_t position;      // Zobrist key
+    uint32_t engine;        // AnalysisCache::engineId of the engine's name
+    int32_t moveTimeMs;     // "go movetime" of the search, 0 for fixed-depth searches
+    int16_t depth;          // depth the search completed
+    int16_t score;          // centipawns for the side to move
+    uint16_t bestMove;      // Move::raw()
+    uint16_t reserved;
+    uint32_t nodes;
+    uint32_t checksum;
+};
+
+static_assert(sizeof(AnalysisRecord) == 32, "analysis records are written to disk as-is");
+
+// Engine results keyed by position, engine and movetime, kept across runs.
+// The file is append-only: it is memory-mapped once when opened, every new
+// result is appended and flushed at once, and an open-addressing index in
+// memory points at the deepest record per key. Several processes may append
+// to the same file; each sees the others' results the next time it opens it.
+// All members are safe to call from any thread.
+class AnalysisCache {
+public:
+    AnalysisCache() = default;
+    AnalysisCache(const AnalysisCache&) = delete;
+    AnalysisCache& operator=(const AnalysisCache&) = delete;
+
+    // Creates the file if needed. A file with a foreign header is started over.
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const;
+
+    static uint32_t engineId(const std::string& engineName);
+
+    // The stored result for the key if it searched at least minDepth
+    bool find(uint64_t position, uint32_t engine, int moveTimeMs, int minDepth, AnalysisRecord& record);
+    // Appends the result unless an equally deep one is already stored
+    void store(uint64_t position, uint32_t engine, int moveTimeMs, int depth, int score, Move bestMove,
+               uint64_t nodes);
+
+    // The stored result for a search of board with "go movetime moveTimeMs",
+    // or with "go depth depth" when moveTimeMs is 0. Only a move that is legal
+    // on board is returned, which also guards against key collisions.
+    bool findMove(const Board& board, uint32_t engine, int moveTimeMs, int depth, AnalysisRecord& record,
+                  Move& move);
+    void storeMove(const Board& board, uint32_t engine, int moveTimeMs, int depth, int score, Move bestMove,
+                   uint64_t nodes);
+
+    size_t size() const;
+    uint64_t hits() const;
+    uint64_t misses() const;
+
+private:
+    void insert(const AnalysisRecord* record);
+    size_t slotFor(uint64_t position, uint32_t engine, int32_t moveTimeMs) const;
+
+    mutable std::mutex m_mutex;
+    MappedFile m_mapped;
+    std::ofstream m_out;
+    // Records appended since the file was mapped; a deque keeps them in place
+    std::deque<AnalysisRecord> m_appended;
+    std::vector<const AnalysisRecord*> m_slots;
+    size_t m_count = 0;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include "SDLIncludes.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// An image with its colour key already applied, as RGBA bytes
+struct AssetImage {
+    std::string name;       // file name inside images/, e.g. "wK.bmp"
+    int width = 0;
+    int height = 0;
+    const uint32_t* pixels = nullptr;
+};
+
+// All game images in one memory-mapped file, run-length encoded. Decoding
+// runs on a pool of threads, checks each image's pixel hash and saves the
+// output to a cache file keyed by the pack's content hash, so later
+// startups map the pixels straight from the cache. A rebuilt pack changes
+// the content hash and forces a fresh, checked decode.
+//
+// The pack is written by tools/pack_assets.cpp at build time in the
+// machine's native byte order.
+class AssetPack {
+public:
+    static const char* const DEFAULT_PATH;
+
+    bool open(const std::string& path);
+    // Fills images() from cachePath when it matches this pack, otherwise
+    // decodes and rewrites the cache. threads = 0 uses every core.
+    bool decode(const std::string& cachePath, unsigned threads = 0);
+    void close();
+
+    bool isDecoded() const { return m_decoded; }
+    const std::vector<AssetImage>& images() const { return m_images; }
+    const AssetImage* find(const std::string& name) const;
+    SDL_Texture* createTexture(SDL_Renderer* renderer, const std::string& name) const;
+
+    // Packer side: images must carry their pixels
+    static bool write(const std::string& path, const std::vector<AssetImage>& images);
+
+private:
+    struct Entry;
+
+    bool loadCache(const std::string& cachePath);
+    void saveCache(const std::string& cachePath) const;
+
+    MappedFile m_pack;
+    MappedFile m_cache;
+    const Entry* m_entries = nullptr;
+    uint32_t m_count = 0;
+    uint64_t m_contentHash = 0;
+    std::vector<AssetImage> m_images;
+    std::vector<std::vector<uint32_t>> m_decodedPixels;
+    bool m_decoded = false;
+};
+
+// Texture for images/<file>: from the pack when it has the image, otherwise
+// loaded from the BMP with magenta keyed out
+SDL_Texture* loadImageTexture(SDL_Renderer* renderer, const AssetPack& assets, const char* path);
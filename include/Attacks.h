@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include "PieceTypes.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Precomputed attack tables on 64-bit square sets. Bit (row * 8 + col)
+// stands for that square, matching the Move and Zobrist square indices.
+namespace Attacks {
+
+inline uint64_t squareBit(int square) { return 1ULL << square; }
+
+inline int lsb(uint64_t bb) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bb);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bb);
+#endif
+}
+
+inline int msb(uint64_t bb) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, bb);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(bb);
+#endif
+}
+
+inline int popLsb(uint64_t& bb) {
+    int square = lsb(bb);
+    bb &= bb - 1;
+    return square;
+}
+
+inline int popCount(uint64_t bb) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(bb));
+#else
+    return __builtin_popcountll(bb);
+#endif
+}
+
+uint64_t knight(int square);
+uint64_t king(int square);
+// Squares a pawn of the given color on square attacks
+uint64_t pawn(Color color, int square);
+uint64_t bishop(int square, uint64_t occupied);
+uint64_t rook(int square, uint64_t occupied);
+inline uint64_t queen(int square, uint64_t occupied) { return bishop(square, occupied) | rook(square, occupied); }
+
+}
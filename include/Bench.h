@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+struct BenchResult {
+    int positions = 0;
+    uint64_t nodes = 0;     // the signature: changes only when the search does
+    double seconds = 0.0;
+
+    double nodesPerSecond() const { return seconds > 0.0 ? nodes / seconds : 0.0; }
+};
+
+// Fixed positions from openings, middlegames and endgames
+const std::vector<std::string>& benchPositions();
+
+// Searches every bench position to depth with a fresh AI on the calling
+// thread, printing the nodes of each. The search has no transposition table
+// or other state carried between searches, so the total node count is the
+// same on every machine and build for the same search code.
+BenchResult runBench(int depth, std::ostream& progress);
@@ -4,6 +4,7 @@
 #include <memory>
 #include "SDLIncludes.h"
 #include "Piece.h"
+#include "Move.h"
 #include <iostream>
 #include <tuple>
 #include <unordered_map>
@@ -14,93 +15,66 @@ enum class GameState {
     Checkmate,
     Stalemate
 };
-extern std::atomic<bool> g_validMovesComputed;
+
+// Piece placement as bitboards, indexed [Color][PieceType]. Built from the
+// square array on demand; see Attacks.h for the square numbering.
+struct Bitboards {
+    uint64_t pieces[2][6];
+    uint64_t colors[2];
+    uint64_t occupied;
+};
+
 class Board {
     friend class AI;
 private:
-    static const int SQUARE_SIZE = 75;
-    std::vector<std::vector<Piece*>> m_squares;
+    // Mailbox indexed by square (row * 8 + col)
+    Piece m_squares[64];
     Color m_currentTurn;
-    GameState m_gameState;
-    std::unordered_map<Piece*, std::vector<SDL_Point>> m_legalMoveCache;
-    int m_selectedRow;
-    int m_selectedCol;
-    bool m_pieceSelected;
-    std::vector<SDL_Point> m_validMoves;
 
     int m_whiteKingRow;
     int m_whiteKingCol;
     int m_blackKingRow;
     int m_blackKingCol;
 
-    Piece* m_lastMovedPawn;
+    // Square of a pawn that just advanced two squares, as row and column,
+    // or -1 for both
+    int m_enPassantRow;
     int m_enPassantCol;
-
-    Piece* m_movingPiece;
-    float m_animStartX;
-    float m_animStartY;
-    float m_animEndX;
-    float m_animEndY;
-    float m_animProgress;
-    bool m_animating;
-    int m_moveFromRow, m_moveFromCol;
-    int m_moveToRow, m_moveToCol;
-    Piece* m_capturedPiece;
-    static const std::vector<SDL_Point> knightMoves[64];
-    bool m_whiteCanCastleKingside = true;
-    bool m_whiteCanCastleQueenside = true;
-    bool m_blackCanCastleKingside = true;
-    bool m_blackCanCastleQueenside = true;
+    // One bit per castling right; cleared when the king or the rook leaves
+    // its start square or the rook is captured there
+    uint8_t m_castlingRights = 0;
+    int m_halfmoveClock = 0;
+    int m_fullmoveNumber = 1;
 public:
     bool isInCheck(Color color) const;
-    Board(const Board& other);
-    Board& operator=(const Board& other);
     bool hasLegalMoves(Color color) const;
-    void updateGameState();
-    void calculateValidMoves(int row, int col);
     bool movePieceForSimulation(int fromRow, int fromCol, int toRow, int toCol);
-    void updateLegalMoveCache(Color color);
 
-    std::vector<SDL_Point> fastGenerateMoves(Piece* piece) const;
+    // Appends the pseudo-legal moves of the piece on square, with flags, to moves
+    void fastGenerateMoves(int square, MoveList& moves) const;
+    // Fills moves with every legal move for color
+    void generateLegalMoves(Color color, MoveList& moves) const;
+    // Plays a move immediately (no animation) and passes the turn
+    bool makeMove(Move move);
 
-    std::vector<SDL_Point> m_candidateMoves;
     Board();
-    ~Board();
     std::string getPositionKey() const;
     void initialize();
-    Piece* getPiece(int row, int col) const;
-    bool movePiece(int fromRow, int fromCol, int toRow, int toCol);
-    void handleClick(int x, int y);
-    void render(SDL_Renderer* renderer, const Game& game) const;
-    void updateAnimation(float deltaTime);
-    bool isPieceSelected() const { return m_pieceSelected; }
+    // An empty piece off the board
+    Piece getPiece(int row, int col) const;
+    Piece getPiece(int square) const { return m_squares[square]; }
     Color getCurrentTurn() const { return m_currentTurn; }
-    GameState getGameState() const { return m_gameState; }
-    bool isAnimating() const { return m_animating; }
-    void completeMoveAfterAnimation();
     bool isSquareUnderAttack(int row, int col, Color attackingColor) const;
-    void checkForPromotion();
-    void calculateValidMovesAsync(int row, int col);
-    bool isAnimationDone() const {
-
-        static float lastProgress = 0.0f;
-        static bool lastAnimState = false;
-
-        if (m_animating != lastAnimState ||
-            (m_animating && std::abs(m_animProgress - lastProgress) > 0.05f)) {
-
-            lastProgress = m_animProgress;
-            lastAnimState = m_animating;
-        }
-
-        return !m_animating;
-    }
-    std::vector<SDL_Point> generateCandidateMoves(Piece* piece) const;
-    void screenToBoard(int screenX, int screenY, int& boardRow, int& boardCol) const;
-    void placePiece(Piece* piece, int row, int col);
-    Piece* getLastMovedPawn() const;
+    Bitboards getBitboards() const;
+    // Pieces of both colors attacking square, given the occupancy
+    uint64_t attackersTo(int square, uint64_t occupied, const Bitboards& bitboards) const;
+    // Static exchange evaluation: material balance in centipawns for the
+    // side making the capture once every recapture on the target square has
+    // been played out, x-rays included
+    int staticExchange(Move move) const;
+    int staticExchange(Move move, const Bitboards& bitboards) const;
+    void placePiece(Piece piece, int row, int col);
     int getEnPassantCol() const;
-    bool isValidMovesComputed() const;
     std::vector<std::tuple<int, int, int, int>> getPins(Color color) const;
     std::vector<std::tuple<int, int, int, int>> getChecks(Color color) const;
     bool alignsWithPin(int fromRow, int fromCol, int toRow, int toCol, std::pair<int, int> pinDir) const;
@@ -109,7 +83,7 @@ public:
     bool isStalemate() const;
     bool isBlockingCheck(int row, int col, int kingRow, int kingCol,int attackerRow, int attackerCol) const;
     void updateKingPosition(Color color, int row, int col);
-    void setEnPassantTarget(Piece* pawn, int col);
+    void setEnPassantTarget(int row, int col);
     void clearEnPassantTarget();
     void setCurrentTurn(Color turn){
         m_currentTurn = turn;
@@ -122,12 +96,12 @@ public:
         for (int r = 7; r >= 0; --r) {
             std::cout << r << " | ";
             for (int c = 0; c < 8; ++c) {
-                Piece* p = m_squares[r][c];
+                Piece p = m_squares[r * 8 + c];
                 if (!p) {
                     std::cout << ". ";
                 } else {
                     char typeChar;
-                    switch (p->getType()) {
+                    switch (p.getType()) {
                         case PieceType::Pawn: typeChar = 'p'; break;
                         case PieceType::Knight: typeChar = 'n'; break;
                         case PieceType::Bishop: typeChar = 'b'; break;
@@ -136,7 +110,7 @@ public:
                         case PieceType::King: typeChar = 'k'; break;
                         default: typeChar = '?'; break;
                     }
-                    std::cout << (p->getColor() == Color::White ? (char)toupper(typeChar) : typeChar) << " ";
+                    std::cout << (p.getColor() == Color::White ? (char)toupper(typeChar) : typeChar) << " ";
                 }
             }
             std::cout << "|" << std::endl;
@@ -147,26 +121,28 @@ public:
           std::cout << "    WK: (" << m_whiteKingRow << "," << m_whiteKingCol << ") BK: (" << m_blackKingRow << "," << m_blackKingCol << ")" << std::endl;
 
     }
-    void setSquare(int row, int col, Piece* piece);
+    void setSquare(int row, int col, Piece piece);
         // Add this to your Board.h
     std::pair<int, int> getEnPassantTarget() const {
-        if (m_lastMovedPawn == nullptr || m_enPassantCol == -1) {
+        if (m_enPassantCol == -1) {
             return {-1, -1};
         }
         
         // Return the square behind the pawn that just moved two squares
-        int row = m_lastMovedPawn->getColor() == Color::White ? 2 : 5;
+        int row = m_enPassantRow == 3 ? 2 : 5;
         return {row, m_enPassantCol};
     }
     
-    // Add these methods if they don't exist already
-    bool canCastleKingside(Color color) const {
-        return color == Color::White ? m_whiteCanCastleKingside : m_blackCanCastleKingside;
-    }
-    
-    bool canCastleQueenside(Color color) const {
-        return color == Color::White ? m_whiteCanCastleQueenside : m_blackCanCastleQueenside;
-    }
+    // Castling rights, checked against the king and rook still being in place
+    bool canCastleKingside(Color color) const;
+    bool canCastleQueenside(Color color) const;
+    int getHalfmoveClock() const { return m_halfmoveClock; }
+    int getFullmoveNumber() const { return m_fullmoveNumber; }
+    // Half-moves played since the fullmove counter started; changes with every committed move
+    int getPly() const { return 2 * (m_fullmoveNumber - 1) + (m_currentTurn == Color::Black ? 1 : 0); }
+    // Sets up the position from a FEN string (rank 1 is row 0). Returns false
+    // and leaves the board unchanged if the string cannot be parsed.
+    bool loadFEN(const std::string& fen);
     int getWhiteKingRow() const { return m_whiteKingRow; }
     int getWhiteKingCol() const { return m_whiteKingCol; }
     int getBlackKingRow() const { return m_blackKingRow; }
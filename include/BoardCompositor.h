@@ -0,0 +1,61 @@
+#pragma once
+#include "SDLIncludes.h"
+#include "BoardLayout.h"
+#include "RenderBatch.h"
+#include <cstdint>
+
+class Board;
+class BoardView;
+class PieceAtlas;
+
+struct BoardTheme {
+    SDL_Color lightSquare = {240, 217, 181, 255};
+    SDL_Color darkSquare = {181, 136, 99, 255};
+    SDL_Color selectedSquare = {186, 202, 43, 128};
+    SDL_Color targetSquare = {186, 202, 43, 96};
+};
+
+// Draws the board as separate layers, bottom to top. The checkerboard is
+// rendered once into a target texture; highlights and pieces are kept as
+// geometry and rebuilt only when the position, selection or animation
+// changes. Game overlays are drawn on top by the caller.
+class BoardCompositor {
+public:
+    enum Layer { StaticBoard, Highlights, Pieces, LayerCount };
+
+    BoardCompositor() = default;
+    ~BoardCompositor();
+    BoardCompositor(const BoardCompositor&) = delete;
+    BoardCompositor& operator=(const BoardCompositor&) = delete;
+
+    void setAtlas(const PieceAtlas& atlas) { m_atlas = &atlas; }
+    void setTheme(const BoardTheme& theme);
+    // A new square size also needs the atlas scaled to match
+    void setLayout(const BoardLayout& layout);
+    const BoardLayout& getLayout() const { return m_layout; }
+
+    void invalidate(Layer layer) { m_dirty[layer] = true; }
+    void invalidateAll();
+    // Frees the static layer texture; it is recreated on the next draw
+    void releaseTextures();
+
+    void draw(SDL_Renderer* renderer, const Board& board, const BoardView& view);
+
+private:
+    bool buildStaticLayer(SDL_Renderer* renderer);
+
+    const PieceAtlas* m_atlas = nullptr;
+    BoardTheme m_theme;
+    BoardLayout m_layout;
+    SDL_Texture* m_staticLayer = nullptr;
+    RenderBatch m_highlights;
+    RenderBatch m_pieces;
+    bool m_dirty[LayerCount] = {true, true, true};
+
+    // What the cached layers were built from
+    SDL_Texture* m_atlasTexture = nullptr;
+    int m_atlasCellSize = 0;
+    uint64_t m_positionKey = 0;
+    int m_selectedSquare = -1;
+    bool m_wasAnimating = false;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include "SDLIncludes.h"
+#include <algorithm>
+
+// Where the board sits in the window. Squares are whole pixels so that the
+// cached layers line up exactly; the board is centered in the window.
+struct BoardLayout {
+    static constexpr int MIN_SQUARE_SIZE = 16;
+
+    int originX = 0;
+    int originY = 0;
+    int squareSize = 75;
+
+    static BoardLayout fromWindow(int width, int height) {
+        BoardLayout layout;
+        layout.squareSize = std::max(MIN_SQUARE_SIZE, std::min(width, height) / 8);
+        layout.originX = std::max(0, (width - layout.boardSize()) / 2);
+        layout.originY = std::max(0, (height - layout.boardSize()) / 2);
+        return layout;
+    }
+
+    int boardSize() const { return squareSize * 8; }
+
+    // x and y are in squares from the board's top-left corner (a8)
+    SDL_FRect rectAt(float x, float y) const {
+        return {originX + x * squareSize, originY + y * squareSize, (float)squareSize, (float)squareSize};
+    }
+    SDL_FRect squareRect(int row, int col) const {
+        return rectAt((float)col, (float)(7 - row));
+    }
+
+    // False if the point is outside the board
+    bool screenToSquare(int x, int y, int& row, int& col) const {
+        if (x < originX || y < originY || x >= originX + boardSize() || y >= originY + boardSize())
+            return false;
+        col = (x - originX) / squareSize;
+        row = 7 - (y - originY) / squareSize;
+        return true;
+    }
+
+    bool operator==(const BoardLayout& other) const {
+        return originX == other.originX && originY == other.originY && squareSize == other.squareSize;
+    }
+    bool operator!=(const BoardLayout& other) const { return !(*this == other); }
+};
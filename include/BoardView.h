@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include "Move.h"
+#include "Piece.h"
+
+class Board;
+class PieceAtlas;
+class RenderBatch;
+struct BoardLayout;
+struct BoardTheme;
+
+// The GUI's state on top of the position: the selected piece, the legal
+// destinations of each piece of the side to move and the move being
+// animated. Kept out of Board so the engine's copies carry only the position.
+class BoardView {
+public:
+    // Rebuilds the target table for the side to move and drops the
+    // selection; called when a turn starts
+    void refreshLegalTargets(const Board& board);
+    uint64_t getLegalTargets(int square) const { return m_legalTargets[square]; }
+
+    // Selects a piece of the side to move, or starts moving the selected
+    // piece to the clicked square if it is one of its targets
+    void handleClick(const Board& board, int x, int y, const BoardLayout& layout);
+    // Starts animating the legal move from one square to another; the board
+    // only changes when the piece lands. Returns false if there is no such move.
+    bool movePiece(const Board& board, int fromRow, int fromCol, int toRow, int toCol, PieceType promotion = PieceType::Queen);
+    // Advances the moving piece and plays its move on board once it lands
+    void updateAnimation(Board& board, float deltaTime);
+    bool isAnimating() const { return m_animating; }
+
+    // Append the selection and target highlights, or the pieces including
+    // the one in flight, to a layer's batch
+    void renderHighlights(RenderBatch& batch, const BoardTheme& theme, const BoardLayout& layout) const;
+    void renderPieces(RenderBatch& batch, const Board& board, const PieceAtlas& atlas, const BoardLayout& layout) const;
+
+    bool isPieceSelected() const { return m_selectedSquare >= 0; }
+    // Square index of the selected piece, or -1
+    int getSelectedSquare() const { return m_selectedSquare; }
+    void clearSelection() { m_selectedSquare = -1; }
+
+private:
+    int m_selectedSquare = -1;
+    // Filled once per turn so selection and highlighting are lookups
+    uint64_t m_legalTargets[64] = {};
+
+    Move m_pendingMove = Move::none();
+    Piece m_movingPiece;
+    float m_animProgress = 0.0f;
+    bool m_animating = false;
+};
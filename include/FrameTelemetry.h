@@ -0,0 +1,67 @@
+#pragma once
+#include "SDLIncludes.h"
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Fixed-bucket latency histogram: 0.1 ms buckets up to 100 ms, 10 ms
+// buckets up to 10 s for engine waits, and an overflow bucket above that.
+// Recording is O(1) and never allocates.
+class LatencyHistogram {
+public:
+    static const int FINE_BUCKETS = 1000;
+    static const int COARSE_BUCKETS = 990;
+    static const int BUCKET_COUNT = FINE_BUCKETS + COARSE_BUCKETS;
+    static constexpr double FINE_MS = 0.1;
+    static constexpr double COARSE_MS = 10.0;
+
+    static double bucketStartMs(int index) {
+        return index < FINE_BUCKETS ? index * FINE_MS : FINE_BUCKETS * FINE_MS + (index - FINE_BUCKETS) * COARSE_MS;
+    }
+    static double bucketEndMs(int index) { return bucketStartMs(index + 1); }
+
+    void record(double ms);
+    void clear() { *this = LatencyHistogram(); }
+
+    uint64_t count() const { return m_count; }
+    double meanMs() const { return m_count ? m_totalMs / m_count : 0.0; }
+    double maxMs() const { return m_maxMs; }
+    // Upper edge of the bucket holding the given fraction of samples;
+    // the exact maximum once that falls in the overflow bucket
+    double percentileMs(double fraction) const;
+    uint64_t bucket(int index) const { return m_buckets[index]; }
+    uint64_t overflow() const { return m_overflow; }
+
+private:
+    uint64_t m_buckets[BUCKET_COUNT] = {};
+    uint64_t m_overflow = 0;
+    uint64_t m_count = 0;
+    double m_totalMs = 0.0;
+    double m_maxMs = 0.0;
+};
+
+// UI responsiveness figures collected by the game loop when enabled
+class FrameTelemetry {
+public:
+    enum Metric { Frame, Update, Render, AiWait, ClickToHighlight, MetricCount };
+    using Clock = std::chrono::steady_clock;
+
+    static const char* metricName(Metric metric);
+    static double elapsedMs(Clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+    }
+
+    void record(Metric metric, double ms) { m_histograms[metric].record(ms); }
+    const LatencyHistogram& histogram(Metric metric) const { return m_histograms[metric]; }
+
+    // One row per non-empty bucket: metric,bucket_start_ms,bucket_end_ms,count.
+    // The overflow bucket has an empty end.
+    void writeCsv(std::ostream& out) const;
+    // p50/p95/p99 per metric as an aligned table
+    void writeSummary(std::ostream& out) const;
+    // Percentile bars against a 60 Hz frame budget, labelled on SDL3
+    void drawOverlay(SDL_Renderer* renderer, float x, float y) const;
+
+private:
+    LatencyHistogram m_histograms[MetricCount];
+};
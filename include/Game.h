@@ -5,10 +5,15 @@
 #include <string>
 #include "Board.h"
 #include "Piece.h"
-#include "StockFish.h"
-#include <future>
-#include <thread>
-#include <atomic>
+#include "GameRules.h"
+#include "OpeningExplorer.h"
+#include "Pgn.h"
+#include "SearchWorker.h"
+#include "AssetPack.h"
+#include "FrameTelemetry.h"
+#include "PieceAtlas.h"
+#include "BoardCompositor.h"
+#include "BoardView.h"
 
 // Renamed from GameState to UIState to avoid conflict with Board.h
 enum class UIState {
@@ -21,35 +26,29 @@ class Game
 private:
     SDL_Window *window;
     SDL_Renderer *renderer;
-    std::map<std::string, SDL_Texture *> pieceTextures;
+    // Images come from the asset pack, or from the BMP files without one
+    AssetPack m_assets;
+    PieceAtlas m_pieceAtlas;
+    BoardCompositor m_boardCompositor;
     Board board;
+    // Selection, legal targets and the move being animated; the targets are
+    // rebuilt with the game status each turn
+    BoardView m_boardView;
     bool running;
-    std::thread stockfishInitThread;
-    std::atomic<bool> stockfishInitInProgress;
-    std::atomic<bool> stockfishInitialized;
     Uint32 lastFrameTime;
-    std::string lastAnalyzedPosition;
-    std::tuple<int, int, int, int> lastAnalyzedMove;
     bool m_promotionInProgress;
     int m_promotionRow;
     bool m_gameOver;
     int m_promotionCol;
     Color m_promotionColor;
     bool m_moveJustFinished = false;
-    std::future<std::tuple<int, int, int, int>> aiFuture;
-    bool aiMovePending;
     bool m_endgameMessageDisplayed = false;
     bool m_showLosingKing = false;
     int m_losingKingRow = -1;
     int m_losingKingCol = -1;
     Uint32 m_gameOverStartTime = 0;
-    // Add these for async Stockfish
-    std::future<std::tuple<int, int, int, int>> stockfishFuture;
-    bool stockfishMovePending = false;
     SDL_Texture* thinkingIndicator = nullptr;
     SDL_FRect button;
-    StockfishConnector stockfish;
-    bool useStockfish = true;
     UIState m_gameState; // Changed from GameState to UIState
     SDL_FRect menuButtons[3]; // Array to hold menu buttons
     SDL_Texture* m_titleTexture = nullptr;
@@ -60,11 +59,96 @@ private:
     SDL_Texture* m_whiteWinsTexture = nullptr;
     SDL_Texture* m_blackWinsTexture = nullptr;
     SDL_Texture* m_drawTexture = nullptr;
+    // Result of the committed position, refreshed when its Zobrist key
+    // changes rather than every frame
+    PositionHistory m_positionHistory;
+    GameStatus m_status;
+    int m_historyPly = -1;      // ply of the latest position in m_positionHistory
+    void refreshGameStatus();
+    void resetGameStatus();
+    // The game as played, appended to games.pgn when it ends or the window closes
+    PgnGame m_record;
+    Board m_recordBoard;        // position after the recorded moves
+    Board m_recordPrevious;     // position before the last recorded move
+    bool m_recordSaved = true;
+    void recordPosition();
+    void saveRecord();
+    // Opening statistics shown beside the board and used as the built-in
+    // AI's book. Declared before the worker, which reads it, so it outlives it.
+    OpeningExplorer m_explorer;
+    std::string m_bookPath;
+    static const int EXPLORER_PANEL_WIDTH = 240;
+    static const int EXPLORER_ROWS = 8;
+    bool m_explorerShown = false;   // only when the window is wide enough
+    void renderExplorerPanel();
+    // Engine moves for Black come from the worker thread
+    SearchWorker m_searchWorker;
+    EngineConfig m_engine;
+    uint32_t m_searchId = 0;
+    bool m_searchPending = false;
+    SearchReport m_searchReport;
+
+    // Everything a frame depends on besides animation progress. A frame is
+    // only drawn when this changes, an event arrives, or a piece is moving.
+    struct FrameSignature {
+        UIState uiState = UIState::MainMenu;
+        int ply = -1;
+        int selectedSquare = -1;
+        bool gameOver = false;
+        bool searchPending = false;
+        int searchDepth = 0;
+        Uint32 overlayPhase = 0;    // step of the flashing king or thinking dots
+
+        bool operator==(const FrameSignature& other) const {
+            return uiState == other.uiState && ply == other.ply && selectedSquare == other.selectedSquare &&
+                   gameOver == other.gameOver && searchPending == other.searchPending &&
+                   searchDepth == other.searchDepth && overlayPhase == other.overlayPhase;
+        }
+    };
+    // Responsiveness histograms, only collected when enabled
+    FrameTelemetry m_telemetry;
+    bool m_telemetryEnabled = false;
+    bool m_telemetryOverlay = false;
+    std::string m_telemetryCsvPath;
+    FrameTelemetry::Clock::time_point m_searchStartTime;
+    FrameTelemetry::Clock::time_point m_clickTime;
+    bool m_clickPending = false;
+    void exportTelemetry() const;
+    // Chrome trace output, written on F9 and when run() returns
+    std::string m_tracePath;
+    void writeTrace() const;
+
+    static const int MIN_WINDOW_SIZE = 320;
+    static const int IDLE_WAIT_MS = 1000;
+    static const int SEARCH_POLL_MS = 50;
+    static const int FLASH_FRAME_MS = 33;
+    // The mated king flashes for a few cycles and then stays highlighted,
+    // so a finished game left on screen goes back to idle redraws
+    static const int FLASH_PERIOD_MS = 1800;
+    static const int FLASH_CYCLES = 5;
+    FrameSignature m_lastFrame;
+    bool m_needsRedraw = true;
+    bool m_vsyncEnabled = false;
+    void processEvent(const SDL_Event& event);
+    // Fits the board to the window, rescaling the pieces when the square size changes
+    void updateLayout();
+    FrameSignature currentFrameSignature() const;
+    // Time into the losing king's flashing, capped once it has stopped
+    Uint32 losingKingFlashMs() const;
+    // How long the loop may sleep waiting for events before the next update
+    int frameWaitTimeout() const;
 public:
     Game();
     ~Game();
 
     bool initialize();
+    // Records frame, update, render, engine wait and click latency; the summary
+    // is printed when run() returns and the histograms written to csvPath if set
+    void enableTelemetry(bool showOverlay, const std::string &csvPath);
+    // Records trace zones on every thread for the Chrome trace viewer
+    void enableTrace(const std::string &path);
+    // Opening table to load instead of openings.book in the user data directory
+    void setOpeningBookPath(const std::string &path) { m_bookPath = path; }
     void run();
     void handleEvents();
     void update(float deltaTime);
@@ -72,13 +156,13 @@ public:
     void cleanup();
     Board &getBoard() { return board; }
     SDL_Texture *loadTexture(const char *path) const;
-    SDL_Texture *getPieceTexture(PieceType type, Color color) const;
     void startPromotion(int row, int col, Color color);
     void handlePromotion(PieceType type);
     bool isPromotionInProgress() const { return m_promotionInProgress; }
     void displayEndGameMessage();
     void renderMainMenu();
     void handleMainMenuClick(int x, int y);
+    static EngineConfig stockfishEngine();
     void startGameWithStockfish();
     void startGameWithMinimaxAI();
 };
\ No newline at end of file
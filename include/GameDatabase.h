@@ -0,0 +1,122 @@
+#pragma once
+#include "MappedFile.h"
+#include "Pgn.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+enum class GameResult : uint8_t { Unknown, WhiteWins, BlackWins, Draw };
+
+// Fixed-size entry per stored game, kept in a table at the end of the file
+struct GameEntry {
+    uint64_t offset;        // of the tag pairs; the moves follow them
+    uint32_t date;          // YYYYMMDD from the Date tag, unknown parts zero
+    uint16_t plyCount;
+    uint16_t tagBytes;
+    uint16_t whiteElo;      // zero when unrated
+    uint16_t blackElo;
+    GameResult result;
+    uint8_t flags;          // GameEntry::Flag bits
+    uint16_t reserved;
+
+    enum Flag : uint8_t {
+        Truncated = 1,      // the PGN had an illegal move; the legal prefix is stored
+        CustomStart = 2     // a FEN tag sets up the first position
+    };
+};
+
+static_assert(sizeof(GameEntry) == 24, "game entries are written to disk as-is");
+
+// One occurrence of a position: the game and the ply it was reached at,
+// sorted by key in the index file
+struct PositionEntry {
+    uint64_t key;           // Board::getZobristKey
+    uint32_t game;
+    uint16_t ply;
+    uint16_t reserved;
+};
+
+static_assert(sizeof(PositionEntry) == 16, "position entries are written to disk as-is");
+
+// Games compactly on disk. Each move is stored as one byte, its index among
+// the side to move's generated moves in square order, and the tag pairs as
+// NUL-separated text. Games are appended in import order and numbered from
+// zero.
+class GameDatabaseWriter {
+public:
+    bool create(const std::string& path);
+    // Stores the game's legal moves; an error in the PGN marks it truncated
+    bool add(const PgnGame& game);
+    // Writes the entry table and the header. The file is unreadable until then.
+    bool finish();
+
+    uint32_t gameCount() const { return static_cast<uint32_t>(m_entries.size()); }
+
+private:
+    std::ofstream m_out;
+    std::string m_path;
+    uint64_t m_offset = 0;
+    std::vector<GameEntry> m_entries;
+    std::string m_buffer;
+};
+
+// Read access to a game database and its position index (the database path
+// plus ".idx"). Both files are memory-mapped; a query is a binary search of
+// the index and reads nothing else.
+class GameDatabase {
+public:
+    struct PositionRange {
+        const PositionEntry* first = nullptr;
+        const PositionEntry* last = nullptr;
+        size_t size() const { return static_cast<size_t>(last - first); }
+        const PositionEntry* begin() const { return first; }
+        const PositionEntry* end() const { return last; }
+    };
+
+    GameDatabase() = default;
+    GameDatabase(const GameDatabase&) = delete;
+    GameDatabase& operator=(const GameDatabase&) = delete;
+
+    // Maps the games and, if it is present and current, the index
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_entries != nullptr; }
+    const std::string& path() const { return m_path; }
+    static std::string indexPath(const std::string& path) { return path + ".idx"; }
+
+    uint32_t gameCount() const { return m_gameCount; }
+    const GameEntry& entry(uint32_t game) const { return m_entries[game]; }
+    // Tags and moves of a stored game
+    bool readGame(uint32_t game, PgnGame& pgn) const;
+    // The position a game starts from
+    bool startPosition(uint32_t game, Board& board) const;
+    // The game's moves, one byte each
+    const uint8_t* moveCodes(uint32_t game) const;
+    // The position before the move at ply
+    bool positionAt(uint32_t game, int ply, Board& board) const;
+    // The move a stored byte stands for in this position, or Move::none()
+    static Move decodeMove(const Board& board, uint8_t code);
+
+    // Sorts every (position, game, ply) of the database into the index file.
+    // Worker threads replay disjoint batches of games into sorted runs of at
+    // most memoryBytes in total, which are then merged into the index.
+    bool buildIndex(int threads, size_t memoryBytes);
+    bool hasIndex() const { return m_positions != nullptr; }
+    uint64_t positionCount() const { return m_positionCount; }
+    // The whole index, sorted by key, game and ply
+    const PositionEntry* positions() const { return m_positions; }
+    // Every game and ply at which the position occurred, by game
+    PositionRange find(uint64_t key) const;
+
+private:
+    bool openIndex();
+
+    std::string m_path;
+    MappedFile m_games;
+    MappedFile m_index;
+    const GameEntry* m_entries = nullptr;
+    uint32_t m_gameCount = 0;
+    const PositionEntry* m_positions = nullptr;
+    uint64_t m_positionCount = 0;
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Board.h"
+
+enum class DrawReason {
+    None,
+    FiftyMoveRule,
+    ThreefoldRepetition,
+    InsufficientMaterial
+};
+
+// Zobrist keys of every position reached in a game, oldest first
+class PositionHistory {
+public:
+    void clear() { m_keys.clear(); }
+    void push(uint64_t key) { m_keys.push_back(key); }
+    // For a position that changed without a move being played
+    void replaceLatest(uint64_t key) { m_keys.back() = key; }
+    int size() const { return static_cast<int>(m_keys.size()); }
+    uint64_t latest() const { return m_keys.back(); }
+
+    // How often the latest position occurred since the last capture or pawn move
+    int repetitionCount(int halfmoveClock) const;
+
+private:
+    std::vector<uint64_t> m_keys;
+};
+
+// True when neither side has enough material left to deliver mate
+bool hasInsufficientMaterial(const Board& board);
+
+// Draw rules that apply regardless of whose move it is. The history must end
+// with the current position.
+DrawReason checkDrawRules(const Board& board, const PositionHistory& history);
+
+// Outcome of one committed position. The GUI computes it once per move and
+// reads the stored value every frame.
+struct GameStatus {
+    uint64_t key = 0;                        // Zobrist key of the position it describes
+    GameState state = GameState::Active;     // check, mate or stalemate of the side to move
+    DrawReason drawReason = DrawReason::None;
+
+    bool isCheckmate() const { return state == GameState::Checkmate; }
+    bool isDraw() const { return state == GameState::Stalemate || drawReason != DrawReason::None; }
+    bool isOver() const { return isCheckmate() || isDraw(); }
+};
+
+// Classifies the current position. The history must end with it.
+GameStatus evaluateGameStatus(const Board& board, const PositionHistory& history);
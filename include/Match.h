@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// One side of a match: the built-in AI at a fixed depth, or a Stockfish process
+struct EngineConfig {
+    enum class Kind { BuiltIn, Stockfish };
+
+    Kind kind = Kind::BuiltIn;
+    std::string name;
+    int depth = 2;                      // search depth; Stockfish ignores it when moveTimeMs is set
+    int moveTimeMs = 0;                 // Stockfish only: "go movetime" when above zero
+    std::string path = "./stockfish";   // Stockfish only
+
+    // UCI "go" command for this configuration
+    std::string goCommand() const;
+};
+
+// Sequential probability ratio test of H0: elo == elo0 against H1: elo == elo1
+struct SprtParameters {
+    double elo0 = 0.0;
+    double elo1 = 10.0;
+    double alpha = 0.05;
+    double beta = 0.05;
+};
+
+struct MatchOptions {
+    EngineConfig first;
+    EngineConfig second;
+    std::vector<std::string> openings;  // FENs, each played twice with colors reversed
+    // Without openings each game pair starts after this many random plies
+    // from the start position; SPRT requires openings instead
+    int randomOpeningPlies = 8;
+    uint32_t seed = 1;                  // for the random openings
+    int maxGames = 1000;
+    int concurrency = 0;                // games in parallel, 0 means one per hardware thread
+    bool useSprt = true;
+    SprtParameters sprt;
+    int maxPlies = 400;                 // adjudicate a draw once a game gets this long
+    int materialThreshold = 0;          // centipawn lead that adjudicates a win, 0 disables
+    int materialPlies = 10;             // plies the lead has to persist
+    // Stockfish results shared through this file, empty for none. Off by
+    // default: replayed moves make every game from an opening alike.
+    std::string analysisCachePath;
+};
+
+// Per-engine move timing and search effort across a match. Moves taken
+// from the analysis cache are only counted in cachedMoves.
+struct EngineTiming {
+    uint64_t moves = 0;
+    uint64_t cachedMoves = 0;
+    uint64_t nodes = 0;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+
+    double averageMs() const { return moves ? totalMs / moves : 0.0; }
+    double nodesPerSecond() const { return totalMs > 0.0 ? nodes * 1000.0 / totalMs : 0.0; }
+};
+
+struct MatchResult {
+    enum class SprtDecision { None, AcceptH0, AcceptH1 };
+
+    // Counted from the first engine's point of view
+    int wins = 0;
+    int losses = 0;
+    int draws = 0;
+    double llr = 0.0;
+    SprtDecision decision = SprtDecision::None;
+    EngineTiming timing[2];
+
+    int games() const { return wins + losses + draws; }
+    double score() const;
+    double elo() const;
+    // Half-width of the 95% confidence interval around elo()
+    double eloError() const;
+    // Whether the games vary enough for eloError() to mean anything
+    bool hasEloError() const;
+    // eloError() to one decimal, or "n/a"
+    std::string eloErrorText() const;
+};
+
+class MatchRunner {
+public:
+    explicit MatchRunner(const MatchOptions& options);
+
+    // Plays the match on worker threads, printing a line per finished game
+    MatchResult run(std::ostream& progress);
+
+private:
+    MatchOptions m_options;
+};
+
+// Reads an EPD or FEN-per-line file; EPD operations after the position are ignored
+std::vector<std::string> loadOpenings(const std::string& path);
+
+// Log-likelihood ratio of the trinomial SPRT (normal approximation)
+double sprtLogLikelihoodRatio(int wins, int draws, int losses, double elo0, double elo1);
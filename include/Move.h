@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "PieceTypes.h"
+
+// Move flags stored in the top four bits of a Move. Bit 2 marks captures and
+// bit 3 marks promotions; the low two bits of a promotion select the piece.
+enum MoveFlag : uint16_t {
+    Quiet = 0,
+    DoublePawnPush = 1,
+    KingCastle = 2,
+    QueenCastle = 3,
+    Capture = 4,
+    EnPassant = 5,
+    KnightPromotion = 8,
+    BishopPromotion = 9,
+    RookPromotion = 10,
+    QueenPromotion = 11,
+    KnightPromotionCapture = 12,
+    BishopPromotionCapture = 13,
+    RookPromotionCapture = 14,
+    QueenPromotionCapture = 15
+};
+
+// A move packed into 16 bits: from square (6), to square (6), flags (4).
+// Squares are indexed row * 8 + col, matching the Zobrist tables.
+class Move {
+public:
+    Move() = default;
+    constexpr Move(int from, int to, int flags)
+        : m_data(static_cast<uint16_t>(from | (to << 6) | (flags << 12))) {}
+    constexpr Move(int fromRow, int fromCol, int toRow, int toCol, int flags)
+        : Move(fromRow * 8 + fromCol, toRow * 8 + toCol, flags) {}
+
+    static constexpr Move none() { return Move(0, 0, 0); }
+
+    constexpr int from() const { return m_data & 0x3f; }
+    constexpr int to() const { return (m_data >> 6) & 0x3f; }
+    constexpr int flags() const { return m_data >> 12; }
+    constexpr int fromRow() const { return from() >> 3; }
+    constexpr int fromCol() const { return from() & 7; }
+    constexpr int toRow() const { return to() >> 3; }
+    constexpr int toCol() const { return to() & 7; }
+
+    constexpr bool isNone() const { return m_data == 0; }
+    constexpr bool isCapture() const { return (flags() & MoveFlag::Capture) != 0; }
+    constexpr bool isPromotion() const { return (flags() & KnightPromotion) != 0; }
+    constexpr bool isEnPassant() const { return flags() == MoveFlag::EnPassant; }
+    constexpr bool isDoublePawnPush() const { return flags() == MoveFlag::DoublePawnPush; }
+    constexpr bool isCastle() const { return flags() == KingCastle || flags() == QueenCastle; }
+
+    constexpr PieceType promotionType() const {
+        return (flags() & 3) == 0 ? PieceType::Knight
+             : (flags() & 3) == 1 ? PieceType::Bishop
+             : (flags() & 3) == 2 ? PieceType::Rook
+             : PieceType::Queen;
+    }
+
+    // Long algebraic notation as used by UCI, e.g. "e2e4" or "e7e8q"
+    std::string toUci() const {
+        std::string uci = {char('a' + fromCol()), char('1' + fromRow()), char('a' + toCol()), char('1' + toRow())};
+        if (isPromotion())
+            uci += "nbrq"[flags() & 3];
+        return uci;
+    }
+
+    constexpr uint16_t raw() const { return m_data; }
+    static constexpr Move fromRaw(uint16_t raw) { return Move(raw & 0x3f, (raw >> 6) & 0x3f, raw >> 12); }
+
+    constexpr bool operator==(const Move& other) const { return m_data == other.m_data; }
+    constexpr bool operator!=(const Move& other) const { return m_data != other.m_data; }
+
+private:
+    uint16_t m_data;
+};
+
+static_assert(sizeof(Move) == 2, "Move must stay packed into 16 bits");
+
+// Fixed-capacity move buffer meant to live on the stack. 256 entries is above
+// the maximum number of moves in any legal chess position.
+class MoveList {
+public:
+    static const int CAPACITY = 256;
+
+    MoveList() : m_size(0) {}
+
+    void push_back(Move move) { m_moves[m_size++] = move; }
+    void clear() { m_size = 0; }
+    int size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    void resize(int size) { m_size = size; }
+
+    Move& operator[](int index) { return m_moves[index]; }
+    const Move& operator[](int index) const { return m_moves[index]; }
+
+    Move* begin() { return m_moves; }
+    Move* end() { return m_moves + m_size; }
+    const Move* begin() const { return m_moves; }
+    const Move* end() const { return m_moves + m_size; }
+
+    bool contains(Move move) const {
+        for (int i = 0; i < m_size; ++i) {
+            if (m_moves[i] == move) return true;
+        }
+        return false;
+    }
+
+private:
+    Move m_moves[CAPACITY];
+    int m_size;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include "Board.h"
+#include "MappedFile.h"
+#include "Move.h"
+#include <cstdint>
+#include <random>
+#include <string>
+
+class GameDatabase;
+
+// How one move fared from one position across a game database
+struct ExplorerMove {
+    uint16_t move;          // Move::raw()
+    uint16_t averageElo;    // of the player making the move, over rated games; zero if none
+    uint32_t games;
+    uint32_t whiteWins;
+    uint32_t draws;
+    uint32_t blackWins;     // games without a result count in games only
+    uint32_t lastDate;      // YYYYMMDD of the most recent game
+    uint32_t lastGame;      // that game's id in the database
+    uint32_t reserved;
+};
+
+static_assert(sizeof(ExplorerMove) == 32, "explorer moves are written to disk as-is");
+
+struct ExplorerPosition {
+    uint64_t key;           // Board::getZobristKey
+    uint32_t firstMove;     // index into the move table
+    uint16_t moveCount;
+    uint16_t reserved;
+};
+
+static_assert(sizeof(ExplorerPosition) == 16, "explorer positions are written to disk as-is");
+
+// Per-position move statistics aggregated from a game database when the
+// table is built. The table is memory-mapped: positions sorted by key, each
+// pointing at its moves, most played first. A lookup is one binary search.
+// Read-only once open, so it may be shared between threads.
+class OpeningExplorer {
+public:
+    struct MoveRange {
+        const ExplorerMove* first = nullptr;
+        const ExplorerMove* last = nullptr;
+        bool empty() const { return first == last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        uint32_t games() const;
+        const ExplorerMove* begin() const { return first; }
+        const ExplorerMove* end() const { return last; }
+    };
+
+    OpeningExplorer() = default;
+    OpeningExplorer(const OpeningExplorer&) = delete;
+    OpeningExplorer& operator=(const OpeningExplorer&) = delete;
+
+    // Aggregates every position up to maxPly that at least minGames games
+    // reached. The database needs its position index.
+    static bool build(const GameDatabase& database, const std::string& path, int maxPly = 40, uint32_t minGames = 2);
+    static std::string defaultPath(const std::string& databasePath) { return databasePath + ".book"; }
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_positions != nullptr; }
+    uint32_t positionCount() const { return m_positionCount; }
+
+    MoveRange find(uint64_t key) const;
+
+    // A book move for the side to move, drawn in proportion to how often each
+    // was played; moves played in under a tenth of the top move's games are
+    // left out. Move::none() when the position is out of book.
+    Move bookMove(const Board& board, std::mt19937& rng) const;
+
+private:
+    MappedFile m_file;
+    const ExplorerPosition* m_positions = nullptr;
+    const ExplorerMove* m_moves = nullptr;
+    uint32_t m_positionCount = 0;
+    uint32_t m_moveCount = 0;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include "Board.h"
+#include "Move.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Leaf counts of subtrees keyed by position and depth, shared by every perft
+// thread without locks. Each slot stores the key XORed with its data, so a
+// slot torn by two concurrent writers fails the key check instead of
+// returning a wrong count.
+class PerftHash {
+public:
+    // Rounded down to a power of two entries; zero bytes disables the table
+    explicit PerftHash(size_t bytes);
+
+    bool probe(uint64_t key, int depth, uint64_t& count) const;
+    void store(uint64_t key, int depth, uint64_t count);
+    bool enabled() const { return m_entries != nullptr; }
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check;    // key ^ data
+        std::atomic<uint64_t> data;     // count << 8 | depth
+    };
+
+    std::unique_ptr<Entry[]> m_entries;
+    size_t m_mask = 0;
+};
+
+struct PerftOptions {
+    int depth = 5;
+    int threads = 0;                // 0 means one per hardware thread
+    size_t hashBytes = 64 << 20;    // 0 disables the subtree table
+};
+
+struct PerftResult {
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+    uint64_t hashHits = 0;          // subtrees taken from the table
+    int threads = 1;
+    // Leaf count below each legal root move, in generation order
+    std::vector<std::pair<Move, uint64_t>> divide;
+
+    double nodesPerSecond() const { return seconds > 0.0 ? nodes / seconds : 0.0; }
+};
+
+// Leaf nodes of the legal move tree to depth. The last ply is counted from
+// the size of the move list instead of being played, and subtrees are looked
+// up in hash when it is given.
+uint64_t perft(const Board& board, int depth, PerftHash* hash = nullptr);
+
+// perft with the tree split across a work-stealing thread pool: root moves
+// and, for deep searches, their replies become tasks. Each thread works
+// from the back of its own queue and an idle one takes the oldest task,
+// usually the largest subtree, from the front of another's.
+PerftResult runPerft(const Board& board, const PerftOptions& options);
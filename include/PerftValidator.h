@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+struct ValidatorOptions {
+    std::string enginePath = "./stockfish";
+    int depth = 4;
+    int processes = 0;                  // engine processes in parallel, 0 means one per hardware thread
+    std::vector<std::string> positions; // FENs checked as given; empty uses the built-in suite
+    int randomPositions = 200;          // reached by random play from the start and suite positions
+    int maxRandomPlies = 60;
+    uint32_t seed = 1;
+};
+
+// The first point where our move generation and the engine's part ways:
+// the line from a checked position down to a position whose legal move
+// lists differ
+struct ValidatorFailure {
+    std::string rootFen;
+    std::vector<std::string> line;      // UCI moves from rootFen to fen
+    std::string fen;
+    std::vector<std::string> missing;   // moves the engine generates and we do not
+    std::vector<std::string> extra;     // moves we generate and the engine does not
+    std::string error;                  // set instead when the engine failed
+};
+
+struct ValidatorReport {
+    int positions = 0;
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+    std::vector<ValidatorFailure> failures;
+};
+
+// Compares perft divide counts against Stockfish's "go perft". Positions are
+// shared out to worker threads that each drive their own engine process.
+// When a count differs, the check descends into the first differing move
+// with one ply less until the move lists themselves differ.
+class PerftValidator {
+public:
+    explicit PerftValidator(const ValidatorOptions& options);
+
+    // Checks every position, printing a line per failure and a progress line
+    // every hundred positions
+    ValidatorReport run(std::ostream& progress);
+
+private:
+    std::vector<std::string> collectPositions() const;
+
+    ValidatorOptions m_options;
+};
+
+// Standard perft test positions with known counts
+const std::vector<std::string>& perftSuitePositions();
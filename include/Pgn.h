@@ -0,0 +1,78 @@
+#pragma once
+#include "Board.h"
+#include "Move.h"
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// One game of a PGN file: its tag pairs in file order and the main line,
+// already replayed into Moves. Comments, NAGs and variations are dropped.
+struct PgnGame {
+    std::vector<std::pair<std::string, std::string>> tags;
+    std::vector<Move> moves;
+    std::string result = "*";
+    // Empty unless the movetext could not be replayed; moves then holds the
+    // legal prefix
+    std::string error;
+
+    void clear();
+    // The tag's value, or nullptr when the game has no such tag
+    const std::string* tag(const std::string& name) const;
+    void setTag(const std::string& name, const std::string& value);
+    // Sets up the board the moves start from: the FEN tag, or the initial
+    // position. False if the FEN tag cannot be parsed.
+    bool startPosition(Board& board) const;
+};
+
+// Reads games one at a time from a stream of any size. Input goes through a
+// fixed buffer and each game is replayed as its SAN moves are tokenised, so
+// memory use does not grow with the file.
+class PgnReader {
+public:
+    explicit PgnReader(std::istream& in);
+
+    // Fills game with the next game; false once the input is exhausted
+    bool next(PgnGame& game);
+
+    uint64_t gamesRead() const { return m_gamesRead; }
+    uint64_t bytesRead() const { return m_bytesRead; }
+
+private:
+    static const size_t BUFFER_SIZE = 1 << 20;
+
+    bool refill();
+    int peek() { return (m_pos < m_end || refill()) ? static_cast<unsigned char>(m_buffer[m_pos]) : -1; }
+    int get() { int c = peek(); if (c >= 0) advance(c); return c; }
+    void advance(int c) { m_pos++; m_lineStart = (c == '\n'); }
+    void skipLine();
+    void skipComment();
+    void skipVariation();
+    bool readTag(PgnGame& game);
+    // Reads a movetext token into m_token; false at the end of input
+    bool readToken();
+
+    std::istream& m_in;
+    std::vector<char> m_buffer;
+    size_t m_pos = 0;
+    size_t m_end = 0;
+    bool m_lineStart = true;
+    std::string m_token;
+    std::string m_tagName;
+    Board m_board;
+    uint64_t m_gamesRead = 0;
+    uint64_t m_bytesRead = 0;
+};
+
+// The legal move a SAN token such as "Nbd7", "exd6", "e8=Q+" or "O-O-O"
+// describes, or Move::none(). Check and annotation suffixes are ignored.
+// The board is only used for trial moves and is left unchanged.
+Move parseSan(Board& board, const std::string& san);
+// The SAN of a legal move, with disambiguation and a check or mate suffix
+std::string moveToSan(const Board& board, Move move);
+
+// Writes the Seven Tag Roster first, then the remaining tags and the movetext
+// wrapped at 80 columns
+void writePgn(std::ostream& out, const PgnGame& game);
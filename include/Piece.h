@@ -1,87 +1,50 @@
 #pragma once
 
-#include "SDLIncludes.h"
-#include <string>
-#include <vector>
-
-class Board;
-class Game;
-
-enum class PieceType {
-    King, Queen, Rook, Bishop, Knight, Pawn
-};
-
-enum class Color {
-    White, Black
-};
+#include "PieceTypes.h"
+#include <cstdint>
 
+// A piece packed into four bits: bits 0-2 hold the PieceType plus one and
+// bit 3 the colour, so zero is an empty square. The board stores these by
+// value in a 64-byte mailbox.
 class Piece {
-    friend class Board; 
-protected:
-    PieceType m_type;
-    Color m_color;
-    int m_row;
-    int m_col;
-    bool m_hasMoved;
-
-    bool isValidPosition(int row, int col) const;
-    bool isPathClear(int toRow, int toCol, const Board& board) const;
-    bool canCapture(int row, int col, const Board& board) const;
-
 public:
-    Piece(PieceType type, Color color, int row, int col);
-    virtual ~Piece() = default;
-    
-    virtual bool canMoveTo(int toRow, int toCol, const Board& board) const = 0;
-    
-    PieceType getType() const;
-    Color getColor() const;
-    int getRow() const;
-    int getCol() const;
-    bool hasMoved() const;
-    void setPosition(int row, int col);
-    virtual void render(SDL_Renderer* renderer, const Game& game, int squareSize) const;
-    // For rendering
-    void setPositionWithoutMovedFlag(int row, int col) {
-        m_row = row;
-        m_col = col;
-        
-    }
-  
-};
+    constexpr Piece() : m_code(0) {}
+    constexpr Piece(PieceType type, Color color)
+        : m_code(static_cast<uint8_t>((static_cast<int>(type) + 1) | (color == Color::Black ? 8 : 0))) {}
 
-class King : public Piece {
-public:
-    King(Color color, int row, int col);
-    bool canMoveTo(int toRow, int toCol, const Board& board) const override;
-};
+    static constexpr Piece fromCode(uint8_t code) { Piece piece; piece.m_code = code & 15; return piece; }
+    constexpr uint8_t code() const { return m_code; }
 
-class Queen : public Piece {
-public:
-    Queen(Color color, int row, int col);
-    bool canMoveTo(int toRow, int toCol, const Board& board) const override;
-};
+    constexpr bool isEmpty() const { return m_code == 0; }
+    constexpr explicit operator bool() const { return m_code != 0; }
+    constexpr PieceType getType() const { return static_cast<PieceType>((m_code & 7) - 1); }
+    constexpr Color getColor() const { return (m_code & 8) ? Color::Black : Color::White; }
 
-class Rook : public Piece {
-public:
-    Rook(Color color, int row, int col);
-    bool canMoveTo(int toRow, int toCol, const Board& board) const override;
-};
+    constexpr bool operator==(Piece other) const { return m_code == other.m_code; }
+    constexpr bool operator!=(Piece other) const { return m_code != other.m_code; }
 
-class Bishop : public Piece {
-public:
-    Bishop(Color color, int row, int col);
-    bool canMoveTo(int toRow, int toCol, const Board& board) const override;
+private:
+    uint8_t m_code;
 };
 
-class Knight : public Piece {
-public:
-    Knight(Color color, int row, int col);
-    bool canMoveTo(int toRow, int toCol, const Board& board) const override;
+// How each piece type moves, indexed by PieceType: its (row, col) steps and
+// whether it keeps sliding along them. Pawns and castling depend on colour
+// and occupancy and are generated separately.
+struct PieceMovement {
+    bool slides;
+    int count;
+    int8_t steps[8][2];
 };
 
-class Pawn : public Piece {
-public:
-    Pawn(Color color, int row, int col);
-    bool canMoveTo(int toRow, int toCol, const Board& board) const override;
+constexpr PieceMovement PIECE_MOVEMENT[6] = {
+    {false, 8, {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}}},    // King
+    {true,  8, {{1, 1}, {1, -1}, {-1, -1}, {-1, 1}, {1, 0}, {0, 1}, {-1, 0}, {0, -1}}},    // Queen
+    {true,  4, {{1, 0}, {0, 1}, {-1, 0}, {0, -1}}},                                        // Rook
+    {true,  4, {{1, 1}, {1, -1}, {-1, -1}, {-1, 1}}},                                      // Bishop
+    {false, 8, {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}}},  // Knight
+    {false, 0, {}},                                                                        // Pawn
 };
+
+static_assert(sizeof(Piece) == 1, "pieces are stored one byte per square");
+static_assert(Piece(PieceType::Pawn, Color::Black).getType() == PieceType::Pawn, "type survives packing");
+static_assert(Piece(PieceType::King, Color::Black).getColor() == Color::Black, "colour survives packing");
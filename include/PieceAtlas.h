@@ -0,0 +1,60 @@
+#pragma once
+#include "SDLIncludes.h"
+#include "PieceTypes.h"
+#include <cstdint>
+#include <vector>
+
+class AssetPack;
+
+// All twelve piece images packed into one texture: six columns (King to
+// Pawn, in PieceType order), White on the top row and Black below, plus a
+// solid white strip underneath for untextured quads.
+//
+// The images are kept once at their native size and scaled on the GPU into
+// an atlas per square size, so pieces are drawn 1:1 every frame. The last
+// few sizes stay cached for windows that are resized back and forth.
+class PieceAtlas {
+public:
+    static const int SOURCE_CELL_SIZE = 150;
+    static const int SOLID_HEIGHT = 4;
+    static const int MAX_CACHED_SIZES = 4;
+
+    PieceAtlas() = default;
+    ~PieceAtlas();
+    PieceAtlas(const PieceAtlas&) = delete;
+    PieceAtlas& operator=(const PieceAtlas&) = delete;
+
+    // Renders the piece images into the source atlas, taking them from
+    // assets when it has them, and drops every scaled atlas. Called again
+    // when the renderer loses its render targets.
+    bool build(SDL_Renderer* renderer, const AssetPack& assets);
+    // Makes the atlas for cellSize pixel squares current, scaling it from
+    // the source the first time that size is used
+    bool setCellSize(SDL_Renderer* renderer, int cellSize);
+    void destroy();
+
+    // The current scaled atlas
+    SDL_Texture* texture() const { return m_current >= 0 ? m_scaled[m_current].texture : nullptr; }
+    int cellSize() const { return m_current >= 0 ? m_scaled[m_current].cellSize : 0; }
+    float width() const { return (float)(cellSize() * 6); }
+    float height() const { return (float)(cellSize() * 2 + SOLID_HEIGHT); }
+    SDL_FRect rect(PieceType type, Color color) const {
+        float cell = (float)cellSize();
+        return {static_cast<int>(type) * cell, static_cast<int>(color) * cell, cell, cell};
+    }
+    // A pixel inside the solid white strip
+    float solidX() const { return cellSize() / 2.0f; }
+    float solidY() const { return cellSize() * 2 + SOLID_HEIGHT / 2.0f; }
+
+private:
+    struct ScaledAtlas {
+        int cellSize;
+        SDL_Texture* texture;
+        uint64_t lastUsed;
+    };
+
+    SDL_Texture* m_source = nullptr;
+    std::vector<ScaledAtlas> m_scaled;
+    int m_current = -1;
+    uint64_t m_useCount = 0;
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+enum class PieceType {
+    King, Queen, Rook, Bishop, Knight, Pawn
+};
+
+enum class Color {
+    White, Black
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include "SDLIncludes.h"
+#include <vector>
+
+// Quads collected over a frame and submitted with a single SDL_RenderGeometry
+// call. Every quad samples the same texture; plain colored quads sample a
+// solid white texel of it and take their color from the vertices.
+class RenderBatch {
+public:
+    // The texture's size in pixels and a pixel inside its solid white area
+    void setTexture(SDL_Texture* texture, float width, float height, float solidX, float solidY);
+    void clear();
+
+    // src is in texture pixels
+    void addTexturedRect(const SDL_FRect& dst, const SDL_FRect& src, SDL_Color color = {255, 255, 255, 255});
+    void addFilledRect(const SDL_FRect& dst, SDL_Color color);
+
+    // Draws everything added since clear() in insertion order
+    void draw(SDL_Renderer* renderer) const;
+    int quadCount() const { return static_cast<int>(m_vertices.size() / 4); }
+
+private:
+    void addQuad(const SDL_FRect& dst, float u0, float v0, float u1, float v1, SDL_Color color);
+
+    SDL_Texture* m_texture = nullptr;
+    float m_width = 1.0f;
+    float m_height = 1.0f;
+    float m_solidU = 0.0f;
+    float m_solidV = 0.0f;
+    // Capacity survives clear(), so steady-state frames do not allocate
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int> m_indices;
+};
@@ -7,6 +7,11 @@
     // Event type mapping
     #define SDL_EVENT_QUIT SDL_QUIT
     #define SDL_EVENT_MOUSE_BUTTON_DOWN SDL_MOUSEBUTTONDOWN
+    #define SDL_EVENT_MOUSE_MOTION SDL_MOUSEMOTION
+    #define SDL_EVENT_KEY_DOWN SDL_KEYDOWN
+    #define SDL_EVENT_RENDER_TARGETS_RESET SDL_RENDER_TARGETS_RESET
+    #define SDL_EVENT_RENDER_DEVICE_RESET SDL_RENDER_DEVICE_RESET
+    #define SDL_SCALEMODE_LINEAR SDL_ScaleModeLinear
     #define SDL_EVENT_WINDOW_RESIZABLE SDL_WINDOW_RESIZABLE
     
     // Function compatibility wrappers
@@ -50,6 +55,10 @@
         return SDL_RenderCopy(renderer, texture, srcrect, &rect);
     }
     
+    inline bool SDL_SetRenderVSync(SDL_Renderer* renderer, int vsync) {
+        return SDL_RenderSetVSync(renderer, vsync) == 0;
+    }
+    
     // Mouse state handling
     inline Uint32 SDL_GetMouseState(float* x, float* y) {
         int ix, iy;
@@ -64,6 +73,10 @@
         return SDL_MapRGB(surface->format, r, g, b);
     }
     
+    inline SDL_Surface* SDL_ConvertSurface(SDL_Surface* surface, Uint32 format) {
+        return SDL_ConvertSurfaceFormat(surface, format, 0);
+    }
+    
     #define SDL_SetSurfaceColorKey SDL_SetColorKey
     #define SDL_DestroySurface SDL_FreeSurface
     #define SDL_RenderRect SDL_RenderDrawRectF
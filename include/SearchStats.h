@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Hot-path search counters only exist when CHESS_SEARCH_STATS is defined
+// (Debug builds, or -DCHESS_SEARCH_STATS=ON). Otherwise SEARCH_STAT compiles
+// to nothing and those counters stay zero. Node counts and per-depth timing
+// are always recorded since they cost one update per node or per iteration.
+#ifdef CHESS_SEARCH_STATS
+#define SEARCH_STAT(statement) do { statement; } while (0)
+#else
+#define SEARCH_STAT(statement) do { } while (0)
+#endif
+
+// One completed iterative deepening iteration
+struct DepthStats {
+    int depth = 0;
+    int score = 0;
+    uint64_t nodes = 0;      // nodes searched by this iteration alone
+    double elapsedMs = 0.0;  // wall time of this iteration
+    std::string bestMove;    // UCI notation
+};
+
+struct SearchStats {
+    static constexpr bool enabled =
+#ifdef CHESS_SEARCH_STATS
+        true;
+#else
+        false;
+#endif
+
+    uint64_t nodes = 0;
+    uint64_t qnodes = 0;            // quiescence nodes; the search has no quiescence stage yet
+    uint64_t evalCalls = 0;
+    uint64_t betaCutoffs = 0;
+    uint64_t firstMoveCutoffs = 0;  // cutoffs produced by the first move searched
+    uint64_t ttProbes = 0;          // transposition table; the search has none yet
+    uint64_t ttHits = 0;
+    uint64_t ttCutoffs = 0;
+    double elapsedMs = 0.0;
+    std::vector<DepthStats> depths;
+
+    void reset() { *this = SearchStats(); }
+
+    double nodesPerSecond() const { return elapsedMs > 0.0 ? nodes * 1000.0 / elapsedMs : 0.0; }
+    double ttHitRate() const { return ttProbes ? double(ttHits) / ttProbes : 0.0; }
+    double ttCutoffRate() const { return ttProbes ? double(ttCutoffs) / ttProbes : 0.0; }
+    double firstMoveCutoffRate() const { return betaCutoffs ? double(firstMoveCutoffs) / betaCutoffs : 0.0; }
+    // Effective branching factor: node growth between the last two iterations
+    double branchingFactor() const;
+
+    std::string toJson() const;
+    // One UCI "info" line per completed depth
+    std::vector<std::string> toUciInfo() const;
+};
@@ -0,0 +1,123 @@
+#pragma once
+#include "AnalysisCache.h"
+#include "Board.h"
+#include "Match.h"
+#include "Move.h"
+#include "OpeningExplorer.h"
+#include "StockFish.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+
+// Latest state of a search, as published by the worker thread
+struct SearchReport {
+    uint32_t searchId = 0;
+    int depth = 0;            // last completed iteration
+    int score = 0;            // centipawns, from the searching side's point of view
+    uint64_t nodes = 0;
+    double elapsedMs = 0.0;
+    Move bestMove = Move::none();
+    bool finished = false;    // bestMove is final; none() means the side to move has no move
+};
+
+// Single-producer single-consumer mailbox that only keeps the newest value.
+// A triple buffer: the producer writes its back slot and swaps it into the
+// middle, the consumer swaps the middle into its front slot. Neither side
+// blocks or waits for the other.
+template <typename T>
+class LatestValueMailbox {
+public:
+    // Producer thread only
+    void publish(const T& value) {
+        m_slots[m_back] = value;
+        m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Consumer thread only. Returns false if nothing new was published since the last call.
+    bool consume(T& value) {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH))
+            return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+        value = m_slots[m_front];
+        return true;
+    }
+
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH = 4;
+
+    T m_slots[3];
+    int m_back = 0;
+    std::atomic<int> m_middle{1};
+    int m_front = 2;
+};
+
+// Long-lived thread that runs engine searches off the UI thread. Commands
+// are queued and return at once; progress and results arrive through poll().
+class SearchWorker {
+public:
+    SearchWorker();
+    ~SearchWorker();
+
+    SearchWorker(const SearchWorker&) = delete;
+    SearchWorker& operator=(const SearchWorker&) = delete;
+
+    // Cancels any running search and searches board for the side to move.
+    // Returns the id its reports will carry. A search superseded by another
+    // command before the worker picks it up publishes nothing.
+    uint32_t start(const Board& board, const EngineConfig& engine);
+    // Cancels the running search, built-in or Stockfish; it still publishes a
+    // finished report with the best move found so far
+    void stop();
+    // Cancels any search and prepares engine for a new game. A running
+    // Stockfish is reset with ucinewgame; it is only started if needed.
+    void newGame(const EngineConfig& engine);
+    // Starts Stockfish on the worker thread ahead of any game
+    void warmUp(const EngineConfig& engine);
+
+    // Stockfish results are looked up in and added to the cache file at path
+    bool openAnalysisCache(const std::string& path) { return m_analysisCache.open(path); }
+    // The built-in AI plays from book while it knows the position. Set before
+    // the first search; the table must stay open while the worker runs.
+    void setOpeningBook(const OpeningExplorer* book) { m_openingBook = book; }
+
+    // Never blocks. True if a report newer than the last one read was available.
+    bool poll(SearchReport& report) { return m_mailbox.consume(report); }
+
+private:
+    enum class CommandType { Start, Stop, NewGame, WarmUp, Quit };
+
+    struct Command {
+        CommandType type;
+        uint32_t searchId = 0;
+        Board board;
+        EngineConfig engine;
+    };
+
+    void push(Command command);
+    void run();
+    void search(const Command& command);
+    Move searchBuiltIn(const Command& command, const EngineConfig& engine, SearchReport& report);
+    bool prepareStockfish(const EngineConfig& engine);
+    Move searchStockfish(const Command& command, SearchReport& report);
+
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueReady;
+    std::deque<Command> m_queue;
+    std::atomic<bool> m_stop{false};
+    uint32_t m_nextSearchId = 0;
+    LatestValueMailbox<SearchReport> m_mailbox;
+    AnalysisCache m_analysisCache;
+    const OpeningExplorer* m_openingBook = nullptr;
+
+    // Owned by the worker thread, except that push() may stop its search
+    StockfishConnector m_stockfish;
+    std::string m_stockfishPath;
+    bool m_stockfishReady = false;
+    std::mt19937 m_bookRng{std::random_device{}()};
+
+    std::thread m_thread;
+};
@@ -2,6 +2,9 @@
 #include <string>
 #include <memory>
 #include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
 #include <tuple>
 #include "Board.h"
 
@@ -12,10 +15,26 @@
 // Add this declaration so it's visible to other files
 std::string boardToFEN(const Board& board);
 
+// Outcome of one engine search
+struct EngineSearchResult {
+    std::string bestMove;   // UCI notation, empty if the engine gave no move
+    uint64_t nodes = 0;
+    int depth = 0;          // deepest completed iteration
+    int score = 0;          // centipawns for the side to move; mates are +/-(30000 - plies)
+};
+
 class StockfishConnector {
 private:
     FILE* stockfishProcess;
     bool initialized;
+    // Path the running engine was started from, reused for restarts
+    std::string enginePath;
+    // As reported by "id name" during the handshake
+    std::string engineName;
+    // Guards "go" and "stop" so another thread can interrupt a search; only
+    // while searching is set may it write to the engine
+    std::mutex searchMutex;
+    bool searching = false;
     
     
 #ifdef _WIN32
@@ -43,17 +62,28 @@ public:
     ~StockfishConnector();
     
     bool initialize(const std::string& pathToStockfish);
+    // Resets the engine for a new game with ucinewgame, keeping the process
+    // running; restarts it only if it has died
+    bool newGame();
     std::tuple<int, int, int, int> getBestMove(const Board& board, int thinkingTimeMs = 1000);
+    // Runs one search with the given UCI go command, e.g. "go movetime 100".
+    // Nothing is searched if cancel is already set when the search would start.
+    EngineSearchResult search(const Board& board, const std::string& goCommand,
+                              const std::atomic<bool>* cancel = nullptr);
+    // Leaf counts below each legal move from "go perft depth", keyed by UCI
+    // move; false if the engine reported no total
+    bool perft(const Board& board, int depth, std::map<std::string, uint64_t>& divide, uint64_t& nodes);
     void close();
     bool ensureEngineRunning();
-    void stopEngine() {
-        try {
-            sendCommand("stop");
-        } catch (...) {
-            // Handle exceptions
-        }
-    }
+    const std::string& getEngineName() const { return engineName; }
+    // Safe from any thread: makes a running search() return at once with
+    // the engine's best move so far. Does nothing between searches.
+    void stopEngine();
 };
 
 // Also add this declaration if used elsewhere
-std::tuple<int, int, int, int> algebraicToCoordinates(const std::string& move);
\ No newline at end of file
+std::tuple<int, int, int, int> algebraicToCoordinates(const std::string& move);
+
+// The legal move in board matching a UCI move string such as "e7e8q", or
+// Move::none() if there is no such move
+Move uciToMove(const Board& board, const std::string& uci);
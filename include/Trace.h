@@ -0,0 +1,37 @@
+#pragma once
+#include <string>
+
+// Timeline zones for the Chrome trace viewer (chrome://tracing, Perfetto).
+// Each thread records completed zones into its own fixed ring buffer with
+// no locks; once it wraps, the oldest zones are overwritten. Writing the
+// JSON may happen on any thread while the others keep recording. While
+// tracing is disabled a zone costs one relaxed atomic load.
+namespace Trace
+{
+    void setEnabled(bool enabled);
+    bool isEnabled();
+
+    // Names the calling thread's row in the viewer
+    void setThreadName(const char* name);
+
+    // Every thread's recorded zones as Chrome trace event JSON
+    bool writeJson(const std::string& path);
+
+    // Records the time from construction to destruction. The name must
+    // outlive the program's last writeJson, e.g. a string literal.
+    class Zone {
+    public:
+        explicit Zone(const char* name);
+        ~Zone();
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* m_name;
+        unsigned long long m_startNs;
+    };
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_ZONE(name) Trace::Zone TRACE_CONCAT(traceZone, __LINE__)(name)
@@ -1,10 +1,22 @@
 #include "AI.h"
+#include "OpeningExplorer.h"
+#include "Trace.h"
 #include <chrono>
 #include <vector>
 #include <limits>
 #include <algorithm>
 #include <stdexcept>
 
+namespace
+{
+    // Larger than any evaluation or mate score, small enough to widen without overflow
+    const int INFINITE_SCORE = 1000000;
+    // Half-width of the first aspiration window, in centipawns
+    const int ASPIRATION_WINDOW = 50;
+    // Lifts captures that do not lose material above the quiet moves
+    const int GOOD_CAPTURE_BONUS = 100000;
+}
+
 AI::AI(Color aiColor, int maxDepth) : aiColor(aiColor), maxDepth(maxDepth)
 {
     opponentColor = (aiColor == Color::White) ? Color::Black : Color::White;
@@ -34,6 +46,7 @@ int AI::getPieceValue(PieceType type)
 
 int AI::evaluateBoard(const Board &board)
 {
+    SEARCH_STAT(++stats.evalCalls);
     int materialScore = 0;
     int positionalScore = 0;
     
@@ -111,18 +124,18 @@ int AI::evaluateBoard(const Board &board)
         {
             for (int c = 0; c < 8; ++c)
             {
-                Piece *piece = board.getPiece(r, c);
+                Piece piece = board.getPiece(r, c);
                 if (piece)
                 {
                     // Material score calculation (same as before)
-                    int value = getPieceValue(piece->getType());
+                    int value = getPieceValue(piece.getType());
                     
                     // Calculate position index (0-63) with orientation based on piece color
-                    int posIdx = piece->getColor() == Color::White ? (7-r)*8 + c : r*8 + c;
+                    int posIdx = piece.getColor() == Color::White ? (7-r)*8 + c : r*8 + c;
                     
                     // Add positional score based on piece type
                     int posValue = 0;
-                    switch (piece->getType()) {
+                    switch (piece.getType()) {
                         case PieceType::Pawn:
                             posValue = pawnTable[posIdx];
                             break;
@@ -144,7 +157,7 @@ int AI::evaluateBoard(const Board &board)
                     }
                     
                     // Apply scores based on which side the piece belongs to
-                    if (piece->getColor() == aiColor)
+                    if (piece.getColor() == aiColor)
                     {
                         materialScore += value;
                         positionalScore += posValue;
@@ -173,28 +186,24 @@ int AI::evaluateBoard(const Board &board)
     int mobilityScore = 0;
     try {
         // Count legal moves for each side and add a small bonus per move
-        std::vector<Move> aiMoves = generateLegalMoves(board, aiColor);
-        std::vector<Move> opponentMoves = generateLegalMoves(board, opponentColor);
+        MoveList aiMoves;
+        MoveList opponentMoves;
+        generateLegalMoves(board, aiColor, aiMoves);
+        generateLegalMoves(board, opponentColor, opponentMoves);
         mobilityScore = (aiMoves.size() - opponentMoves.size()) * 5;
     } catch (...) {
         // Safely ignore mobility calculation if it fails
     }
 
-    // Check for checkmate/stalemate as before
-    Board boardCopy = board;
-    Color playerWhoJustMoved = board.getCurrentTurn();
-    Color playerWhoseTurnIsNext = (playerWhoJustMoved == Color::White) ? Color::Black : Color::White;
-    boardCopy.setCurrentTurn(playerWhoseTurnIsNext);
-    boardCopy.updateGameState();
-    GameState finalState = boardCopy.getGameState();
-
-    if (finalState == GameState::Checkmate)
-    {
-        int score = (playerWhoseTurnIsNext == aiColor) ? -30000 : 30000;
-        return score;
-    }
-    else if (finalState == GameState::Stalemate)
+    // Check for checkmate/stalemate of the side to move
+    Color sideToMove = board.getCurrentTurn();
+    if (!board.hasLegalMoves(sideToMove))
     {
+        if (board.isInCheck(sideToMove))
+        {
+            int score = (sideToMove == aiColor) ? -30000 : 30000;
+            return score;
+        }
         return 0;
     }
 
@@ -202,228 +211,174 @@ int AI::evaluateBoard(const Board &board)
     return materialScore + positionalScore + mobilityScore;
 }
 
-std::vector<Move> AI::generateLegalMoves(const Board &board, Color color)
+void AI::generateLegalMoves(const Board &board, Color color, MoveList &moves)
 {
-    std::vector<Move> legalMoves;
-    for (int r = 0; r < 8; ++r)
-    {
-        for (int c = 0; c < 8; ++c)
-        {
-            Piece *piece = board.getPiece(r, c);
-            if (piece && piece->getColor() == color)
-            {
-                std::vector<SDL_Point> candidates = board.fastGenerateMoves(piece);
-
-                for (const auto &pt : candidates)
-                {
-                    if (pt.y < 0 || pt.y >= 8 || pt.x < 0 || pt.x >= 8)
-                        continue;
-
-                    if (!piece->canMoveTo(pt.y, pt.x, board))
-                        continue;
-
-                    Board tempBoard = board;
-                    if (tempBoard.movePieceForSimulation(r, c, pt.y, pt.x))
-                    {
-                        legalMoves.push_back({r, c, pt.y, pt.x});
-                    }
-                }
-            }
-        }
-    }
-    return legalMoves;
+    board.generateLegalMoves(color, moves);
 }
 
-bool AI::applyMoveSimulation(Board &board, const Move &move)
+void AI::orderMoves(const Board &board, MoveList &moves)
 {
-    int toRow = move.toRow;
-    int toCol = move.toCol;
-    int fromRow = move.fromRow;
-    int fromCol = move.fromCol;
-
-    Piece *pieceToMove = board.getPiece(fromRow, fromCol);
-    if (!pieceToMove)
-    {
-        std::cerr << " applyMoveSimulation ERROR: No piece found at start (" << fromRow << "," << fromCol << ")!" << std::endl;
-        return false;
-    }
-
-    Color movingColor = pieceToMove->getColor();
-    PieceType movingType = pieceToMove->getType();
-
-    Piece *targetPiece = board.getPiece(toRow, toCol);
-
-    if (movingType == PieceType::King && std::abs(toCol - fromCol) == 2)
-    {
-        int rookFromCol = (toCol > fromCol) ? 7 : 0;
-        int rookToCol = (toCol > fromCol) ? toCol - 1 : toCol + 1;
-        Piece *rook = board.getPiece(fromRow, rookFromCol);
-        if (rook && rook->getType() == PieceType::Rook)
-        {
-            board.placePiece(rook, fromRow, rookToCol);
-            if (board.m_squares[fromRow][rookFromCol] == rook)
-            {
-                board.m_squares[fromRow][rookFromCol] = nullptr;
-            }
-            else
-            {
-                board.m_squares[fromRow][rookFromCol] = nullptr;
-            }
-        }
-        else
-        {
-            std::cerr << " applyMoveSimulation WARNING: Castling detected but no valid Rook found at (" << fromRow << "," << rookFromCol << ")" << std::endl;
-        }
-    }
-
-    Piece *capturedPieceForDeletion = nullptr;
-    int capturedPieceOriginalRow = -1, capturedPieceOriginalCol = -1;
-    bool isEnPassant = (movingType == PieceType::Pawn && fromCol != toCol && !targetPiece);
-
-    if (isEnPassant)
-    {
-        capturedPieceOriginalRow = fromRow;
-        capturedPieceOriginalCol = toCol;
-        Piece *enPassantVictim = board.getPiece(capturedPieceOriginalRow, capturedPieceOriginalCol);
-
-        if (enPassantVictim && enPassantVictim->getType() == PieceType::Pawn)
-        {
-            capturedPieceForDeletion = enPassantVictim;
-            if (board.m_squares[capturedPieceOriginalRow][capturedPieceOriginalCol] == enPassantVictim)
-            {
-                board.m_squares[capturedPieceOriginalRow][capturedPieceOriginalCol] = nullptr;
-            }
-            else
-            {
-                board.m_squares[capturedPieceOriginalRow][capturedPieceOriginalCol] = nullptr;
-            }
-        }
-        else
-        {
-            std::cerr << " applyMoveSimulation ERROR: En passant indicated but no valid victim Pawn found at (" << capturedPieceOriginalRow << "," << capturedPieceOriginalCol << ")" << std::endl;
-            capturedPieceForDeletion = nullptr;
-        }
-    }
-    else if (targetPiece)
+    // Captures and promotions that win or hold material come first, best
+    // exchange first, then quiet moves, then captures that lose material.
+    Bitboards bitboards = board.getBitboards();
+    int scores[MoveList::CAPACITY];
+    for (int i = 0; i < moves.size(); ++i)
     {
-        capturedPieceForDeletion = targetPiece;
-        capturedPieceOriginalRow = toRow;
-        capturedPieceOriginalCol = toCol;
-        if (board.m_squares[toRow][toCol] == targetPiece)
+        if (moves[i].isCapture() || moves[i].isPromotion())
         {
-            board.m_squares[toRow][toCol] = nullptr;
+            int exchange = board.staticExchange(moves[i], bitboards);
+            scores[i] = (exchange >= 0) ? GOOD_CAPTURE_BONUS + exchange : exchange;
         }
         else
         {
-            board.m_squares[toRow][toCol] = nullptr;
+            scores[i] = 0;
         }
     }
 
-    if (capturedPieceForDeletion)
+    // Insertion sort keeps generation order among equal scores
+    for (int i = 1; i < moves.size(); ++i)
     {
-        delete capturedPieceForDeletion;
-        capturedPieceForDeletion = nullptr;
-    }
-
-    board.placePiece(pieceToMove, toRow, toCol);
-
-    if (board.m_squares[fromRow][fromCol] == pieceToMove)
-    {
-        board.m_squares[fromRow][fromCol] = nullptr;
-    }
-    else
-    {
-        if (board.m_squares[fromRow][fromCol] != nullptr)
+        Move move = moves[i];
+        int score = scores[i];
+        int j = i - 1;
+        while (j >= 0 && scores[j] < score)
         {
-            board.m_squares[fromRow][fromCol] = nullptr;
+            moves[j + 1] = moves[j];
+            scores[j + 1] = scores[j];
+            --j;
         }
+        moves[j + 1] = move;
+        scores[j + 1] = score;
     }
+}
 
-    Piece *pieceOnBoardAfterMove = board.getPiece(toRow, toCol);
-    if (!pieceOnBoardAfterMove)
+bool AI::applyMoveSimulation(Board &board, Move move)
+{
+    // The move flags already say whether this is a castle, en passant or
+    // promotion, so the board can apply it without re-deriving anything.
+    if (!board.makeMove(move))
     {
-        std::cerr << " applyMoveSimulation FATAL ERROR: Piece disappeared from target square (" << toRow << "," << toCol << ") immediately after placement!" << std::endl;
+        std::cerr << " applyMoveSimulation ERROR: No piece found at start (" << move.fromRow() << "," << move.fromCol() << ")!" << std::endl;
         return false;
     }
-
-    PieceType finalTypeOnSquare = pieceOnBoardAfterMove ? pieceOnBoardAfterMove->getType() : movingType;
-
-    if (finalTypeOnSquare == PieceType::King)
-    {
-        board.updateKingPosition(movingColor, toRow, toCol);
-    }
-
-    if (movingType == PieceType::Pawn && std::abs(toRow - fromRow) == 2)
-    {
-        board.setEnPassantTarget(pieceOnBoardAfterMove, toCol);
-    }
-    else
-    {
-        board.clearEnPassantTarget();
-    }
-
     return true;
 }
 
-Move AI::minimaxRoot(const Board &board, int depth)
+ScoredMove AI::minimaxRoot(const Board &board, int depth, int alpha, int beta)
 {
-    std::vector<Move> legalMoves = generateLegalMoves(board, aiColor);
-
-    if (legalMoves.empty())
+    if (rootMoves.empty())
     {
-        return {-1, -1, -1, -1};
+        return {Move::none(), 0};
     }
 
-    Move bestMove = legalMoves[0];
+    ScoredMove bestMove = rootMoves[0];
     int maxScore = std::numeric_limits<int>::min();
 
-    int alpha = std::numeric_limits<int>::min();
-    int beta = std::numeric_limits<int>::max();
-
-    for (const auto &move : legalMoves)
+    for (auto &rootMove : rootMoves)
     {
         Board nextBoard = board;
-        if (!applyMoveSimulation(nextBoard, move))
+        if (!applyMoveSimulation(nextBoard, rootMove.move))
         {
             std::cerr << "AI WARNING: Failed to simulate legal move at root!" << std::endl;
             continue;
         }
 
         int score = minimax(nextBoard, depth - 1, alpha, beta, false);
+        if (aborted)
+        {
+            break;
+        }
+        rootMove.score = score;
 
         if (score > maxScore)
         {
             maxScore = score;
-            bestMove = move;
-            bestMove.score = score;
+            bestMove = rootMove;
         }
         alpha = std::max(alpha, score);
+        if (alpha >= beta)
+        {
+            SEARCH_STAT(++stats.betaCutoffs; if (&rootMove == &rootMoves[0]) ++stats.firstMoveCutoffs);
+            break;
+        }
     }
 
     return bestMove;
 }
 
+ScoredMove AI::searchWithAspiration(const Board &board, int depth, int previousScore)
+{
+    // The first iteration has no previous score to centre a window on.
+    if (depth == 1)
+    {
+        return minimaxRoot(board, depth, -INFINITE_SCORE, INFINITE_SCORE);
+    }
+
+    int delta = ASPIRATION_WINDOW;
+    int alpha = std::max(previousScore - delta, -INFINITE_SCORE);
+    int beta = std::min(previousScore + delta, INFINITE_SCORE);
+
+    while (true)
+    {
+        ScoredMove result = minimaxRoot(board, depth, alpha, beta);
+
+        if (aborted)
+        {
+            return result;
+        }
+        else if (result.score <= alpha && alpha > -INFINITE_SCORE)
+        {
+            // Fail low: the true score is below the window, widen downwards
+            delta *= 2;
+            alpha = std::max(previousScore - delta, -INFINITE_SCORE);
+        }
+        else if (result.score >= beta && beta < INFINITE_SCORE)
+        {
+            // Fail high: the true score is above the window, widen upwards
+            delta *= 2;
+            beta = std::min(previousScore + delta, INFINITE_SCORE);
+        }
+        else
+        {
+            return result;
+        }
+    }
+}
+
 int AI::minimax(Board board, int depth, int alpha, int beta, bool isMaximizingPlayer)
 {
-    if (depth == 0)
+    stats.nodes++;
+
+    // Polling every 256 nodes keeps the atomic load off the hot path and
+    // still answers a stop within a few milliseconds
+    if (stopFlag && (stats.nodes & 255) == 0 && stopFlag->load(std::memory_order_relaxed))
     {
-        return evaluateBoard(board);
+        aborted = true;
+    }
+    if (aborted)
+    {
+        return 0;
     }
 
-    Board boardCopy = board;
-    boardCopy.updateGameState();
-    GameState currentState = boardCopy.getGameState();
-    if (currentState == GameState::Checkmate)
+    if (depth == 0)
     {
-        return (boardCopy.getCurrentTurn() == aiColor) ? -30000 - depth : 30000 + depth;
+        return evaluateBoard(board);
     }
-    if (currentState == GameState::Stalemate)
+
+    Color sideToMove = board.getCurrentTurn();
+    if (!board.hasLegalMoves(sideToMove))
     {
+        if (board.isInCheck(sideToMove))
+        {
+            return (sideToMove == aiColor) ? -30000 - depth : 30000 + depth;
+        }
         return 0;
     }
 
     Color currentTurnColor = isMaximizingPlayer ? aiColor : opponentColor;
-    std::vector<Move> legalMoves = generateLegalMoves(board, currentTurnColor);
+    MoveList legalMoves;
+    generateLegalMoves(board, currentTurnColor, legalMoves);
+    orderMoves(board, legalMoves);
 
     if (legalMoves.empty())
     {
@@ -440,7 +395,7 @@ int AI::minimax(Board board, int depth, int alpha, int beta, bool isMaximizingPl
     if (isMaximizingPlayer)
     {
         int maxEval = std::numeric_limits<int>::min();
-        for (const auto &move : legalMoves)
+        for (const Move &move : legalMoves)
         {
             Board nextBoard = board;
             applyMoveSimulation(nextBoard, move);
@@ -449,6 +404,7 @@ int AI::minimax(Board board, int depth, int alpha, int beta, bool isMaximizingPl
             alpha = std::max(alpha, eval);
             if (beta <= alpha)
             {
+                SEARCH_STAT(++stats.betaCutoffs; if (&move == legalMoves.begin()) ++stats.firstMoveCutoffs);
                 break;
             }
         }
@@ -457,7 +413,7 @@ int AI::minimax(Board board, int depth, int alpha, int beta, bool isMaximizingPl
     else
     {
         int minEval = std::numeric_limits<int>::max();
-        for (const auto &move : legalMoves)
+        for (const Move &move : legalMoves)
         {
             Board nextBoard = board;
             applyMoveSimulation(nextBoard, move);
@@ -466,6 +422,7 @@ int AI::minimax(Board board, int depth, int alpha, int beta, bool isMaximizingPl
             beta = std::min(beta, eval);
             if (beta <= alpha)
             {
+                SEARCH_STAT(++stats.betaCutoffs; if (&move == legalMoves.begin()) ++stats.firstMoveCutoffs);
                 break;
             }
         }
@@ -475,39 +432,101 @@ int AI::minimax(Board board, int depth, int alpha, int beta, bool isMaximizingPl
 
 std::tuple<int, int, int, int> AI::getBestMove(const Board &board)
 {
+    Move move = findBestMove(board);
+    if (move.isNone())
+    {
+        return std::make_tuple(-1, -1, -1, -1);
+    }
+    return std::make_tuple(move.fromRow(), move.fromCol(), move.toRow(), move.toCol());
+}
+
+Move AI::findBestMove(const Board &board)
+{
+    TRACE_ZONE("AI::findBestMove");
     try
     {
         auto startTime = std::chrono::steady_clock::now();
+        stats.reset();
+        aborted = false;
 
-        Move bestMove = minimaxRoot(board, maxDepth);
+        if (openingBook)
+        {
+            Move bookMove = openingBook->bookMove(board, bookRng);
+            if (!bookMove.isNone())
+            {
+                return bookMove;
+            }
+        }
+
+        MoveList legalMoves;
+        generateLegalMoves(board, aiColor, legalMoves);
+        orderMoves(board, legalMoves);
+        rootMoves.clear();
+        for (Move move : legalMoves)
+        {
+            rootMoves.push_back({move, 0});
+        }
 
-        auto endTime = std::chrono::steady_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+        ScoredMove bestMove = {Move::none(), 0};
+        int previousScore = 0;
 
-        if (bestMove.fromRow == -1)
+        // Iterative deepening: each iteration searches inside an aspiration
+        // window around the previous score, with the root moves ordered by
+        // the scores they received in the previous iteration.
+        for (int depth = 1; depth <= maxDepth && !rootMoves.empty(); ++depth)
         {
-            Board temp = board;
-            temp.updateGameState();
-            if (temp.getGameState() == GameState::Checkmate || temp.getGameState() == GameState::Stalemate)
+            auto iterationStart = std::chrono::steady_clock::now();
+            uint64_t nodesBefore = stats.nodes;
+
+            ScoredMove result = searchWithAspiration(board, depth, previousScore);
+            if (aborted)
             {
+                break;
             }
-            else
+            bestMove = result;
+            previousScore = bestMove.score;
+
+            std::stable_sort(rootMoves.begin(), rootMoves.end());
+
+            DepthStats iteration;
+            iteration.depth = depth;
+            iteration.score = bestMove.score;
+            iteration.nodes = stats.nodes - nodesBefore;
+            iteration.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - iterationStart).count();
+            iteration.bestMove = bestMove.move.toUci();
+            stats.depths.push_back(iteration);
+
+            if (progressCallback)
             {
-                std::cerr << "AI ERROR: No moves found but game not over?" << std::endl;
+                progressCallback(iteration, bestMove.move);
             }
-            return std::make_tuple(-1, -1, -1, -1);
         }
 
-        return std::make_tuple(bestMove.fromRow, bestMove.fromCol, bestMove.toRow, bestMove.toCol);
+        // Stopped before the first iteration finished: the ordered first move is still legal
+        if (bestMove.move.isNone() && !rootMoves.empty())
+        {
+            bestMove = rootMoves[0];
+        }
+
+        stats.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+        if (bestMove.move.isNone())
+        {
+            if (board.hasLegalMoves(board.getCurrentTurn()))
+            {
+                std::cerr << "AI ERROR: No moves found but game not over?" << std::endl;
+            }
+        }
+        return bestMove.move;
     }
     catch (const std::exception &e)
     {
-        std::cerr << "AI::getBestMove critical exception: " << e.what() << std::endl;
-        return std::make_tuple(-1, -1, -1, -1);
+        std::cerr << "AI::findBestMove critical exception: " << e.what() << std::endl;
+        return Move::none();
     }
     catch (...)
     {
-        std::cerr << "AI::getBestMove unknown exception" << std::endl;
-        return std::make_tuple(-1, -1, -1, -1);
+        std::cerr << "AI::findBestMove unknown exception" << std::endl;
+        return Move::none();
     }
 }
\ No newline at end of file
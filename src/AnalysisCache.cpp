@@ -0,0 +1,247 @@
+#include "AnalysisCache.h"
+#include "Board.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    const uint32_t CACHE_VERSION = 1;
+    const size_t INITIAL_SLOTS = 1024;
+
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t recordSize;
+        uint32_t reserved;
+    };
+
+    uint32_t fnv1a32(const void* data, size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    uint32_t recordChecksum(const AnalysisRecord& record)
+    {
+        // Never zero, so zero padding after a torn write is never a valid record
+        return fnv1a32(&record, offsetof(AnalysisRecord, checksum)) | 1;
+    }
+
+    bool sameKey(const AnalysisRecord& record, uint64_t position, uint32_t engine, int32_t moveTimeMs)
+    {
+        return record.position == position && record.engine == engine && record.moveTimeMs == moveTimeMs;
+    }
+
+    bool deeper(const AnalysisRecord& candidate, const AnalysisRecord& current)
+    {
+        return candidate.depth > current.depth ||
+               (candidate.depth == current.depth && candidate.nodes > current.nodes);
+    }
+}
+
+bool AnalysisCache::open(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_out.close();
+    m_mapped.close();
+    m_appended.clear();
+    m_slots.assign(INITIAL_SLOTS, nullptr);
+    m_count = 0;
+
+    FileHeader header = {{'C', 'H', 'A', 'C'}, CACHE_VERSION, sizeof(AnalysisRecord), 0};
+    size_t tail = 0;
+    bool valid = false;
+    if (m_mapped.open(path) && m_mapped.size() >= sizeof(FileHeader))
+    {
+        FileHeader existing;
+        std::memcpy(&existing, m_mapped.data(), sizeof(existing));
+        valid = std::memcmp(existing.magic, header.magic, 4) == 0 && existing.version == CACHE_VERSION &&
+                existing.recordSize == sizeof(AnalysisRecord);
+    }
+
+    if (valid)
+    {
+        size_t bytes = m_mapped.size() - sizeof(FileHeader);
+        const AnalysisRecord* records = reinterpret_cast<const AnalysisRecord*>(m_mapped.data() + sizeof(FileHeader));
+        for (size_t i = 0; i < bytes / sizeof(AnalysisRecord); i++)
+        {
+            if (records[i].checksum == recordChecksum(records[i]))
+                insert(&records[i]);
+        }
+        tail = bytes % sizeof(AnalysisRecord);
+    }
+    else
+    {
+        m_mapped.close();
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!out)
+        {
+            std::cerr << "AnalysisCache: cannot create " << path << std::endl;
+            return false;
+        }
+    }
+
+    m_out.open(path, std::ios::binary | std::ios::app);
+    if (!m_out)
+    {
+        std::cerr << "AnalysisCache: cannot append to " << path << std::endl;
+        return false;
+    }
+    // Realign after a torn write; the zero bytes fail the checksum
+    if (tail)
+    {
+        const char zeros[sizeof(AnalysisRecord)] = {};
+        m_out.write(zeros, sizeof(AnalysisRecord) - tail);
+        m_out.flush();
+    }
+    return true;
+}
+
+void AnalysisCache::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_out.close();
+    m_slots.clear();
+    m_appended.clear();
+    m_mapped.close();
+    m_count = 0;
+}
+
+bool AnalysisCache::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_out.is_open();
+}
+
+uint32_t AnalysisCache::engineId(const std::string& engineName)
+{
+    return fnv1a32(engineName.data(), engineName.size());
+}
+
+size_t AnalysisCache::slotFor(uint64_t position, uint32_t engine, int32_t moveTimeMs) const
+{
+    // Zobrist keys are already well mixed; fold the search parameters in
+    uint64_t hash = position ^ (uint64_t(engine) * 0x9E3779B97F4A7C15ULL) ^ (uint64_t(uint32_t(moveTimeMs)) << 32);
+    size_t mask = m_slots.size() - 1;
+    size_t slot = static_cast<size_t>(hash ^ (hash >> 29)) & mask;
+    while (m_slots[slot] && !sameKey(*m_slots[slot], position, engine, moveTimeMs))
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+void AnalysisCache::insert(const AnalysisRecord* record)
+{
+    // Keep the load below 70%
+    if ((m_count + 1) * 10 > m_slots.size() * 7)
+    {
+        std::vector<const AnalysisRecord*> old(m_slots.size() * 2, nullptr);
+        old.swap(m_slots);
+        for (const AnalysisRecord* existing : old)
+        {
+            if (existing)
+                m_slots[slotFor(existing->position, existing->engine, existing->moveTimeMs)] = existing;
+        }
+    }
+
+    size_t slot = slotFor(record->position, record->engine, record->moveTimeMs);
+    if (!m_slots[slot])
+    {
+        m_slots[slot] = record;
+        m_count++;
+    }
+    else if (deeper(*record, *m_slots[slot]))
+    {
+        m_slots[slot] = record;
+    }
+}
+
+bool AnalysisCache::find(uint64_t position, uint32_t engine, int moveTimeMs, int minDepth, AnalysisRecord& record)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_slots.empty())
+        return false;
+
+    const AnalysisRecord* found = m_slots[slotFor(position, engine, moveTimeMs)];
+    if (!found || found->depth < minDepth)
+    {
+        m_misses++;
+        return false;
+    }
+    record = *found;
+    m_hits++;
+    return true;
+}
+
+void AnalysisCache::store(uint64_t position, uint32_t engine, int moveTimeMs, int depth, int score, Move bestMove,
+                          uint64_t nodes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_out.is_open() || bestMove.isNone())
+        return;
+
+    AnalysisRecord record = {};
+    record.position = position;
+    record.engine = engine;
+    record.moveTimeMs = moveTimeMs;
+    record.depth = static_cast<int16_t>(std::min(depth, 255));
+    record.score = static_cast<int16_t>(std::max(-32000, std::min(score, 32000)));
+    record.bestMove = bestMove.raw();
+    record.nodes = static_cast<uint32_t>(std::min<uint64_t>(nodes, UINT32_MAX));
+    record.checksum = recordChecksum(record);
+
+    const AnalysisRecord* current = m_slots[slotFor(position, engine, moveTimeMs)];
+    if (current && !deeper(record, *current))
+        return;
+
+    m_out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    m_out.flush();
+    m_appended.push_back(record);
+    insert(&m_appended.back());
+}
+
+bool AnalysisCache::findMove(const Board& board, uint32_t engine, int moveTimeMs, int depth, AnalysisRecord& record,
+                             Move& move)
+{
+    // Fixed-depth searches are served by any stored result at least as deep
+    int minDepth = (moveTimeMs > 0) ? 0 : depth;
+    if (!find(board.getZobristKey(), engine, moveTimeMs, minDepth, record))
+        return false;
+
+    MoveList legalMoves;
+    board.generateLegalMoves(board.getCurrentTurn(), legalMoves);
+    move = Move::fromRaw(record.bestMove);
+    return legalMoves.contains(move);
+}
+
+void AnalysisCache::storeMove(const Board& board, uint32_t engine, int moveTimeMs, int depth, int score,
+                              Move bestMove, uint64_t nodes)
+{
+    store(board.getZobristKey(), engine, moveTimeMs, depth, score, bestMove, nodes);
+}
+
+size_t AnalysisCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_count;
+}
+
+uint64_t AnalysisCache::hits() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+uint64_t AnalysisCache::misses() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_misses;
+}
@@ -0,0 +1,406 @@
+#include "AssetPack.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    const uint32_t PACK_VERSION = 1;
+    const uint32_t CACHE_VERSION = 1;
+    const size_t NAME_LENGTH = 48;
+
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t count;
+        uint32_t reserved;
+        uint64_t contentHash;
+    };
+
+    uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // Runs task(0..count-1) on up to threads threads
+    template <typename Task>
+    void parallelFor(size_t count, unsigned threads, Task task)
+    {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+
+        std::atomic<size_t> next{0};
+        auto worker = [&]()
+        {
+            for (size_t i = next++; i < count; i = next++)
+                task(i);
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned i = 1; i < threads; i++)
+            pool.emplace_back(worker);
+        worker();
+        for (std::thread& thread : pool)
+            thread.join();
+    }
+
+    // Control byte c < 128: c + 1 literal pixels follow.
+    // Control byte c >= 128: the next pixel repeats c - 126 times.
+    void encodeRle(const uint32_t* pixels, size_t count, std::vector<uint8_t>& out)
+    {
+        auto appendPixel = [&out](uint32_t pixel)
+        {
+            uint8_t bytes[4];
+            std::memcpy(bytes, &pixel, 4);
+            out.insert(out.end(), bytes, bytes + 4);
+        };
+
+        size_t i = 0;
+        while (i < count)
+        {
+            size_t run = 1;
+            while (i + run < count && run < 129 && pixels[i + run] == pixels[i])
+                run++;
+
+            if (run >= 2)
+            {
+                out.push_back(static_cast<uint8_t>(run + 126));
+                appendPixel(pixels[i]);
+                i += run;
+                continue;
+            }
+
+            size_t literals = 1;
+            while (i + literals < count && literals < 128 &&
+                   !(i + literals + 1 < count && pixels[i + literals] == pixels[i + literals + 1]))
+                literals++;
+            out.push_back(static_cast<uint8_t>(literals - 1));
+            for (size_t j = 0; j < literals; j++)
+                appendPixel(pixels[i + j]);
+            i += literals;
+        }
+    }
+
+    bool decodeRle(const uint8_t* src, size_t size, uint32_t* dst, size_t count)
+    {
+        const uint8_t* end = src + size;
+        size_t written = 0;
+        while (src < end)
+        {
+            uint8_t control = *src++;
+            if (control < 128)
+            {
+                size_t literals = control + 1u;
+                if (written + literals > count || static_cast<size_t>(end - src) < literals * 4)
+                    return false;
+                std::memcpy(dst + written, src, literals * 4);
+                src += literals * 4;
+                written += literals;
+            }
+            else
+            {
+                size_t run = control - 126u;
+                if (written + run > count || end - src < 4)
+                    return false;
+                uint32_t pixel;
+                std::memcpy(&pixel, src, 4);
+                src += 4;
+                std::fill(dst + written, dst + written + run, pixel);
+                written += run;
+            }
+        }
+        return written == count;
+    }
+}
+
+struct AssetPack::Entry {
+    char name[NAME_LENGTH];
+    uint32_t width;
+    uint32_t height;
+    uint64_t offset;        // of the encoded pixels, from the start of the file
+    uint64_t size;          // encoded bytes
+    uint64_t pixelHash;     // FNV-1a of the decoded pixels
+};
+
+const char* const AssetPack::DEFAULT_PATH = "images/assets.pack";
+
+bool AssetPack::open(const std::string& path)
+{
+    close();
+    if (!m_pack.open(path))
+        return false;
+
+    FileHeader header;
+    if (m_pack.size() < sizeof(header))
+    {
+        close();
+        return false;
+    }
+    std::memcpy(&header, m_pack.data(), sizeof(header));
+    if (std::memcmp(header.magic, "CHPK", 4) != 0 || header.version != PACK_VERSION ||
+        m_pack.size() < sizeof(header) + header.count * sizeof(Entry))
+    {
+        std::cerr << "AssetPack: " << path << " is not a version " << PACK_VERSION << " asset pack" << std::endl;
+        close();
+        return false;
+    }
+
+    m_entries = reinterpret_cast<const Entry*>(m_pack.data() + sizeof(header));
+    m_count = header.count;
+    m_contentHash = header.contentHash;
+    for (uint32_t i = 0; i < m_count; i++)
+    {
+        const Entry& entry = m_entries[i];
+        if (entry.offset + entry.size > m_pack.size() || entry.name[NAME_LENGTH - 1] != '\0')
+        {
+            std::cerr << "AssetPack: " << path << " has a corrupt directory" << std::endl;
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetPack::close()
+{
+    m_images.clear();
+    m_decodedPixels.clear();
+    m_cache.close();
+    m_pack.close();
+    m_entries = nullptr;
+    m_count = 0;
+    m_contentHash = 0;
+    m_decoded = false;
+}
+
+bool AssetPack::loadCache(const std::string& cachePath)
+{
+    if (cachePath.empty() || !m_cache.open(cachePath))
+        return false;
+
+    FileHeader header;
+    size_t expected = sizeof(header);
+    for (uint32_t i = 0; i < m_count; i++)
+        expected += static_cast<size_t>(m_entries[i].width) * m_entries[i].height * 4;
+
+    if (m_cache.size() != expected)
+    {
+        m_cache.close();
+        return false;
+    }
+    std::memcpy(&header, m_cache.data(), sizeof(header));
+    // The cache is only ever written whole (see saveCache) from pixels that
+    // matched their hashes, so the pack's content hash is enough to trust it
+    if (std::memcmp(header.magic, "CHPC", 4) != 0 || header.version != CACHE_VERSION ||
+        header.count != m_count || header.contentHash != m_contentHash)
+    {
+        m_cache.close();
+        return false;
+    }
+
+    m_images.assign(m_count, AssetImage());
+    size_t offset = sizeof(header);
+    for (uint32_t i = 0; i < m_count; i++)
+    {
+        const Entry& entry = m_entries[i];
+        m_images[i].name = entry.name;
+        m_images[i].width = static_cast<int>(entry.width);
+        m_images[i].height = static_cast<int>(entry.height);
+        m_images[i].pixels = reinterpret_cast<const uint32_t*>(m_cache.data() + offset);
+        offset += static_cast<size_t>(entry.width) * entry.height * 4;
+    }
+    return true;
+}
+
+void AssetPack::saveCache(const std::string& cachePath) const
+{
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            std::cerr << "AssetPack: cannot write cache " << tempPath << std::endl;
+            return;
+        }
+
+        FileHeader header = {{'C', 'H', 'P', 'C'}, CACHE_VERSION, m_count, 0, m_contentHash};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const AssetImage& image : m_images)
+            out.write(reinterpret_cast<const char*>(image.pixels), static_cast<std::streamsize>(image.width) * image.height * 4);
+        if (!out)
+        {
+            std::cerr << "AssetPack: cannot write cache " << tempPath << std::endl;
+            return;
+        }
+    }
+
+    // Readers only ever see a complete cache
+    std::remove(cachePath.c_str());
+    if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0)
+    {
+        std::cerr << "AssetPack: cannot replace cache " << cachePath << std::endl;
+        std::remove(tempPath.c_str());
+    }
+}
+
+bool AssetPack::decode(const std::string& cachePath, unsigned threads)
+{
+    if (!m_pack.isOpen())
+        return false;
+    if (m_decoded)
+        return true;
+
+    if (loadCache(cachePath))
+    {
+        m_decoded = true;
+        return true;
+    }
+
+    m_images.assign(m_count, AssetImage());
+    m_decodedPixels.assign(m_count, std::vector<uint32_t>());
+    std::atomic<bool> valid{true};
+    parallelFor(m_count, threads, [&](size_t i)
+    {
+        const Entry& entry = m_entries[i];
+        size_t pixelCount = static_cast<size_t>(entry.width) * entry.height;
+        std::vector<uint32_t>& pixels = m_decodedPixels[i];
+        pixels.resize(pixelCount);
+
+        if (!decodeRle(m_pack.data() + entry.offset, static_cast<size_t>(entry.size), pixels.data(), pixelCount) ||
+            fnv1a(pixels.data(), pixelCount * 4) != entry.pixelHash)
+        {
+            valid = false;
+            return;
+        }
+        m_images[i].name = entry.name;
+        m_images[i].width = static_cast<int>(entry.width);
+        m_images[i].height = static_cast<int>(entry.height);
+        m_images[i].pixels = pixels.data();
+    });
+
+    if (!valid)
+    {
+        std::cerr << "AssetPack: corrupt image data, falling back to BMP files" << std::endl;
+        m_images.clear();
+        m_decodedPixels.clear();
+        return false;
+    }
+
+    if (!cachePath.empty())
+        saveCache(cachePath);
+    m_decoded = true;
+    return true;
+}
+
+const AssetImage* AssetPack::find(const std::string& name) const
+{
+    for (const AssetImage& image : m_images)
+    {
+        if (image.name == name)
+            return &image;
+    }
+    return nullptr;
+}
+
+SDL_Texture* AssetPack::createTexture(SDL_Renderer* renderer, const std::string& name) const
+{
+    const AssetImage* image = find(name);
+    if (!image)
+        return nullptr;
+
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                                             image->width, image->height);
+    if (!texture)
+    {
+        std::cerr << "AssetPack: cannot create texture for " << name << ": " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+    SDL_UpdateTexture(texture, nullptr, image->pixels, image->width * 4);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+bool AssetPack::write(const std::string& path, const std::vector<AssetImage>& images)
+{
+    std::vector<Entry> entries(images.size());
+    std::vector<std::vector<uint8_t>> encoded(images.size());
+    uint64_t contentHash = fnv1a(nullptr, 0);
+    uint64_t offset = sizeof(FileHeader) + images.size() * sizeof(Entry);
+
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        const AssetImage& image = images[i];
+        if (image.name.size() >= NAME_LENGTH)
+        {
+            std::cerr << "AssetPack: image name too long: " << image.name << std::endl;
+            return false;
+        }
+
+        size_t pixelCount = static_cast<size_t>(image.width) * image.height;
+        encodeRle(image.pixels, pixelCount, encoded[i]);
+
+        Entry& entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+        std::memcpy(entry.name, image.name.c_str(), image.name.size());
+        entry.width = static_cast<uint32_t>(image.width);
+        entry.height = static_cast<uint32_t>(image.height);
+        entry.offset = offset;
+        entry.size = encoded[i].size();
+        entry.pixelHash = fnv1a(image.pixels, pixelCount * 4);
+        offset += entry.size;
+
+        contentHash = fnv1a(entry.name, NAME_LENGTH, contentHash);
+        contentHash = fnv1a(&entry.width, sizeof(entry.width) * 2, contentHash);
+        contentHash = fnv1a(&entry.pixelHash, sizeof(entry.pixelHash), contentHash);
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "AssetPack: cannot write " << path << std::endl;
+        return false;
+    }
+    FileHeader header = {{'C', 'H', 'P', 'K'}, PACK_VERSION, static_cast<uint32_t>(images.size()), 0, contentHash};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+    for (const std::vector<uint8_t>& data : encoded)
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(out);
+}
+
+SDL_Texture* loadImageTexture(SDL_Renderer* renderer, const AssetPack& assets, const char* path)
+{
+    std::string name = path;
+    size_t slash = name.find_last_of("/\\");
+    if (slash != std::string::npos)
+        name = name.substr(slash + 1);
+
+    if (assets.isDecoded())
+    {
+        if (SDL_Texture* texture = assets.createTexture(renderer, name))
+            return texture;
+    }
+
+    SDL_Surface* surface = SDL_LoadBMP(path);
+    if (!surface)
+    {
+        std::cerr << "Failed to load image: " << path << std::endl;
+        return nullptr;
+    }
+
+    SDL_SetSurfaceColorKey(surface, true, SDL_MapSurfaceRGB(surface, 255, 0, 255));
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_DestroySurface(surface);
+    return texture;
+}
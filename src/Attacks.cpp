@@ -0,0 +1,101 @@
+#include "Attacks.h"
+
+namespace {
+
+// Ray directions as {row step, col step}. The first four point towards
+// higher square indices, so their nearest blocker is the lowest set bit.
+constexpr int RAY_DIRECTIONS[8][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1},
+                                  {-1, 0}, {0, -1}, {-1, -1}, {-1, 1}};
+
+// Built at compile time, so the tables are in place before any static
+// initializer in another file can look at them
+struct AttackTables {
+    uint64_t knight[64] = {};
+    uint64_t king[64] = {};
+    uint64_t pawn[2][64] = {};
+    uint64_t rays[8][64] = {};
+
+    constexpr AttackTables() {
+        constexpr int knightSteps[8][2] = {{2, 1}, {1, 2}, {-1, 2}, {-2, 1},
+                                       {-2, -1}, {-1, -2}, {1, -2}, {2, -1}};
+        for (int square = 0; square < 64; ++square) {
+            int row = square / 8;
+            int col = square % 8;
+            knight[square] = 0;
+            king[square] = 0;
+            pawn[0][square] = 0;
+            pawn[1][square] = 0;
+
+            for (const auto& step : knightSteps)
+                knight[square] |= bitIfOnBoard(row + step[0], col + step[1]);
+
+            for (int dr = -1; dr <= 1; ++dr)
+                for (int dc = -1; dc <= 1; ++dc)
+                    if (dr != 0 || dc != 0)
+                        king[square] |= bitIfOnBoard(row + dr, col + dc);
+
+            // White pawns move towards row 7, black pawns towards row 0
+            pawn[0][square] = bitIfOnBoard(row + 1, col - 1) | bitIfOnBoard(row + 1, col + 1);
+            pawn[1][square] = bitIfOnBoard(row - 1, col - 1) | bitIfOnBoard(row - 1, col + 1);
+
+            for (int dir = 0; dir < 8; ++dir) {
+                rays[dir][square] = 0;
+                for (int r = row + RAY_DIRECTIONS[dir][0], c = col + RAY_DIRECTIONS[dir][1];
+                     r >= 0 && r < 8 && c >= 0 && c < 8;
+                     r += RAY_DIRECTIONS[dir][0], c += RAY_DIRECTIONS[dir][1]) {
+                    rays[dir][square] |= 1ULL << (r * 8 + c);
+                }
+            }
+        }
+    }
+
+    static constexpr uint64_t bitIfOnBoard(int row, int col) {
+        return (row >= 0 && row < 8 && col >= 0 && col < 8) ? 1ULL << (row * 8 + col) : 0;
+    }
+};
+
+constexpr AttackTables TABLES;
+
+const AttackTables& tables() {
+    return TABLES;
+}
+
+// Attacks along one ray, stopping at (and including) the first blocker
+uint64_t rayAttacks(int dir, int square, uint64_t occupied) {
+    const AttackTables& t = tables();
+    uint64_t attacks = t.rays[dir][square];
+    uint64_t blockers = attacks & occupied;
+    if (blockers) {
+        int blocker = (dir < 4) ? Attacks::lsb(blockers) : Attacks::msb(blockers);
+        attacks ^= t.rays[dir][blocker];
+    }
+    return attacks;
+}
+
+}
+
+namespace Attacks {
+
+uint64_t knight(int square) {
+    return tables().knight[square];
+}
+
+uint64_t king(int square) {
+    return tables().king[square];
+}
+
+uint64_t pawn(Color color, int square) {
+    return tables().pawn[color == Color::White ? 0 : 1][square];
+}
+
+uint64_t bishop(int square, uint64_t occupied) {
+    return rayAttacks(2, square, occupied) | rayAttacks(3, square, occupied) |
+           rayAttacks(6, square, occupied) | rayAttacks(7, square, occupied);
+}
+
+uint64_t rook(int square, uint64_t occupied) {
+    return rayAttacks(0, square, occupied) | rayAttacks(1, square, occupied) |
+           rayAttacks(4, square, occupied) | rayAttacks(5, square, occupied);
+}
+
+}
@@ -0,0 +1,89 @@
+#include "Bench.h"
+#include "AI.h"
+#include "Board.h"
+#include <chrono>
+#include <iostream>
+
+const std::vector<std::string>& benchPositions()
+{
+    // Openings and perft test positions, positions from built-in AI self-play
+    // at depth 3, then endgames
+    static const std::vector<std::string> positions = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r1bqk2r/pppp1ppp/2n2n2/2b1p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+        "rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5",
+        "r1bq1rk1/pp2ppbp/2np1np1/8/3NP3/2N1BP2/PPPQ2PP/R3KB1R w KQ - 3 9",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "r1b1k2r/pppB1ppp/5q2/4p3/1n2n3/4BN2/PPP1NPPP/R2Q1K1R b kq - 0 9",
+        "4k2r/1ppb1ppp/8/8/1B6/8/rqP1NPPP/1n1Q2KR b k - 0 15",
+        "4k2r/1pp2ppp/2b5/8/8/2P1qP2/3nN1PP/3QK2R b k - 4 21",
+        "r5k1/1pp2ppp/8/8/2P2P2/4q3/4N1bP/1Q2K1R1 b - - 1 27",
+        "6k1/1pp4p/5p2/2P2b2/5P2/8/r3NK1P/8 b - - 0 33",
+        "r1b1kb1r/pp3ppp/2n2n2/q1pppQ2/4P3/2N5/PPPP1PPP/R1B1KBNR w KQkq d6 0 8",
+        "r1b1kb1r/pp3p2/2n4p/q1p1p3/3pPnp1/2N3Q1/PPPP1PPP/R1B1KBNR w KQkq - 0 14",
+        "r1b1kb1r/pp3p2/2n4p/2R1p3/Nq1pP1p1/8/P1PP1PQP/2B1KBNR w Kkq - 3 20",
+        "r3k2r/pp3p2/4b2p/2b1p3/3nP1p1/4K1Q1/P1PP1P1P/2q2BNR w kq - 0 26",
+        "r3kbnr/p1p1pppp/4b3/8/1n2P3/8/PP3PPP/RNB1KBNR b KQkq e3 0 8",
+        "1r1k1bnr/p1p1pppp/2B1b3/6B1/4P3/5P2/PP2N1PP/nN1K3R b - - 4 14",
+        "2k2bnr/p1p1pppp/2B5/6B1/3NP3/5P2/3NK1PP/r3R3 b - - 0 20",
+        "4kb1r/p1pnpppp/2B5/6B1/4P3/r4P2/2NNK1PP/1R6 b - - 12 26",
+        "4kb1r/p2R3p/2B1p1p1/6p1/2N1P3/5P2/3NK1PP/8 b - - 0 32",
+        "r1bq1rk1/1ppp1p1p/p1n1p1p1/1N1P4/QbP1n3/4B3/PP2PPPP/R2K1BNR b - - 0 9",
+        "r1b2rk1/2ppnp1p/p5p1/3P2N1/pb6/2N5/PP2PBPP/2RK1B1R b - - 2 15",
+        "r1b2rk1/2p1n3/p2p2pp/3P1p2/8/bRN2N2/P3PBPP/3K1B1R b - - 1 21",
+        "r1b2r2/b1p1n1k1/p2p4/3P2pR/4N3/1R3NP1/P3P1P1/3K1B2 b - - 2 27",
+        "1r6/b1pb2k1/p2p1n2/3r2N1/7R/1R1BPNP1/P5P1/3K4 b - - 4 33",
+        "r1b1k2r/ppB2ppp/2n1pn2/8/1b1Pp2q/2N1Q3/PPP1NPPP/R3KB1R b KQkq - 1 8",
+        "r1b1k2r/ppN2ppp/4p3/8/4p3/6B1/PP1K1PPP/n4B1R b kq - 1 14",
+        "2b3k1/1pN2ppp/p3p3/1B2B3/3rp3/8/PP3PPP/n1K4R b - - 1 20",
+        "2b3k1/1p3ppp/8/4p3/1B6/4P3/PP4PP/K6R b - - 0 26",
+        "1B6/1p4pk/5p1p/4p3/4b3/4P3/PP1R2PP/K7 b - - 5 32",
+        "rnb1kb1r/pp2pp2/2p2n1p/6p1/1q2pQ2/2N1B3/PPP2PPP/2KR1BNR w kq g6 0 9",
+        "r1b1k2r/p2npp2/2p4p/Qp2b1p1/N3p3/P3B3/1PP2PPP/2KR1BNR w kq b6 0 15",
+        "r3k3/p2b3r/2p1p2p/5pB1/1p2p3/PQ6/1PP2PPR/2KR1BN1 w q - 0 21",
+        "4k3/prBb4/2p1p3/5p1r/1P2p3/1Q6/1PP2PPR/2KR2N1 w - - 0 27",
+        "6R1/pr1b2Q1/4k3/2p1pp2/1P2p3/8/1PP1NPP1/2KR4 w - - 2 33",
+        "r1b1k2r/pppp1ppp/3P1q2/1Bb1p3/1n6/5N2/PPPQ1PPP/RNB1K2R b KQkq - 0 8",
+        "r6r/pppbkppp/8/4q3/1n6/2N5/PPP2QPP/R1B1R1K1 b - - 0 14",
+        "r3r3/pppb2Rp/2k5/2n5/3Q4/2N5/PPP3PP/R5K1 b - - 0 20",
+        "rnb1kbnr/pppp1ppp/8/4pN2/Q1Pq4/6P1/PP1PPPBP/RNB1K2R b KQkq - 4 7",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "2r3k1/5pp1/7p/8/8/7P/5PP1/2R3K1 w - - 0 1",
+        "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+        "8/p7/1p6/2p5/2P5/1P6/P7/k1K5 w - - 0 1",
+        "8/8/4k3/8/4P3/4K3/8/8 w - - 0 1",
+        "8/8/8/4k3/8/8/8/R3K3 w Q - 0 1",
+        "8/5k2/8/8/8/8/1K6/3Q4 w - - 0 1",
+        "8/8/8/8/8/8/6k1/4K2R w K - 0 1",
+    };
+    return positions;
+}
+
+BenchResult runBench(int depth, std::ostream& progress)
+{
+    BenchResult result;
+    const std::vector<std::string>& positions = benchPositions();
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        Board board;
+        if (!board.loadFEN(positions[i]))
+        {
+            progress << "Invalid bench position: " << positions[i] << std::endl;
+            continue;
+        }
+
+        AI ai(board.getCurrentTurn(), depth);
+        auto start = std::chrono::steady_clock::now();
+        ai.findBestMove(board);
+        result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.nodes += ai.getNodeCount();
+        result.positions++;
+        progress << "Position " << i + 1 << "/" << positions.size() << ": " << ai.getNodeCount() << " nodes"
+                 << std::endl;
+    }
+    return result;
+}
@@ -1,1225 +1,446 @@
 #include "Board.h"
-#include "Game.h"
 #include <unordered_map>
 #include <vector>
 
-#include <future>
 #include <unordered_set>
-#include <chrono>
-#include <mutex>
 #include <sstream>
 #include <string>
-static std::mutex g_validMovesMutex;
-
-#include <future>
-#include <atomic>
 #include "Piece.h"
 
 #include "Zobrist.h"
+#include "Attacks.h"
 
-std::atomic<bool> g_validMovesReady(false);
-std::atomic<bool> g_validMovesComputed(false);
-
-inline bool operator==(const SDL_Point &a, const SDL_Point &b)
-{
-    return a.x == b.x && a.y == b.y;
-}
-
-Piece* findPieceInCopy(const std::vector<std::vector<Piece*>>& squares, const Piece* originalPiece) {
-    if (!originalPiece) return nullptr;
-    int r = originalPiece->getRow();
-    int c = originalPiece->getCol();
-    if (r >= 0 && r < 8 && c >= 0 && c < 8) {
-
-        return squares[r][c];
-    }
-    return nullptr;
-}
-
-Board::Board(const Board& other) :
-    m_currentTurn(other.m_currentTurn),
-    m_gameState(other.m_gameState),
-    m_selectedRow(other.m_selectedRow),
-    m_selectedCol(other.m_selectedCol),
-    m_pieceSelected(other.m_pieceSelected),
-    m_whiteKingRow(other.m_whiteKingRow),
-    m_whiteKingCol(other.m_whiteKingCol),
-    m_blackKingRow(other.m_blackKingRow),
-    m_blackKingCol(other.m_blackKingCol),
-    m_lastMovedPawn(nullptr),
-    m_enPassantCol(other.m_enPassantCol),
-    m_movingPiece(nullptr),
-    m_animProgress(0.0f),
-    m_animating(false),
-    m_moveFromRow(other.m_moveFromRow),
-    m_moveFromCol(other.m_moveFromCol),
-    m_moveToRow(other.m_moveToRow),
-    m_moveToCol(other.m_moveToCol),
-    m_capturedPiece(nullptr)
-
-{
-    m_squares.resize(8, std::vector<Piece*>(8, nullptr));
-
-
-    for (int r = 0; r < 8; ++r) {
-        for (int c = 0; c < 8; ++c) {
-            if (other.m_squares[r][c] != nullptr) {
-                const Piece* originalPiece = other.m_squares[r][c];
-
-                switch (originalPiece->getType()) {
-                    case PieceType::King:   m_squares[r][c] = new King(originalPiece->getColor(), r, c); break;
-                    case PieceType::Queen:  m_squares[r][c] = new Queen(originalPiece->getColor(), r, c); break;
-                    case PieceType::Rook:   m_squares[r][c] = new Rook(originalPiece->getColor(), r, c); break;
-                    case PieceType::Bishop: m_squares[r][c] = new Bishop(originalPiece->getColor(), r, c); break;
-                    case PieceType::Knight: m_squares[r][c] = new Knight(originalPiece->getColor(), r, c); break;
-                    case PieceType::Pawn:   m_squares[r][c] = new Pawn(originalPiece->getColor(), r, c); break;
-
-                }
-
-                if (originalPiece->hasMoved()) {
-                   if(m_squares[r][c]) m_squares[r][c]->setPosition(r, c);
-                }
-            } else {
-                m_squares[r][c] = nullptr;
-            }
-        }
-    }
-
-
-    if (other.m_lastMovedPawn && other.m_enPassantCol != -1) {
-
-        int pawnRow = other.m_lastMovedPawn->getRow();
-        int pawnCol = other.m_lastMovedPawn->getCol();
-        if (pawnRow >= 0 && pawnRow < 8 && pawnCol >= 0 && pawnCol < 8 && m_squares[pawnRow][pawnCol]) {
-
-             if (m_squares[pawnRow][pawnCol]->getType() == PieceType::Pawn &&
-                 m_squares[pawnRow][pawnCol]->getColor() == other.m_lastMovedPawn->getColor())
-             {
-                  m_lastMovedPawn = m_squares[pawnRow][pawnCol];
-             } else {
-
-                 m_lastMovedPawn = nullptr;
-                 m_enPassantCol = -1;
-             }
-        } else {
-
-             m_lastMovedPawn = nullptr;
-             m_enPassantCol = -1;
-        }
-    } else {
-
-        m_lastMovedPawn = nullptr;
-
-        if (m_lastMovedPawn == nullptr) {
-            m_enPassantCol = -1;
-        }
-    }
-}
-
-
-Board& Board::operator=(const Board& other) {
-    if (this == &other) {
-        return *this;
-    }
-
-
-    for (auto& row : m_squares) {
-        for (auto piece : row) {
-            delete piece;
-        }
-        row.assign(8, nullptr);
-    }
-
-
-    m_currentTurn = other.m_currentTurn;
-    m_gameState = other.m_gameState;
-    m_selectedRow = other.m_selectedRow;
-    m_selectedCol = other.m_selectedCol;
-    m_pieceSelected = other.m_pieceSelected;
-    m_whiteKingRow = other.m_whiteKingRow;
-    m_whiteKingCol = other.m_whiteKingCol;
-    m_blackKingRow = other.m_blackKingRow;
-    m_blackKingCol = other.m_blackKingCol;
-    m_enPassantCol = other.m_enPassantCol;
-    m_animProgress = 0.0f;
-    m_animating = false;
-    m_moveFromRow = other.m_moveFromRow;
-    m_moveFromCol = other.m_moveFromCol;
-    m_moveToRow = other.m_moveToRow;
-    m_moveToCol = other.m_moveToCol;
-    m_capturedPiece = nullptr;
-    m_lastMovedPawn = nullptr;
-    m_movingPiece = nullptr;
-    m_validMoves.clear();
-    m_candidateMoves.clear();
-    m_legalMoveCache.clear();
-
-
-
-    for (int r = 0; r < 8; ++r) {
-        for (int c = 0; c < 8; ++c) {
-            if (other.m_squares[r][c] != nullptr) {
-                 const Piece* originalPiece = other.m_squares[r][c];
-                switch (originalPiece->getType()) {
-                    case PieceType::King:   m_squares[r][c] = new King(originalPiece->getColor(), r, c); break;
-                    case PieceType::Queen:  m_squares[r][c] = new Queen(originalPiece->getColor(), r, c); break;
-                    case PieceType::Rook:   m_squares[r][c] = new Rook(originalPiece->getColor(), r, c); break;
-                    case PieceType::Bishop: m_squares[r][c] = new Bishop(originalPiece->getColor(), r, c); break;
-                    case PieceType::Knight: m_squares[r][c] = new Knight(originalPiece->getColor(), r, c); break;
-                    case PieceType::Pawn:   m_squares[r][c] = new Pawn(originalPiece->getColor(), r, c); break;
-                }
-                 if (originalPiece->hasMoved()) {
-                     if(m_squares[r][c]) m_squares[r][c]->setPosition(r, c);
-                 }
-            } else {
-                m_squares[r][c] = nullptr;
-            }
-        }
-    }
-
-    if (other.m_lastMovedPawn && other.m_enPassantCol != -1) {
-        int pawnRow = other.m_lastMovedPawn->getRow();
-        int pawnCol = other.m_lastMovedPawn->getCol();
-        if (pawnRow >= 0 && pawnRow < 8 && pawnCol >= 0 && pawnCol < 8 && m_squares[pawnRow][pawnCol]) {
-            if (m_squares[pawnRow][pawnCol]->getType() == PieceType::Pawn &&
-                 m_squares[pawnRow][pawnCol]->getColor() == other.m_lastMovedPawn->getColor())
-             {
-                  m_lastMovedPawn = m_squares[pawnRow][pawnCol];
-             } else {
-
-                 m_lastMovedPawn = nullptr;
-                 m_enPassantCol = -1;
-             }
-        } else {
-             m_lastMovedPawn = nullptr;
-             m_enPassantCol = -1;
-        }
-    } else {
-        m_lastMovedPawn = nullptr;
-        if (m_lastMovedPawn == nullptr) {
-            m_enPassantCol = -1;
-        }
-    }
-    return *this;
-}
-
-uint64_t Board::getZobristKey() const {
-    uint64_t key = 0;
-
-    for (int row = 0; row < 8; row++){
-        for (int col = 0; col < 8; col++){
-            Piece* piece = getPiece(row, col);
-            if (piece) {
-                int square = row * 8 + col;
-                int colorIndex = (piece->getColor() == Color::White) ? 0 : 1;
-                int typeIndex;
-                switch(piece->getType()){
-                    case PieceType::King:   typeIndex = 0; break;
-                    case PieceType::Queen:  typeIndex = 1; break;
-                    case PieceType::Rook:   typeIndex = 2; break;
-                    case PieceType::Bishop: typeIndex = 3; break;
-                    case PieceType::Knight: typeIndex = 4; break;
-                    case PieceType::Pawn:   typeIndex = 5; break;
-                }
-                key ^= zobristTable[colorIndex][typeIndex][square];
-            }
-        }
-    }
-
-    if(m_currentTurn == Color::White)
-        key ^= zobristSide;
-    return key;
-}
-
-bool Board::isValidMovesComputed() const
-{
-    return g_validMovesComputed.load();
-}
-
-
-std::string Board::getPositionKey() const {
-    std::stringstream ss;
-    for (int row = 0; row < 8; row++){
-        for (int col = 0; col < 8; col++){
-            Piece* piece = getPiece(row, col);
-            if (piece) {
-                ss << static_cast<int>(piece->getType())
-                   << (piece->getColor() == Color::White ? "W" : "B");
-            } else {
-                ss << "0";
-            }
-            ss << ",";
-        }
-    }
-    return ss.str();
-}
-
-Board::Board() : m_currentTurn(Color::White), m_gameState(GameState::Active),
-                 m_selectedRow(-1), m_selectedCol(-1), m_pieceSelected(false),
-                 m_whiteKingRow(0), m_whiteKingCol(4),
-                 m_blackKingRow(7), m_blackKingCol(4),
-                 m_lastMovedPawn(nullptr), m_enPassantCol(-1),
-                 m_movingPiece(nullptr), m_animProgress(0.0f), m_animating(false)
-{
-    m_candidateMoves = {};
-
-    m_squares.resize(8);
-    for (auto &row : m_squares)
-    {
-        row.resize(8, nullptr);
-    }
-}
-
-Board::~Board()
-{
-
-    for (auto &row : m_squares)
-    {
-        for (auto piece : row)
-        {
-            delete piece;
-        }
-    }
-}
-
-void Board::initialize()
-{
-
-    for (auto &row : m_squares)
-    {
-        for (auto &piece : row)
-        {
-            delete piece;
-            piece = nullptr;
-        }
-    }
-
+namespace {
 
-    m_squares[0][0] = new Rook(Color::White, 0, 0);
-    m_squares[0][1] = new Knight(Color::White, 0, 1);
-    m_squares[0][2] = new Bishop(Color::White, 0, 2);
-    m_squares[0][3] = new Queen(Color::White, 0, 3);
-    m_squares[0][4] = new King(Color::White, 0, 4);
-    m_squares[0][5] = new Bishop(Color::White, 0, 5);
-    m_squares[0][6] = new Knight(Color::White, 0, 6);
-    m_squares[0][7] = new Rook(Color::White, 0, 7);
-
-    for (int col = 0; col < 8; col++)
-    {
-        m_squares[1][col] = new Pawn(Color::White, 1, col);
-    }
-
-
-    m_squares[7][0] = new Rook(Color::Black, 7, 0);
-    m_squares[7][1] = new Knight(Color::Black, 7, 1);
-    m_squares[7][2] = new Bishop(Color::Black, 7, 2);
-    m_squares[7][3] = new Queen(Color::Black, 7, 3);
-    m_squares[7][4] = new King(Color::Black, 7, 4);
-    m_squares[7][5] = new Bishop(Color::Black, 7, 5);
-    m_squares[7][6] = new Knight(Color::Black, 7, 6);
-    m_squares[7][7] = new Rook(Color::Black, 7, 7);
-
-    for (int col = 0; col < 8; col++)
-    {
-        m_squares[6][col] = new Pawn(Color::Black, 6, col);
-    }
-
-
-    m_currentTurn = Color::White;
-    m_gameState = GameState::Active;
-    m_selectedRow = -1;
-    m_selectedCol = -1;
-    m_pieceSelected = false;
-    m_validMoves.clear();
-    m_lastMovedPawn = nullptr;
-    m_enPassantCol = -1;
-    m_animating = false;
-
-
-    m_whiteKingRow = 0;
-    m_whiteKingCol = 4;
-    m_blackKingRow = 7;
-    m_blackKingCol = 4;
-}
-
-void Board::updateLegalMoveCache(Color color)
-{
-
-    m_legalMoveCache.clear();
-
-
-    for (int row = 0; row < 8; ++row)
-    {
-        for (int col = 0; col < 8; ++col)
-        {
-            Piece* piece = getPiece(row, col);
-            if(piece && piece->getColor() == color)
-            {
-
-                m_legalMoveCache[piece] = fastGenerateMoves(piece);
-            }
-        }
-    }
-}
-
-void Board::calculateValidMovesAsync(int row, int col)
-{
-    Piece* piece = getPiece(row, col);
-    if (!piece)
-        return;
-
-    std::future<void> task = std::async(std::launch::async, [this, row, col, piece]() {
-        auto start = std::chrono::high_resolution_clock::now();
-
-
-        std::vector<SDL_Point> candidates = fastGenerateMoves(piece);
-        auto afterCandidates = std::chrono::high_resolution_clock::now();
-
-
-
-        std::vector<SDL_Point> validMoves;
-        bool inCheck = isInCheck(m_currentTurn);
-        auto afterInCheck = std::chrono::high_resolution_clock::now();
-
-
-
-        std::vector<std::tuple<int, int, int, int>> pins = getPins(m_currentTurn);
-        std::vector<std::tuple<int, int, int, int>> checks = getChecks(m_currentTurn);
-        auto afterPinsChecks = std::chrono::high_resolution_clock::now();
-
-
-
-        int kingRow = (m_currentTurn == Color::White) ? m_whiteKingRow : m_blackKingRow;
-        int kingCol = (m_currentTurn == Color::White) ? m_whiteKingCol : m_blackKingCol;
-
-        if (inCheck)
-        {
-            if (checks.size() == 1)
-            {
-                auto [checkRow, checkCol, dr, dc] = checks[0];
-                std::vector<SDL_Point> validSquares;
-                Piece* checker = getPiece(checkRow, checkCol);
-                if (checker->getType() != PieceType::Knight)
-                {
-                    for (int i = 1; i < 8; i++)
-                    {
-                        int r = kingRow + dr * i;
-                        int c = kingCol + dc * i;
-                        if (r == checkRow && c == checkCol)
-                            break;
-                        if (r >= 0 && r < 8 && c >= 0 && c < 8)
-                            validSquares.push_back({c, r});
-                    }
-                }
-                validSquares.push_back({checkCol, checkRow});
-
-                for (const auto& move : candidates)
-                {
-                    if (piece->getType() == PieceType::King)
-                    {
-                        if (movePieceForSimulation(row, col, move.y, move.x))
-                            validMoves.push_back(move);
-                    }
-                    else if (std::find(validSquares.begin(), validSquares.end(), move) != validSquares.end())
-                    {
-                        if (movePieceForSimulation(row, col, move.y, move.x))
-                            validMoves.push_back(move);
-                    }
-                }
-            }
-            else
-            {
-
-                if (piece->getType() == PieceType::King)
-                {
-                    for (const auto& move : candidates)
-                    {
-                        if (movePieceForSimulation(row, col, move.y, move.x))
-                            validMoves.push_back(move);
-                    }
-                }
-            }
-        }
-        else
-        {
-            bool pinned = false;
-            std::pair<int, int> pinDir;
-            for (const auto& pin : pins)
-            {
-                if (std::get<0>(pin) == row && std::get<1>(pin) == col)
-                {
-                    pinned = true;
-                    pinDir = {std::get<2>(pin), std::get<3>(pin)};
-                    break;
-                }
-            }
-
-            int simCount = 0;
-            for (const auto& move : candidates)
-            {
-                if (!pinned || alignsWithPin(row, col, move.y, move.x, pinDir))
-                {
-                    if (piece->canMoveTo(move.y, move.x, *this) && movePieceForSimulation(row, col, move.y, move.x))
-                        validMoves.push_back(move);
-                    simCount++;
-                }
-            }
-            auto end = std::chrono::high_resolution_clock::now();
-
-        }
-
-        std::lock_guard<std::mutex> lock(g_validMovesMutex);
-        m_validMoves = validMoves;
-        g_validMovesComputed = true;
-
-    });
-}
-
-std::vector<SDL_Point> Board::fastGenerateMoves(Piece* piece) const {
-    std::vector<SDL_Point> moves;
-    int fromRow = piece->getRow();
-    int fromCol = piece->getCol();
-    Color color = piece->getColor();
-    PieceType type = piece->getType();
-
-
-    if (type == PieceType::King) {
-
-        for (int dr = -1; dr <= 1; dr++) {
-            for (int dc = -1; dc <= 1; dc++) {
-                if (dr == 0 && dc == 0)
-                    continue;
-                int newRow = fromRow + dr;
-                int newCol = fromCol + dc;
-                if (newRow >= 0 && newRow < 8 && newCol >= 0 && newCol < 8) {
-
-                    Piece* destPiece = getPiece(newRow, newCol);
-                    if (!destPiece || destPiece->getColor() != color) {
-                        moves.push_back({newCol, newRow});
-                    }
-                }
-            }
-        }
-
-
-        if (!piece->hasMoved() && !isInCheck(color)) {
-
-            if (!getPiece(fromRow, fromCol + 1) && !getPiece(fromRow, fromCol + 2)) {
-                Piece* rook = getPiece(fromRow, 7);
-                if (rook && rook->getType() == PieceType::Rook && !rook->hasMoved()) {
-                    if (!isSquareUnderAttack(fromRow, fromCol + 1, color == Color::White ? Color::Black : Color::White)) {
-                        moves.push_back({fromCol + 2, fromRow});
-                    }
-                }
-            }
-
-            if (!getPiece(fromRow, fromCol - 1) && !getPiece(fromRow, fromCol - 2) && !getPiece(fromRow, fromCol - 3)) {
-                Piece* rook = getPiece(fromRow, 0);
-                if (rook && rook->getType() == PieceType::Rook && !rook->hasMoved()) {
-                    if (!isSquareUnderAttack(fromRow, fromCol - 1, color == Color::White ? Color::Black : Color::White)) {
-                        moves.push_back({fromCol - 2, fromRow});
-                    }
-                }
-            }
-        }
-    }
-    else if (type == PieceType::Pawn) {
-        int direction = (color == Color::White) ? 1 : -1;
-        int oneStep = fromRow + direction;
-        if (oneStep >= 0 && oneStep < 8) {
-
-            if (!getPiece(oneStep, fromCol))
-                moves.push_back({fromCol, oneStep});
-
-            if (!piece->hasMoved()) {
-                int twoStep = fromRow + 2 * direction;
-                if (twoStep >= 0 && twoStep < 8 && !getPiece(oneStep, fromCol) && !getPiece(twoStep, fromCol))
-                    moves.push_back({fromCol, twoStep});
-            }
-
-            for (int dc = -1; dc <= 1; dc += 2) {
-                int newCol = fromCol + dc;
-                if (newCol >= 0 && newCol < 8)
-                    moves.push_back({newCol, oneStep});
-            }
-        }
-    }
-    else if (type == PieceType::Bishop || type == PieceType::Rook || type == PieceType::Queen) {
-        std::vector<std::pair<int, int>> directions;
-        if (type == PieceType::Bishop || type == PieceType::Queen) {
-            directions.push_back({1, 1});
-            directions.push_back({-1, 1});
-            directions.push_back({-1, -1});
-            directions.push_back({1, -1});
-        }
-        if (type == PieceType::Rook || type == PieceType::Queen) {
-            directions.push_back({0, 1});
-            directions.push_back({1, 0});
-            directions.push_back({0, -1});
-            directions.push_back({-1, 0});
-        }
-        for (auto& dir : directions) {
-            int r = fromRow, c = fromCol;
-            while (true) {
-                r += dir.second;
-                c += dir.first;
-                if (r < 0 || r >= 8 || c < 0 || c >= 8)
-                    break;
-                moves.push_back({c, r});
-                if (getPiece(r, c))
-                    break;
-            }
-        }
-    }
-    else if (type == PieceType::Knight) {
-
-        const std::pair<int, int> offsets[8] = {{2, 1}, {1, 2}, {-1, 2}, {-2, 1},
-                                                {-2, -1}, {-1, -2}, {1, -2}, {2, -1}};
-        for (const auto& [dc, dr] : offsets) {
-            int newRow = fromRow + dr;
-            int newCol = fromCol + dc;
-            if (newRow >= 0 && newRow < 8 && newCol >= 0 && newCol < 8) {
-                moves.push_back({newCol, newRow});
-            }
-        }
-    }
-    return moves;
-}
-
-
-
-bool Board::hasLegalMoves(Color color) const {
-    for (int r = 0; r < 8; ++r) {
-        for (int c = 0; c < 8; ++c) {
-            Piece* piece = getPiece(r, c);
-            if (piece && piece->getColor() == color) {
-
-                std::vector<SDL_Point> candidates = fastGenerateMoves(piece);
-
-
-                for (const auto& move : candidates) {
-
-
-                    Board simulationBoard = *this;
-
-
-                     if (move.y >= 0 && move.y < 8 && move.x >= 0 && move.x < 8 &&
-                         piece->canMoveTo(move.y, move.x, *this))
-                     {
-
-                         if (simulationBoard.movePieceForSimulation(r, c, move.y, move.x)) {
-
-                             return true;
-                         }
-                     }
-                }
-            }
-        }
-    }
-
-    return false;
-}
-
-
-bool Board::isBlockingCheck(int row, int col, int kingRow, int kingCol,
-                           int attackerRow, int attackerCol) const {
-
-    int dr = attackerRow - kingRow;
-    int dc = attackerCol - kingCol;
-
-
-    if (dr != 0) dr /= abs(dr);
-    if (dc != 0) dc /= abs(dc);
-
-
-    int r = kingRow + dr;
-    int c = kingCol + dc;
-    while (r != attackerRow || c != attackerCol) {
-        if (r == row && c == col) return true;
-        r += dr;
-        c += dc;
-    }
-    return false;
-}
-Piece *Board::getPiece(int row, int col) const
-{
-    if (row >= 0 && row < 8 && col >= 0 && col < 8)
-    {
-        return m_squares[row][col];
-    }
-    return nullptr;
-}
-
-bool Board::movePiece(int fromRow, int fromCol, int toRow, int toCol)
-{
-
-    if (m_animating)
-        return false;
-
-    Piece *piece = getPiece(fromRow, fromCol);
-    if (!piece || piece->getColor() != m_currentTurn)
-    {
-
-        return false;
-    }
-
-
-
-    m_lastMovedPawn = nullptr;
-    m_enPassantCol = -1;
-
-
-    if (!piece->canMoveTo(toRow, toCol, *this))
-    {
-        return false;
-    }
-
-
-    if (piece->getType() == PieceType::King && std::abs(toCol - fromCol) == 2)
-    {
-
-        if (toCol > fromCol)
-        {
-
-            Piece *rook = getPiece(fromRow, 7);
-            m_squares[fromRow][fromCol + 1] = rook;
-            m_squares[fromRow][7] = nullptr;
-            if (rook)
-            {
-                rook->setPosition(fromRow, fromCol + 1);
-            }
-        }
-
-        else
-        {
-
-            Piece *rook = getPiece(fromRow, 0);
-            m_squares[fromRow][fromCol - 1] = rook;
-            m_squares[fromRow][0] = nullptr;
-            if (rook)
-            {
-                rook->setPosition(fromRow, fromCol - 1);
-            }
-        }
-    }
-
-
-    Piece *capturedPiece = nullptr;
-
-
-    if (piece->getType() == PieceType::Pawn && fromCol != toCol && !getPiece(toRow, toCol))
-    {
-
-        capturedPiece = getPiece(fromRow, toCol);
-        m_squares[fromRow][toCol] = nullptr;
-
-    }
-    else
-    {
-
-        capturedPiece = getPiece(toRow, toCol);
-        if (capturedPiece)
-        {
-
-
-            switch (capturedPiece->getType())
-            {
-            case PieceType::Pawn:
-
-                break;
-            case PieceType::Knight:
-
-                break;
-            case PieceType::Bishop:
-
-                break;
-            case PieceType::Rook:
-
-                break;
-            case PieceType::Queen:
-
-                break;
-            case PieceType::King:
-
-                break;
-            }
-
-        }
-    }
-
-
-    if (piece->getType() == PieceType::Pawn && std::abs(toRow - fromRow) == 2)
-    {
-        m_lastMovedPawn = piece;
-        m_enPassantCol = toCol;
-
-    }
-
-
-    m_movingPiece = piece;
-    m_animStartX = fromCol * SQUARE_SIZE;
-    m_animStartY = (7 - fromRow) * SQUARE_SIZE;
-    m_animEndX = toCol * SQUARE_SIZE;
-    m_animEndY = (7 - toRow) * SQUARE_SIZE;
-    m_animProgress = 0.0f;
-    m_animating = true;
-
-
-    m_moveFromRow = fromRow;
-    m_moveFromCol = fromCol;
-    m_moveToRow = toRow;
-    m_moveToCol = toCol;
-    m_capturedPiece = this->getPiece(toRow, toCol);
-
-    return true;
-}
+enum CastlingRight : uint8_t {
+    WhiteKingside = 1,
+    WhiteQueenside = 2,
+    BlackKingside = 4,
+    BlackQueenside = 8
+};
 
-void Board::handleClick(int x, int y)
+// Rights lost when a piece moves from or to the square
+constexpr uint8_t castlingRightsLost(int square)
 {
-    if (m_gameState == GameState::Checkmate || m_gameState == GameState::Stalemate || m_animating)
-        return;
-
-    int row, col;
-    screenToBoard(x, y, row, col);
-    if (row < 0 || row >= 8 || col < 0 || col >= 8)
-        return;
-
-    Piece* clickedPiece = getPiece(row, col);
-
-    if (!m_pieceSelected)
-    {
-        if (clickedPiece && clickedPiece->getColor() == m_currentTurn)
-        {
-            m_selectedRow = row;
-            m_selectedCol = col;
-            m_pieceSelected = true;
-            m_validMoves.clear();
-            g_validMovesComputed = false;
-
-            m_candidateMoves = fastGenerateMoves(clickedPiece);
-
-            calculateValidMovesAsync(row, col);
-        }
-    }
-    else
-    {
-
-        if (g_validMovesComputed)
-        {
-            std::lock_guard<std::mutex> lock(g_validMovesMutex);
-            for (const auto& move : m_validMoves)
-            {
-                if (move.x == col && move.y == row)
-                {
-                    if (movePiece(m_selectedRow, m_selectedCol, row, col))
-                    {
-
-                    }
-                    break;
-                }
-            }
-            m_pieceSelected = false;
-            m_selectedRow = -1;
-            m_selectedCol = -1;
-            m_validMoves.clear();
-            m_candidateMoves.clear();
-            g_validMovesComputed = false;
-        }
-        else if (clickedPiece && clickedPiece->getColor() == m_currentTurn)
-        {
-
-            m_selectedRow = row;
-            m_selectedCol = col;
-            m_validMoves.clear();
-            m_candidateMoves = fastGenerateMoves(clickedPiece);
-            g_validMovesComputed = false;
-            calculateValidMovesAsync(row, col);
-        }
-        else
-        {
-
-            m_pieceSelected = false;
-            m_selectedRow = -1;
-            m_selectedCol = -1;
-            m_validMoves.clear();
-            m_candidateMoves.clear();
-            g_validMovesComputed = false;
-        }
+    switch (square) {
+        case 0:  return WhiteQueenside;
+        case 4:  return WhiteKingside | WhiteQueenside;
+        case 7:  return WhiteKingside;
+        case 56: return BlackQueenside;
+        case 60: return BlackKingside | BlackQueenside;
+        case 63: return BlackKingside;
+        default: return 0;
     }
 }
 
-void Board::calculateValidMoves(int row, int col)
-{
-    try {
-
-        m_validMoves.clear();
-
-        Piece* piece = getPiece(row, col);
-        if (!piece)
-        {
-
-            return;
-        }
-
-
-        std::vector<SDL_Point> candidates = generateCandidateMoves(piece);
-        for (const auto &move : candidates)
-        {
-            int toCol = move.x;
-            int toRow = move.y;
-            try {
-
-                if (piece->canMoveTo(toRow, toCol, *this))
-                {
-
-                    Board simulation = *this;
-                    if (simulation.movePieceForSimulation(row, col, toRow, toCol))
-                    {
-                        m_validMoves.push_back(move);
-
-                    }
-                }
-            }
-            catch (const std::exception &e) {
-
-            }
-            catch (...) {
-
-            }
-        }
-
-    }
-    catch (const std::exception &e) {
-
-    }
-    catch (...) {
-
-    }
 }
 
-const std::vector<SDL_Point> Board::knightMoves[64] = {
-
-    {{1, 2}, {2, 1}},
-    {{2, 1}, {1, 2}, {-1, 2}},
-    {{1, 2}, {-1, 2}, {2, 1}},
-    {{1, 2}, {-1, 2}, {2, 1}},
-    {{1, 2}, {-1, 2}, {2, 1}},
-    {{1, 2}, {-1, 2}, {2, 1}},
-    {{1, 2}, {-1, 2}, {-2, 1}},
-    {{1, 2}, {-2, 1}},
-
-
-    {{1, 2}, {2, 1}, {2, -1}},
-    {{2, 1}, {1, 2}, {-1, 2}, {2, -1}, {-2, 1}},
-    {{1, 2}, {-1, 2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, 2}, {-1, 2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, 2}, {-1, 2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, 2}, {-1, 2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, 2}, {-1, 2}, {-2, 1}, {2, -1}},
-    {{1, 2}, {-2, 1}, {2, -1}},
-
-
-    {{2, 1}, {1, -2}, {2, -1}},
-    {{2, 1}, {1, -2}, {-1, -2}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {-2, 1}, {2, -1}},
-    {{1, -2}, {-2, 1}, {2, -1}},
-
-
-    {{2, 1}, {1, -2}, {2, -1}},
-    {{2, 1}, {1, -2}, {-1, -2}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {-2, 1}, {2, -1}},
-    {{1, -2}, {-2, 1}, {2, -1}},
-
-
-    {{2, 1}, {1, -2}, {2, -1}},
-    {{2, 1}, {1, -2}, {-1, -2}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {-2, 1}, {2, -1}},
-    {{1, -2}, {-2, 1}, {2, -1}},
-
-
-    {{2, 1}, {1, -2}, {2, -1}},
-    {{2, 1}, {1, -2}, {-1, -2}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, -2}, {-1, -2}, {-2, 1}, {2, -1}},
-    {{1, -2}, {-2, 1}, {2, -1}},
-
-
-    {{2, 1}, {1, 2}, {2, -1}},
-    {{2, 1}, {1, 2}, {-1, 2}, {2, -1}, {-2, 1}},
-    {{1, 2}, {-1, 2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, 2}, {-1, 2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, 2}, {-1, 2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, 2}, {-1, 2}, {2, 1}, {2, -1}, {-2, 1}},
-    {{1, 2}, {-1, 2}, {-2, 1}, {2, -1}},
-    {{1, 2}, {-2, 1}, {2, -1}},
-
-
-    {{2, 1}, {1, -2}},
-    {{2, 1}, {1, -2}, {-1, -2}},
-    {{1, -2}, {-1, -2}, {2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}},
-    {{1, -2}, {-1, -2}, {2, 1}},
-    {{1, -2}, {-1, -2}, {-2, 1}},
-    {{1, -2}, {-2, 1}},
-};
-void Board::render(SDL_Renderer* renderer, const Game& game) const
-{
-    const int BOARD_SIZE = 600;
-    const int SQUARE_SIZE = BOARD_SIZE / 8;
-
-
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            if ((row + col) % 2 == 0) {
-                SDL_SetRenderDrawColor(renderer, 240, 217, 181, 255);
-            } else {
-                SDL_SetRenderDrawColor(renderer, 181, 136, 99, 255);
-            }
-            SDL_FRect rect = {(float)(col * SQUARE_SIZE), (float)((7 - row) * SQUARE_SIZE),
-                              (float)SQUARE_SIZE, (float)SQUARE_SIZE};
-            SDL_RenderFillRect(renderer, &rect);
-        }
-    }
-
-    if (m_pieceSelected)
-    {
-        SDL_SetRenderDrawColor(renderer, 186, 202, 43, 128);
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-        SDL_FRect rect = {(float)(m_selectedCol * SQUARE_SIZE), (float)((7 - m_selectedRow) * SQUARE_SIZE),
-                          (float)SQUARE_SIZE, (float)SQUARE_SIZE};
-        SDL_RenderFillRect(renderer, &rect);
-
-        Piece* piece = getPiece(m_selectedRow, m_selectedCol);
-        if (piece)
-        {
-
-            if (!g_validMovesComputed)
-            {
-                SDL_SetRenderDrawColor(renderer, 255, 165, 0, 96);
-                for (const auto& move : m_candidateMoves)
-                {
-                    SDL_FRect moveRect = {(float)(move.x * SQUARE_SIZE), (float)((7 - move.y) * SQUARE_SIZE),
-                                          (float)SQUARE_SIZE, (float)SQUARE_SIZE};
-                    SDL_RenderFillRect(renderer, &moveRect);
-                }
-            }
+uint64_t Board::getZobristKey() const {
+    uint64_t key = 0;
 
-            if (g_validMovesComputed)
-            {
-                std::lock_guard<std::mutex> lock(g_validMovesMutex);
-                SDL_SetRenderDrawColor(renderer, 186, 202, 43, 96);
-                for (const auto& move : m_validMoves)
-                {
-                    SDL_FRect moveRect = {(float)(move.x * SQUARE_SIZE), (float)((7 - move.y) * SQUARE_SIZE),
-                                          (float)SQUARE_SIZE, (float)SQUARE_SIZE};
-                    SDL_RenderFillRect(renderer, &moveRect);
-                }
-            }
+    for (int square = 0; square < 64; square++){
+        Piece piece = m_squares[square];
+        if (piece) {
+            int colorIndex = static_cast<int>(piece.getColor());
+            int typeIndex = static_cast<int>(piece.getType());
+            key ^= zobristTable[colorIndex][typeIndex][square];
         }
     }
 
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            Piece* piece = m_squares[row][col];
-            if (piece && (!m_animating || piece != m_movingPiece)) {
-                piece->render(renderer, game, SQUARE_SIZE);
-            }
-        }
-    }
+    if(m_currentTurn == Color::White)
+        key ^= zobristSide;
+
+    if (canCastleKingside(Color::White))  key ^= zobristCastling[0];
+    if (canCastleQueenside(Color::White)) key ^= zobristCastling[1];
+    if (canCastleKingside(Color::Black))  key ^= zobristCastling[2];
+    if (canCastleQueenside(Color::Black)) key ^= zobristCastling[3];
 
-    if (m_animating && m_movingPiece) {
-        float progress = std::max(0.0f, std::min(m_animProgress, 1.0f));
-        float x = m_animStartX + (m_animEndX - m_animStartX) * progress;
-        float y = m_animStartY + (m_animEndY - m_animStartY) * progress;
-        SDL_Texture* texture = game.getPieceTexture(m_movingPiece->getType(), m_movingPiece->getColor());
-        if (texture) {
-            SDL_FRect destRect = {x, y, (float)SQUARE_SIZE, (float)SQUARE_SIZE};
-            if (x >= 0 && y >= 0 && x < BOARD_SIZE && y < BOARD_SIZE) {
-                SDL_RenderTexture(renderer, texture, nullptr, &destRect);
+    // The en passant file only matters when a pawn can actually capture there
+    if (m_enPassantCol != -1) {
+        Piece pawn = getPiece(m_enPassantRow, m_enPassantCol);
+        for (int dc = -1; dc <= 1; dc += 2) {
+            Piece neighbour = getPiece(m_enPassantRow, m_enPassantCol + dc);
+            if (neighbour && neighbour.getType() == PieceType::Pawn &&
+                neighbour.getColor() != pawn.getColor()) {
+                key ^= zobristEnPassant[m_enPassantCol];
+                break;
             }
         }
     }
+    return key;
 }
 
-void Board::updateAnimation(float deltaTime)
-{
-    if (!m_animating || !m_movingPiece)
-        return;
-
-
-    float cappedDelta = std::min(deltaTime, 0.05f);
-
-
-    float prevProgress = m_animProgress;
+bool Board::canCastleKingside(Color color) const {
+    int row = (color == Color::White) ? 0 : 7;
+    uint8_t right = (color == Color::White) ? WhiteKingside : BlackKingside;
+    return (m_castlingRights & right) &&
+           getPiece(row, 4) == Piece(PieceType::King, color) &&
+           getPiece(row, 7) == Piece(PieceType::Rook, color);
+}
 
+bool Board::canCastleQueenside(Color color) const {
+    int row = (color == Color::White) ? 0 : 7;
+    uint8_t right = (color == Color::White) ? WhiteQueenside : BlackQueenside;
+    return (m_castlingRights & right) &&
+           getPiece(row, 4) == Piece(PieceType::King, color) &&
+           getPiece(row, 0) == Piece(PieceType::Rook, color);
+}
 
-    m_animProgress += cappedDelta * 2.5f;
+bool Board::loadFEN(const std::string& fen) {
+    std::istringstream in(fen);
+    std::string placement, side, castling = "-", enPassant = "-";
+    int halfmove = 0, fullmove = 1;
+    in >> placement >> side;
+    if (placement.empty() || (side != "w" && side != "b"))
+        return false;
+    in >> castling >> enPassant >> halfmove >> fullmove;
+
+    Piece squares[64];
+    int whiteKings = 0, blackKings = 0;
+    int row = 7, col = 0;
+    bool valid = true;
+    for (char ch : placement) {
+        if (ch == '/') {
+            if (col != 8 || row == 0) { valid = false; break; }
+            --row;
+            col = 0;
+        } else if (ch >= '1' && ch <= '8') {
+            col += ch - '0';
+            if (col > 8) { valid = false; break; }
+        } else {
+            PieceType type;
+            switch (std::tolower(static_cast<unsigned char>(ch))) {
+                case 'k': type = PieceType::King; break;
+                case 'q': type = PieceType::Queen; break;
+                case 'r': type = PieceType::Rook; break;
+                case 'b': type = PieceType::Bishop; break;
+                case 'n': type = PieceType::Knight; break;
+                case 'p': type = PieceType::Pawn; break;
+                default: valid = false; break;
+            }
+            if (!valid || col >= 8) { valid = false; break; }
+            Color color = std::isupper(static_cast<unsigned char>(ch)) ? Color::White : Color::Black;
+            if (type == PieceType::King)
+                (color == Color::White ? whiteKings : blackKings)++;
+            squares[row * 8 + col] = Piece(type, color);
+            ++col;
+        }
+    }
+    if (!valid || row != 0 || col != 8 || whiteKings != 1 || blackKings != 1)
+        return false;
 
+    std::copy(std::begin(squares), std::end(squares), std::begin(m_squares));
+    for (int square = 0; square < 64; ++square) {
+        if (m_squares[square] && m_squares[square].getType() == PieceType::King)
+            updateKingPosition(m_squares[square].getColor(), square / 8, square % 8);
+    }
+
+    m_castlingRights = 0;
+    for (char ch : castling) {
+        switch (ch) {
+            case 'K': m_castlingRights |= WhiteKingside; break;
+            case 'Q': m_castlingRights |= WhiteQueenside; break;
+            case 'k': m_castlingRights |= BlackKingside; break;
+            case 'q': m_castlingRights |= BlackQueenside; break;
+        }
+    }
+    // Drop rights whose king or rook is not on its start square
+    uint8_t rights = 0;
+    if (canCastleKingside(Color::White))  rights |= WhiteKingside;
+    if (canCastleQueenside(Color::White)) rights |= WhiteQueenside;
+    if (canCastleKingside(Color::Black))  rights |= BlackKingside;
+    if (canCastleQueenside(Color::Black)) rights |= BlackQueenside;
+    m_castlingRights = rights;
+
+    m_currentTurn = (side == "w") ? Color::White : Color::Black;
+    clearEnPassantTarget();
+    if (enPassant.size() == 2 && enPassant[0] >= 'a' && enPassant[0] <= 'h') {
+        int epCol = enPassant[0] - 'a';
+        int pawnRow = (enPassant[1] == '3') ? 3 : (enPassant[1] == '6') ? 4 : -1;
+        Piece pawn = getPiece(pawnRow, epCol);
+        if (pawn && pawn.getType() == PieceType::Pawn)
+            setEnPassantTarget(pawnRow, epCol);
+    }
+
+    m_halfmoveClock = halfmove;
+    m_fullmoveNumber = fullmove;
+    return true;
+}
 
-    if (int(prevProgress * 10) != int(m_animProgress * 10)) {
 
+std::string Board::getPositionKey() const {
+    std::stringstream ss;
+    for (int square = 0; square < 64; square++){
+        Piece piece = m_squares[square];
+        if (piece) {
+            ss << static_cast<int>(piece.getType())
+               << (piece.getColor() == Color::White ? "W" : "B");
+        } else {
+            ss << "0";
+        }
+        ss << ",";
     }
+    return ss.str();
+}
 
-    if (m_animProgress >= 1.0f)
-    {
+Board::Board() : m_currentTurn(Color::White),
+                 m_whiteKingRow(0), m_whiteKingCol(4),
+                 m_blackKingRow(7), m_blackKingCol(4),
+                 m_enPassantRow(-1), m_enPassantCol(-1)
+{
+}
 
+void Board::initialize()
+{
+    static const PieceType backRank[8] = {PieceType::Rook, PieceType::Knight, PieceType::Bishop, PieceType::Queen,
+                                          PieceType::King, PieceType::Bishop, PieceType::Knight, PieceType::Rook};
 
-        try {
-            completeMoveAfterAnimation();
-        }
-        catch (const std::exception& e) {
+    std::fill(std::begin(m_squares), std::end(m_squares), Piece());
+    for (int col = 0; col < 8; col++)
+    {
+        m_squares[col] = Piece(backRank[col], Color::White);
+        m_squares[8 + col] = Piece(PieceType::Pawn, Color::White);
+        m_squares[48 + col] = Piece(PieceType::Pawn, Color::Black);
+        m_squares[56 + col] = Piece(backRank[col], Color::Black);
+    }
 
-        }
 
-        m_animProgress = 0.0f;
-        m_animating = false;
-        m_movingPiece = nullptr;
+    m_currentTurn = Color::White;
+    clearEnPassantTarget();
+    m_castlingRights = WhiteKingside | WhiteQueenside | BlackKingside | BlackQueenside;
+    m_halfmoveClock = 0;
+    m_fullmoveNumber = 1;
 
 
-    }
+    m_whiteKingRow = 0;
+    m_whiteKingCol = 4;
+    m_blackKingRow = 7;
+    m_blackKingCol = 4;
 }
 
-void Board::completeMoveAfterAnimation()
-{
-    try {
-        int fromRow = m_moveFromRow;
-        int fromCol = m_moveFromCol;
-        int toRow   = m_moveToRow;
-        int toCol   = m_moveToCol;
-
+void Board::fastGenerateMoves(int square, MoveList& moves) const {
+    Piece piece = m_squares[square];
+    int fromRow = square / 8;
+    int fromCol = square % 8;
+    Color color = piece.getColor();
+    Color enemy = (color == Color::White) ? Color::Black : Color::White;
+    PieceType type = piece.getType();
 
-        Piece* piece = m_movingPiece;
-        if (!piece) {
-
-            return;
+    // Adds a step onto an empty or enemy-occupied square with the matching flag
+    auto addStep = [&](int toRow, int toCol) {
+        Piece destPiece = m_squares[toRow * 8 + toCol];
+        if (!destPiece) {
+            moves.push_back(Move(fromRow, fromCol, toRow, toCol, MoveFlag::Quiet));
+        } else if (destPiece.getColor() != color) {
+            moves.push_back(Move(fromRow, fromCol, toRow, toCol, MoveFlag::Capture));
         }
+    };
 
 
+    if (type == PieceType::Pawn) {
+        int direction = (color == Color::White) ? 1 : -1;
+        int oneStep = fromRow + direction;
+        if (oneStep >= 0 && oneStep < 8) {
+            bool promotes = (oneStep == 0 || oneStep == 7);
 
-        if (piece->getType() == PieceType::King && std::abs(toCol - fromCol) == 2)
-        {
-
-            if (toCol > fromCol) {
-                Piece* rook = getPiece(fromRow, 7);
-                if (rook) {
+            // Pushes and captures onto the last rank expand into all four promotions
+            auto addPawnMove = [&](int toCol, int flags) {
+                if (promotes) {
+                    for (int promo = MoveFlag::KnightPromotion; promo <= MoveFlag::QueenPromotion; ++promo) {
+                        moves.push_back(Move(fromRow, fromCol, oneStep, toCol, promo | flags));
+                    }
+                } else {
+                    moves.push_back(Move(fromRow, fromCol, oneStep, toCol, flags));
+                }
+            };
 
-                    m_squares[fromRow][toCol - 1] = rook;
-                    m_squares[fromRow][7] = nullptr;
-                    rook->setPosition(fromRow, toCol - 1);
+            if (!getPiece(oneStep, fromCol)) {
+                addPawnMove(fromCol, MoveFlag::Quiet);
 
+                // Pawns only move forward, so one on its start rank has not moved
+                if (fromRow == (color == Color::White ? 1 : 6)) {
+                    int twoStep = fromRow + 2 * direction;
+                    if (!getPiece(twoStep, fromCol))
+                        moves.push_back(Move(fromRow, fromCol, twoStep, fromCol, MoveFlag::DoublePawnPush));
                 }
             }
 
-            else {
-                Piece* rook = getPiece(fromRow, 0);
-                if (rook) {
-
-                    m_squares[fromRow][toCol + 1] = rook;
-                    m_squares[fromRow][0] = nullptr;
-                    rook->setPosition(fromRow, toCol + 1);
+            for (int dc = -1; dc <= 1; dc += 2) {
+                int newCol = fromCol + dc;
+                if (newCol < 0 || newCol >= 8)
+                    continue;
 
+                Piece target = getPiece(oneStep, newCol);
+                if (target) {
+                    if (target.getColor() != color)
+                        addPawnMove(newCol, MoveFlag::Capture);
+                }
+                else if (m_enPassantCol == newCol && m_enPassantRow == fromRow &&
+                         fromRow == (color == Color::White ? 4 : 3)) {
+                    moves.push_back(Move(fromRow, fromCol, oneStep, newCol, MoveFlag::EnPassant));
                 }
             }
         }
+        return;
+    }
 
+    const PieceMovement& movement = PIECE_MOVEMENT[static_cast<int>(type)];
+    for (int d = 0; d < movement.count; ++d) {
+        int r = fromRow, c = fromCol;
+        while (true) {
+            r += movement.steps[d][0];
+            c += movement.steps[d][1];
+            if (r < 0 || r >= 8 || c < 0 || c >= 8)
+                break;
+            addStep(r, c);
+            if (!movement.slides || m_squares[r * 8 + c])
+                break;
+        }
+    }
 
+    if (type == PieceType::King && (m_castlingRights & (color == Color::White ? WhiteKingside | WhiteQueenside
+                                                                              : BlackKingside | BlackQueenside)) &&
+        !isInCheck(color)) {
 
-        piece->setPosition(toRow, toCol);
+        if (canCastleKingside(color) && !getPiece(fromRow, fromCol + 1) && !getPiece(fromRow, fromCol + 2)) {
+            if (!isSquareUnderAttack(fromRow, fromCol + 1, enemy)) {
+                moves.push_back(Move(fromRow, fromCol, fromRow, fromCol + 2, MoveFlag::KingCastle));
+            }
+        }
 
+        if (canCastleQueenside(color) && !getPiece(fromRow, fromCol - 1) && !getPiece(fromRow, fromCol - 2) &&
+            !getPiece(fromRow, fromCol - 3)) {
+            if (!isSquareUnderAttack(fromRow, fromCol - 1, enemy)) {
+                moves.push_back(Move(fromRow, fromCol, fromRow, fromCol - 2, MoveFlag::QueenCastle));
+            }
+        }
+    }
+}
 
+void Board::generateLegalMoves(Color color, MoveList& moves) const {
+    moves.clear();
 
-        if(m_capturedPiece) ;
+    // Every candidate is tried on one scratch copy; movePieceForSimulation
+    // restores the position after each test.
+    Board scratch = *this;
+    MoveList candidates;
+    for (int square = 0; square < 64; ++square) {
+        Piece piece = scratch.m_squares[square];
+        if (piece && piece.getColor() == color) {
+            scratch.fastGenerateMoves(square, candidates);
+        }
+    }
 
+    for (Move move : candidates) {
+        if (scratch.movePieceForSimulation(move.fromRow(), move.fromCol(), move.toRow(), move.toCol())) {
+            moves.push_back(move);
+        }
+    }
+}
 
-        if (m_capturedPiece) {
+bool Board::makeMove(Move move)
+{
+    int from = move.from();
+    int to = move.to();
+    int fromRow = move.fromRow();
+    int toRow = move.toRow();
+    int toCol = move.toCol();
 
+    Piece piece = m_squares[from];
+    if (!piece)
+        return false;
 
-            delete m_capturedPiece;
-            m_capturedPiece = nullptr;
-        }
+    Color color = piece.getColor();
 
+    if (piece.getType() == PieceType::Pawn || move.isCapture())
+        m_halfmoveClock = 0;
+    else
+        m_halfmoveClock++;
+    if (color == Color::Black)
+        m_fullmoveNumber++;
 
-        m_squares[toRow][toCol] = piece;
-        m_squares[fromRow][fromCol] = nullptr;
+    if (move.isCastle()) {
+        int rookFromCol = (move.flags() == MoveFlag::KingCastle) ? 7 : 0;
+        int rookToCol = (move.flags() == MoveFlag::KingCastle) ? toCol - 1 : toCol + 1;
+        m_squares[fromRow * 8 + rookToCol] = m_squares[fromRow * 8 + rookFromCol];
+        m_squares[fromRow * 8 + rookFromCol] = Piece();
+    }
 
+    if (move.isEnPassant())
+        m_squares[fromRow * 8 + toCol] = Piece();
 
+    m_squares[from] = Piece();
+    if (move.isPromotion())
+        piece = Piece(move.promotionType(), color);
+    m_squares[to] = piece;
+    m_castlingRights &= ~(castlingRightsLost(from) | castlingRightsLost(to));
 
-        if(m_squares[toRow][toCol]) {
+    if (piece.getType() == PieceType::King)
+        updateKingPosition(color, toRow, toCol);
 
+    if (move.isDoublePawnPush())
+        setEnPassantTarget(toRow, toCol);
+    else
+        clearEnPassantTarget();
 
+    m_currentTurn = (color == Color::White) ? Color::Black : Color::White;
+    return true;
+}
 
-        }
 
-        if (piece->getType() == PieceType::King) {
-            if (piece->getColor() == Color::White) {
-                m_whiteKingRow = toRow;
-                m_whiteKingCol = toCol;
-            } else {
-                m_blackKingRow = toRow;
-                m_blackKingCol = toCol;
-            }
-        }
 
+bool Board::hasLegalMoves(Color color) const {
+    Board simulationBoard = *this;
+    MoveList candidates;
+    for (int square = 0; square < 64; ++square) {
+        Piece piece = simulationBoard.m_squares[square];
+        if (piece && piece.getColor() == color) {
 
+            candidates.clear();
+            simulationBoard.fastGenerateMoves(square, candidates);
 
-        if (piece->getType() == PieceType::Pawn) {
-            if ((piece->getColor() == Color::White && toRow == 7) ||
-                (piece->getColor() == Color::Black && toRow == 0))
-            {
-                Color pawnColor = piece->getColor();
-                delete piece;
-                Piece* promoted = new Queen(pawnColor, toRow, toCol);
-                m_squares[toRow][toCol] = promoted;
+            for (Move move : candidates) {
+                if (simulationBoard.movePieceForSimulation(square / 8, square % 8, move.toRow(), move.toCol())) {
 
+                    return true;
+                }
             }
         }
+    }
 
+    return false;
+}
 
-        m_selectedRow = -1;
-        m_selectedCol = -1;
-        m_pieceSelected = false;
-        m_validMoves.clear();
-        g_validMovesComputed = false;
-
-
-        Color oldTurn = m_currentTurn;
-        m_currentTurn = (m_currentTurn == Color::White) ? Color::Black : Color::White;
 
+bool Board::isBlockingCheck(int row, int col, int kingRow, int kingCol,
+                           int attackerRow, int attackerCol) const {
 
+    int dr = attackerRow - kingRow;
+    int dc = attackerCol - kingCol;
 
-        updateLegalMoveCache(Color::White);
-        updateLegalMoveCache(Color::Black);
-        checkForPromotion();
-        updateGameState();
 
+    if (dr != 0) dr /= abs(dr);
+    if (dc != 0) dc /= abs(dc);
 
-    }
-    catch (const std::exception& e) {
 
+    int r = kingRow + dr;
+    int c = kingCol + dc;
+    while (r != attackerRow || c != attackerCol) {
+        if (r == row && c == col) return true;
+        r += dr;
+        c += dc;
     }
-    catch (...) {
-
+    return false;
+}
+Piece Board::getPiece(int row, int col) const
+{
+    if (row >= 0 && row < 8 && col >= 0 && col < 8)
+    {
+        return m_squares[row * 8 + col];
     }
+    return Piece();
 }
 
-
-
 bool Board::isInCheck(Color color) const
 {
 
@@ -1240,11 +461,8 @@ bool Board::isInCheck(Color color) const
 
 bool Board::isSquareUnderAttack(int row, int col, Color attackingColor) const
 {
-    auto start = std::chrono::high_resolution_clock::now();
-
-
-    std::vector<std::pair<int, int>> directions = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
-    for (size_t j = 0; j < directions.size(); j++)
+    static const std::pair<int, int> directions[8] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+    for (size_t j = 0; j < 8; j++)
     {
         auto [dr, dc] = directions[j];
         for (int i = 1; i < 8; i++)
@@ -1253,15 +471,15 @@ bool Board::isSquareUnderAttack(int row, int col, Color attackingColor) const
             int c = col + dc * i;
             if (r < 0 || r >= 8 || c < 0 || c >= 8)
                 break;
-            Piece* piece = getPiece(r, c);
+            Piece piece = m_squares[r * 8 + c];
             if (piece)
             {
-                if (piece->getColor() == attackingColor)
+                if (piece.getColor() == attackingColor)
                 {
-                    if ((j < 4 && piece->getType() == PieceType::Rook) ||
-                        (j >= 4 && piece->getType() == PieceType::Bishop) ||
-                        piece->getType() == PieceType::Queen ||
-                        (i == 1 && piece->getType() == PieceType::King))
+                    if ((j < 4 && piece.getType() == PieceType::Rook) ||
+                        (j >= 4 && piece.getType() == PieceType::Bishop) ||
+                        piece.getType() == PieceType::Queen ||
+                        (i == 1 && piece.getType() == PieceType::King))
                         return true;
                 }
                 break;
@@ -1270,123 +488,137 @@ bool Board::isSquareUnderAttack(int row, int col, Color attackingColor) const
     }
 
 
-    std::vector<std::pair<int, int>> knightMoves = {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}};
-    for (const auto& [dr, dc] : knightMoves)
+    int square = row * 8 + col;
+    uint64_t knights = Attacks::knight(square);
+    while (knights)
     {
-        int r = row + dr;
-        int c = col + dc;
-        if (r >= 0 && r < 8 && c >= 0 && c < 8)
-        {
-            Piece* piece = getPiece(r, c);
-            if (piece && piece->getColor() == attackingColor && piece->getType() == PieceType::Knight)
-                return true;
-        }
+        int from = Attacks::popLsb(knights);
+        if (m_squares[from] == Piece(PieceType::Knight, attackingColor))
+            return true;
     }
 
 
-    int pawnDir = (attackingColor == Color::White) ? -1 : 1;
-    for (int dc : {-1, 1})
+    // A pawn attacks this square if it stands where a defending pawn here would attack
+    Color defendingColor = (attackingColor == Color::White) ? Color::Black : Color::White;
+    uint64_t pawns = Attacks::pawn(defendingColor, square);
+    while (pawns)
     {
-        int r = row + pawnDir;
-        int c = col + dc;
-        if (r >= 0 && r < 8 && c >= 0 && c < 8)
-        {
-            Piece* piece = getPiece(r, c);
-            if (piece && piece->getColor() == attackingColor && piece->getType() == PieceType::Pawn)
-                return true;
-        }
+        int from = Attacks::popLsb(pawns);
+        if (m_squares[from] == Piece(PieceType::Pawn, attackingColor))
+            return true;
     }
 
-    auto end = std::chrono::high_resolution_clock::now();
-
     return false;
 }
 
 
-std::vector<SDL_Point> Board::generateCandidateMoves(Piece* piece) const {
-    std::vector<SDL_Point> moves;
-    int fromRow = piece->getRow();
-    int fromCol = piece->getCol();
-    Color color = piece->getColor();
-    PieceType type = piece->getType();
-
-    if(type == PieceType::Pawn) {
-        int direction = (color == Color::White) ? 1 : -1;
-        int oneStep = fromRow + direction;
-
-        if(getPiece(oneStep, fromCol) == nullptr) {
-            moves.push_back({fromCol, oneStep});
-
-            if(!piece->hasMoved()) {
-                int twoStep = fromRow + 2 * direction;
-                if(getPiece(oneStep, fromCol) == nullptr && getPiece(twoStep, fromCol) == nullptr)
-                    moves.push_back({fromCol, twoStep});
-            }
-        }
-
-        for (int dc = -1; dc <= 1; dc += 2) {
-            int capCol = fromCol + dc;
-            if(capCol >= 0 && capCol < 8) {
-                moves.push_back({capCol, oneStep});
-            }
-        }
-
-    }
-    else if(type == PieceType::Knight) {
-        const int offsets[8][2] = { {2,1}, {1,2}, {-1,2}, {-2,1},
-                                    {-2,-1}, {-1,-2}, {1,-2}, {2,-1} };
-        for (auto& offset : offsets) {
-            int r = fromRow + offset[1];
-            int c = fromCol + offset[0];
-            if(r >= 0 && r < 8 && c >= 0 && c < 8) {
-                moves.push_back({c, r});
-            }
+Bitboards Board::getBitboards() const
+{
+    Bitboards bitboards = {};
+    for (int square = 0; square < 64; ++square) {
+        Piece piece = m_squares[square];
+        if (piece) {
+            int color = static_cast<int>(piece.getColor());
+            bitboards.pieces[color][static_cast<int>(piece.getType())] |= Attacks::squareBit(square);
+            bitboards.colors[color] |= Attacks::squareBit(square);
         }
     }
+    bitboards.occupied = bitboards.colors[0] | bitboards.colors[1];
+    return bitboards;
+}
 
-    else if(type == PieceType::Bishop || type == PieceType::Rook || type == PieceType::Queen) {
-        std::vector<std::pair<int,int>> directions;
-        if(type == PieceType::Bishop || type == PieceType::Queen) {
-            directions.push_back({1,1});
-            directions.push_back({-1,1});
-            directions.push_back({-1,-1});
-            directions.push_back({1,-1});
-        }
-        if(type == PieceType::Rook || type == PieceType::Queen) {
-            directions.push_back({0,1});
-            directions.push_back({1,0});
-            directions.push_back({0,-1});
-            directions.push_back({-1,0});
-        }
-        for(auto& dir : directions) {
-            int r = fromRow, c = fromCol;
-            while(true) {
-                r += dir.second;
-                c += dir.first;
-                if(r < 0 || r >= 8 || c < 0 || c >= 8)
-                    break;
-                moves.push_back({c, r});
+uint64_t Board::attackersTo(int square, uint64_t occupied, const Bitboards& bitboards) const
+{
+    const int W = static_cast<int>(Color::White);
+    const int B = static_cast<int>(Color::Black);
+    auto both = [&](PieceType type) {
+        return bitboards.pieces[W][static_cast<int>(type)] | bitboards.pieces[B][static_cast<int>(type)];
+    };
+
+    uint64_t queens = both(PieceType::Queen);
+    return (Attacks::pawn(Color::Black, square) & bitboards.pieces[W][static_cast<int>(PieceType::Pawn)])
+         | (Attacks::pawn(Color::White, square) & bitboards.pieces[B][static_cast<int>(PieceType::Pawn)])
+         | (Attacks::knight(square) & both(PieceType::Knight))
+         | (Attacks::king(square) & both(PieceType::King))
+         | (Attacks::bishop(square, occupied) & (both(PieceType::Bishop) | queens))
+         | (Attacks::rook(square, occupied) & (both(PieceType::Rook) | queens));
+}
+
+int Board::staticExchange(Move move) const
+{
+    return staticExchange(move, getBitboards());
+}
 
-                if(getPiece(r,c) != nullptr)
-                    break;
+int Board::staticExchange(Move move, const Bitboards& bitboards) const
+{
+    // Exchange values, indexed by PieceType
+    static const int values[6] = {20000, 900, 500, 310, 300, 100};
+
+    int from = move.from();
+    int to = move.to();
+    Piece mover = m_squares[from];
+    if (!mover)
+        return 0;
+
+    uint64_t occupied = bitboards.occupied;
+    int gain[32];
+    int depth = 0;
+
+    if (move.isEnPassant()) {
+        gain[0] = values[static_cast<int>(PieceType::Pawn)];
+        occupied ^= Attacks::squareBit(from / 8 * 8 + to % 8);
+    } else {
+        Piece victim = m_squares[to];
+        gain[0] = victim ? values[static_cast<int>(victim.getType())] : 0;
+    }
+
+    int attackerValue = values[static_cast<int>(mover.getType())];
+    if (move.isPromotion()) {
+        int promoted = values[static_cast<int>(move.promotionType())];
+        gain[0] += promoted - values[static_cast<int>(PieceType::Pawn)];
+        attackerValue = promoted;
+    }
+
+    // Sliders that can join the exchange once the pieces in front of them move
+    uint64_t diagonalSliders = bitboards.pieces[0][static_cast<int>(PieceType::Bishop)] | bitboards.pieces[1][static_cast<int>(PieceType::Bishop)] |
+                               bitboards.pieces[0][static_cast<int>(PieceType::Queen)] | bitboards.pieces[1][static_cast<int>(PieceType::Queen)];
+    uint64_t straightSliders = bitboards.pieces[0][static_cast<int>(PieceType::Rook)] | bitboards.pieces[1][static_cast<int>(PieceType::Rook)] |
+                               bitboards.pieces[0][static_cast<int>(PieceType::Queen)] | bitboards.pieces[1][static_cast<int>(PieceType::Queen)];
+
+    uint64_t fromBit = Attacks::squareBit(from);
+    uint64_t attackers = attackersTo(to, occupied, bitboards);
+    int side = static_cast<int>(mover.getColor());
+
+    while (fromBit && depth < 31) {
+        ++depth;
+        // Speculative score if the piece now on the square gets captured
+        gain[depth] = attackerValue - gain[depth - 1];
+
+        occupied ^= fromBit;
+        attackers &= occupied;
+        attackers |= (Attacks::bishop(to, occupied) & diagonalSliders & occupied) |
+                     (Attacks::rook(to, occupied) & straightSliders & occupied);
+
+        // Next capture comes from the least valuable attacker of the other side
+        side ^= 1;
+        fromBit = 0;
+        uint64_t ours = attackers & bitboards.colors[side];
+        for (int type = static_cast<int>(PieceType::Pawn); type >= 0 && ours; --type) {
+            uint64_t candidates = ours & bitboards.pieces[side][type];
+            if (candidates) {
+                fromBit = candidates & (0 - candidates);
+                attackerValue = values[type];
+                break;
             }
         }
     }
 
-    else if(type == PieceType::King) {
-        for (int dr = -1; dr <= 1; ++dr) {
-            for (int dc = -1; dc <= 1; ++dc) {
-                if(dr == 0 && dc == 0)
-                    continue;
-                int r = fromRow + dr;
-                int c = fromCol + dc;
-                if(r >= 0 && r < 8 && c >= 0 && c < 8)
-                    moves.push_back({c, r});
-            }
-        }
-    }
-    return moves;
+    while (--depth > 0)
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+
+    return gain[0];
 }
+
 bool Board::isCheckmate() const {
 
     return isInCheck(m_currentTurn) && !hasLegalMoves(m_currentTurn);
@@ -1399,53 +631,45 @@ bool Board::isStalemate() const {
 
 bool Board::movePieceForSimulation(int fromRow, int fromCol, int toRow, int toCol)
 {
-    Piece* piece = getPiece(fromRow, fromCol);
+    int from = fromRow * 8 + fromCol;
+    int to = toRow * 8 + toCol;
+    Piece piece = m_squares[from];
     if (!piece) {
 
         return false;
     }
-    Color movingColor = piece->getColor();
+    Color movingColor = piece.getColor();
 
 
-    Piece* captured = getPiece(toRow, toCol);
+    Piece captured = m_squares[to];
     int oldWhiteKingRow = m_whiteKingRow, oldWhiteKingCol = m_whiteKingCol;
     int oldBlackKingRow = m_blackKingRow, oldBlackKingCol = m_blackKingCol;
-    Piece* oldLastMovedPawn = m_lastMovedPawn;
+    int oldEnPassantRow = m_enPassantRow;
     int oldEnPassantCol = m_enPassantCol;
-    bool pieceHadMoved = piece->hasMoved();
 
 
-    Piece* enPassantVictim = nullptr;
-    int epVictimRow = -1, epVictimCol = -1;
+    Piece enPassantVictim;
+    int epVictim = fromRow * 8 + toCol;
 
 
-    if (piece->getType() == PieceType::Pawn && fromCol != toCol && !captured) {
-        epVictimRow = fromRow;
-        epVictimCol = toCol;
-        enPassantVictim = m_squares[epVictimRow][epVictimCol];
-        if (!enPassantVictim || enPassantVictim->getType() != PieceType::Pawn) {
-
-             enPassantVictim = nullptr;
-        } else {
-             m_squares[epVictimRow][epVictimCol] = nullptr;
+    if (piece.getType() == PieceType::Pawn && fromCol != toCol && !captured) {
+        if (m_squares[epVictim] && m_squares[epVictim].getType() == PieceType::Pawn) {
+             enPassantVictim = m_squares[epVictim];
+             m_squares[epVictim] = Piece();
         }
     }
 
 
-    m_squares[toRow][toCol] = piece;
-    m_squares[fromRow][fromCol] = nullptr;
-
-
+    m_squares[to] = piece;
+    m_squares[from] = Piece();
 
-    piece->setPosition(toRow, toCol);
 
-
-    if (piece->getType() == PieceType::King) {
+    if (piece.getType() == PieceType::King) {
         updateKingPosition(movingColor, toRow, toCol);
     }
 
-    if (piece->getType() == PieceType::Pawn && std::abs(toRow - fromRow) == 2) {
-        setEnPassantTarget(piece, toCol);
+    if (piece.getType() == PieceType::Pawn && std::abs(toRow - fromRow) == 2) {
+        setEnPassantTarget(toRow, toCol);
     } else {
         clearEnPassantTarget();
     }
@@ -1454,21 +678,16 @@ bool Board::movePieceForSimulation(int fromRow, int fromCol, int toRow, int toCo
     bool isMoveLegal = !isInCheck(movingColor);
 
 
-    piece->m_row = fromRow;
-    piece->m_col = fromCol;
-    piece->m_hasMoved = pieceHadMoved;
-
-
-    m_squares[fromRow][fromCol] = piece;
-    m_squares[toRow][toCol] = captured;
+    m_squares[from] = piece;
+    m_squares[to] = captured;
     if (enPassantVictim) {
-        m_squares[epVictimRow][epVictimCol] = enPassantVictim;
+        m_squares[epVictim] = enPassantVictim;
     }
 
 
     m_whiteKingRow = oldWhiteKingRow; m_whiteKingCol = oldWhiteKingCol;
     m_blackKingRow = oldBlackKingRow; m_blackKingCol = oldBlackKingCol;
-    m_lastMovedPawn = oldLastMovedPawn;
+    m_enPassantRow = oldEnPassantRow;
     m_enPassantCol = oldEnPassantCol;
 
     return isMoveLegal;
@@ -1476,62 +695,7 @@ bool Board::movePieceForSimulation(int fromRow, int fromCol, int toRow, int toCo
 
 
 
-
-
-
-
-
-
-
-
-
-void Board::updateGameState()
-{
-    try {
-        bool inCheck = isInCheck(m_currentTurn);
-
-
-        updateLegalMoveCache(m_currentTurn);
-        bool hasLegalMovesCached = hasLegalMoves(m_currentTurn);
-
-        if (inCheck) {
-            if (!hasLegalMovesCached) {
-                m_gameState = GameState::Checkmate;
-                std::string winner = (m_currentTurn == Color::White) ? "Black" : "White";
-
-            } else {
-                m_gameState = GameState::Check;
-
-            }
-        } else {
-            if (!hasLegalMovesCached) {
-                m_gameState = GameState::Stalemate;
-
-            } else {
-                m_gameState = GameState::Active;
-            }
-        }
-    } catch (const std::exception& e) {
-
-        m_gameState = GameState::Active;
-    } catch (...) {
-
-        m_gameState = GameState::Active;
-    }
-}
-
-void Board::screenToBoard(int screenX, int screenY, int &boardRow, int &boardCol) const
-{
-    const int BOARD_SIZE = 600;
-    const int SQUARE_SIZE = BOARD_SIZE / 8;
-
-
-    boardCol = screenX / SQUARE_SIZE;
-    boardRow = 7 - (screenY / SQUARE_SIZE);
-}
-
-
-void Board::placePiece(Piece *piece, int row, int col)
+void Board::placePiece(Piece piece, int row, int col)
 {
 
     if (row < 0 || row >= 8 || col < 0 || col >= 8) {
@@ -1539,99 +703,27 @@ void Board::placePiece(Piece *piece, int row, int col)
         return;
     }
 
-    Piece* existingPiece = m_squares[row][col];
-    PieceType incomingType = piece ? piece->getType() : PieceType::King;
-    Color incomingColor = piece ? piece->getColor() : Color::White;
-
-
-
-
-
-    if(piece) { ; }
-    else { ; }
-    ;
-
-
-    if (existingPiece != nullptr) {
-
-
-        if (existingPiece == piece) {
-
-        } else {
-
-            delete existingPiece;
-            m_squares[row][col] = nullptr;
-        }
-    } else {
-
-    }
-
-
-    m_squares[row][col] = piece;
-
-
-    if (piece)
-    {
-
-        if (piece->getRow() != row || piece->getCol() != col) {
-
-            piece->setPosition(row, col);
-        } else {
-
-
-
-             if (!piece->hasMoved()) {
-
-                  piece->m_hasMoved = true;
-             }
-        }
-    } else {
-
-    }
-
+    // A piece put on a corner or king square takes away the castling right
+    m_squares[row * 8 + col] = piece;
+    m_castlingRights &= ~castlingRightsLost(row * 8 + col);
 }
 
-void Board::setSquare(int r, int c, Piece* p) {
+void Board::setSquare(int r, int c, Piece p) {
     if (r >= 0 && r < 8 && c >= 0 && c < 8) {
 
 
-        m_squares[r][c] = p;
+        m_squares[r * 8 + c] = p;
     } else {
 
     }
 }
 
 
-Piece* Board::getLastMovedPawn() const {
-    return m_lastMovedPawn;
-}
-
 int Board::getEnPassantCol() const {
     return m_enPassantCol;
 }
 
 
-void Board::checkForPromotion()
-{
-
-
-    for (int col = 0; col < 8; ++col) {
-        Piece* whitePawn = getPiece(7, col);
-        if (whitePawn && whitePawn->getType() == PieceType::Pawn && whitePawn->getColor() == Color::White) {
-            delete whitePawn;
-            placePiece(new Queen(Color::White, 7, col), 7, col);
-
-        }
-        Piece* blackPawn = getPiece(0, col);
-        if (blackPawn && blackPawn->getType() == PieceType::Pawn && blackPawn->getColor() == Color::Black) {
-            delete blackPawn;
-            placePiece(new Queen(Color::Black, 0, col), 0, col);
-
-        }
-    }
-}
-
-
 std::vector<std::tuple<int, int, int, int>> Board::getPins(Color color) const {
     std::vector<std::tuple<int, int, int, int>> pins;
     int kingRow = (color == Color::White) ? m_whiteKingRow : m_blackKingRow;
@@ -1645,20 +737,20 @@ std::vector<std::tuple<int, int, int, int>> Board::getPins(Color color) const {
             int c = kingCol + dc * i;
             if (r < 0 || r >= 8 || c < 0 || c >= 8)
                 break;
-            Piece* piece = getPiece(r, c);
+            Piece piece = getPiece(r, c);
             if (piece) {
-                if (piece->getColor() == color && piece->getType() != PieceType::King) {
+                if (piece.getColor() == color && piece.getType() != PieceType::King) {
                     if (possiblePinRow == -1) {
                         possiblePinRow = r;
                         possiblePinCol = c;
                     } else {
                         break;
                     }
-                } else if (piece->getColor() != color) {
+                } else if (piece.getColor() != color) {
                     if (possiblePinRow != -1 && (
-                        (dr == 0 || dc == 0) && piece->getType() == PieceType::Rook ||
-                        (dr != 0 && dc != 0) && piece->getType() == PieceType::Bishop ||
-                        piece->getType() == PieceType::Queen)) {
+                        ((dr == 0 || dc == 0) && piece.getType() == PieceType::Rook) ||
+                        (dr != 0 && dc != 0 && piece.getType() == PieceType::Bishop) ||
+                        piece.getType() == PieceType::Queen)) {
                         pins.push_back({possiblePinRow, possiblePinCol, dr, dc});
                     }
                     break;
@@ -1682,12 +774,12 @@ std::vector<std::tuple<int, int, int, int>> Board::getChecks(Color color) const
             int c = kingCol + dc * i;
             if (r < 0 || r >= 8 || c < 0 || c >= 8)
                 break;
-            Piece* piece = getPiece(r, c);
-            if (piece && piece->getColor() != color) {
-                if (((dr == 0 || dc == 0) && piece->getType() == PieceType::Rook) ||
-                    (dr != 0 && dc != 0 && piece->getType() == PieceType::Bishop) ||
-                    piece->getType() == PieceType::Queen ||
-                    (i == 1 && piece->getType() == PieceType::King)) {
+            Piece piece = getPiece(r, c);
+            if (piece && piece.getColor() != color) {
+                if (((dr == 0 || dc == 0) && piece.getType() == PieceType::Rook) ||
+                    (dr != 0 && dc != 0 && piece.getType() == PieceType::Bishop) ||
+                    piece.getType() == PieceType::Queen ||
+                    (i == 1 && piece.getType() == PieceType::King)) {
                     checks.push_back({r, c, dr, dc});
                 }
                 break;
@@ -1701,8 +793,8 @@ std::vector<std::tuple<int, int, int, int>> Board::getChecks(Color color) const
         int r = kingRow + dr;
         int c = kingCol + dc;
         if (r >= 0 && r < 8 && c >= 0 && c < 8) {
-            Piece* piece = getPiece(r, c);
-            if (piece && piece->getColor() != color && piece->getType() == PieceType::Knight) {
+            Piece piece = getPiece(r, c);
+            if (piece && piece.getColor() != color && piece.getType() == PieceType::Knight) {
                 checks.push_back({r, c, dr, dc});
             }
         }
@@ -1729,12 +821,12 @@ void Board::updateKingPosition(Color color, int row, int col) {
     }
 }
 
-void Board::setEnPassantTarget(Piece* pawn, int col) {
-    m_lastMovedPawn = pawn;
+void Board::setEnPassantTarget(int row, int col) {
+    m_enPassantRow = row;
     m_enPassantCol = col;
 }
 
 void Board::clearEnPassantTarget() {
-    m_lastMovedPawn = nullptr;
+    m_enPassantRow = -1;
     m_enPassantCol = -1;
 }
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "BoardCompositor.h"
+#include "Board.h"
+#include "BoardView.h"
+#include "PieceAtlas.h"
+#include <iostream>
+
+BoardCompositor::~BoardCompositor()
+{
+    releaseTextures();
+}
+
+void BoardCompositor::setTheme(const BoardTheme& theme)
+{
+    m_theme = theme;
+    invalidate(StaticBoard);
+    invalidate(Highlights);
+}
+
+void BoardCompositor::setLayout(const BoardLayout& layout)
+{
+    if (layout == m_layout)
+        return;
+    if (layout.squareSize != m_layout.squareSize)
+        releaseTextures();
+    m_layout = layout;
+    invalidateAll();
+}
+
+void BoardCompositor::invalidateAll()
+{
+    for (int layer = 0; layer < LayerCount; layer++)
+        m_dirty[layer] = true;
+}
+
+void BoardCompositor::releaseTextures()
+{
+    if (m_staticLayer)
+    {
+        SDL_DestroyTexture(m_staticLayer);
+        m_staticLayer = nullptr;
+    }
+    m_dirty[StaticBoard] = true;
+}
+
+bool BoardCompositor::buildStaticLayer(SDL_Renderer* renderer)
+{
+    if (!m_staticLayer)
+    {
+        m_staticLayer = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                                          m_layout.boardSize(), m_layout.boardSize());
+        if (!m_staticLayer)
+        {
+            std::cerr << "Failed to create board layer: " << SDL_GetError() << std::endl;
+            return false;
+        }
+    }
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, m_staticLayer);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    const int squareSize = m_layout.squareSize;
+    for (int row = 0; row < 8; row++)
+    {
+        for (int col = 0; col < 8; col++)
+        {
+            const SDL_Color& color = ((row + col) % 2 == 0) ? m_theme.lightSquare : m_theme.darkSquare;
+            SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+            SDL_FRect rect = {(float)(col * squareSize), (float)((7 - row) * squareSize),
+                              (float)squareSize, (float)squareSize};
+            SDL_RenderFillRect(renderer, &rect);
+        }
+    }
+
+    SDL_SetRenderTarget(renderer, previousTarget);
+    m_dirty[StaticBoard] = false;
+    return true;
+}
+
+void BoardCompositor::draw(SDL_Renderer* renderer, const Board& board, const BoardView& view)
+{
+    uint64_t positionKey = board.getZobristKey();
+    int selectedSquare = view.getSelectedSquare();
+    bool animating = view.isAnimating();
+
+    if (positionKey != m_positionKey || selectedSquare != m_selectedSquare)
+    {
+        m_dirty[Highlights] = true;
+    }
+    // The moving piece changes every frame, and once more when it lands
+    if (positionKey != m_positionKey || animating || m_wasAnimating)
+    {
+        m_dirty[Pieces] = true;
+    }
+    m_positionKey = positionKey;
+    m_selectedSquare = selectedSquare;
+    m_wasAnimating = animating;
+
+    // Texture coordinates are relative to the atlas size, which follows the square size
+    if (m_atlas && (m_atlas->texture() != m_atlasTexture || m_atlas->cellSize() != m_atlasCellSize))
+    {
+        m_atlasTexture = m_atlas->texture();
+        m_atlasCellSize = m_atlas->cellSize();
+        for (RenderBatch* batch : {&m_highlights, &m_pieces})
+        {
+            batch->setTexture(m_atlasTexture, m_atlas->width(), m_atlas->height(), m_atlas->solidX(), m_atlas->solidY());
+        }
+        m_dirty[Highlights] = true;
+        m_dirty[Pieces] = true;
+    }
+
+    if (m_dirty[Highlights])
+    {
+        m_highlights.clear();
+        view.renderHighlights(m_highlights, m_theme, m_layout);
+        m_dirty[Highlights] = false;
+    }
+    if (m_dirty[Pieces] && m_atlas)
+    {
+        m_pieces.clear();
+        view.renderPieces(m_pieces, board, *m_atlas, m_layout);
+        m_dirty[Pieces] = false;
+    }
+
+    if (m_dirty[StaticBoard])
+    {
+        buildStaticLayer(renderer);
+    }
+    if (m_staticLayer)
+    {
+        SDL_FRect dest = {(float)m_layout.originX, (float)m_layout.originY,
+                          (float)m_layout.boardSize(), (float)m_layout.boardSize()};
+        SDL_RenderTexture(renderer, m_staticLayer, nullptr, &dest);
+    }
+    m_highlights.draw(renderer);
+    m_pieces.draw(renderer);
+}
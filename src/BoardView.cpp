@@ -0,0 +1,120 @@
+#include "BoardView.h"
+#include "Board.h"
+#include "BoardCompositor.h"
+#include "PieceAtlas.h"
+#include "Attacks.h"
+#include "Trace.h"
+#include <algorithm>
+
+void BoardView::refreshLegalTargets(const Board& board)
+{
+    TRACE_ZONE("BoardView::refreshLegalTargets");
+    std::fill(std::begin(m_legalTargets), std::end(m_legalTargets), 0);
+    m_selectedSquare = -1;
+
+    MoveList moves;
+    board.generateLegalMoves(board.getCurrentTurn(), moves);
+    for (Move move : moves)
+        m_legalTargets[move.from()] |= 1ULL << move.to();
+}
+
+void BoardView::handleClick(const Board& board, int x, int y, const BoardLayout& layout)
+{
+    if (m_animating)
+        return;
+
+    int row, col;
+    if (!layout.screenToSquare(x, y, row, col))
+        return;
+
+    int square = row * 8 + col;
+    Piece clickedPiece = board.getPiece(square);
+
+    if (isPieceSelected() && (m_legalTargets[m_selectedSquare] & (1ULL << square)))
+    {
+        movePiece(board, m_selectedSquare / 8, m_selectedSquare % 8, row, col);
+        m_selectedSquare = -1;
+    }
+    else if (clickedPiece && clickedPiece.getColor() == board.getCurrentTurn())
+    {
+        m_selectedSquare = square;
+    }
+    else
+    {
+        m_selectedSquare = -1;
+    }
+}
+
+bool BoardView::movePiece(const Board& board, int fromRow, int fromCol, int toRow, int toCol, PieceType promotion)
+{
+    if (m_animating)
+        return false;
+
+    MoveList moves;
+    board.generateLegalMoves(board.getCurrentTurn(), moves);
+    auto match = std::find_if(moves.begin(), moves.end(), [&](Move move) {
+        return move.from() == fromRow * 8 + fromCol && move.to() == toRow * 8 + toCol &&
+               (!move.isPromotion() || move.promotionType() == promotion);
+    });
+    if (match == moves.end())
+        return false;
+
+    m_pendingMove = *match;
+    m_movingPiece = board.getPiece(fromRow, fromCol);
+    m_animProgress = 0.0f;
+    m_animating = true;
+    return true;
+}
+
+void BoardView::updateAnimation(Board& board, float deltaTime)
+{
+    TRACE_ZONE("BoardView::updateAnimation");
+    if (!m_animating)
+        return;
+
+    m_animProgress += std::min(deltaTime, 0.05f) * 2.5f;
+    if (m_animProgress >= 1.0f)
+    {
+        board.makeMove(m_pendingMove);
+        m_pendingMove = Move::none();
+        m_movingPiece = Piece();
+        m_animProgress = 0.0f;
+        m_animating = false;
+        m_selectedSquare = -1;
+    }
+}
+
+void BoardView::renderHighlights(RenderBatch& batch, const BoardTheme& theme, const BoardLayout& layout) const
+{
+    if (!isPieceSelected())
+        return;
+
+    batch.addFilledRect(layout.squareRect(m_selectedSquare / 8, m_selectedSquare % 8), theme.selectedSquare);
+
+    uint64_t targets = m_legalTargets[m_selectedSquare];
+    while (targets)
+    {
+        int to = Attacks::popLsb(targets);
+        batch.addFilledRect(layout.squareRect(to / 8, to % 8), theme.targetSquare);
+    }
+}
+
+void BoardView::renderPieces(RenderBatch& batch, const Board& board, const PieceAtlas& atlas, const BoardLayout& layout) const
+{
+    int hidden = m_animating ? m_pendingMove.from() : -1;
+    for (int square = 0; square < 64; square++)
+    {
+        Piece piece = board.getPiece(square);
+        if (piece && square != hidden)
+            batch.addTexturedRect(layout.squareRect(square / 8, square % 8), atlas.rect(piece.getType(), piece.getColor()));
+    }
+
+    if (m_animating)
+    {
+        // Squares from the board's top-left corner, as BoardLayout::rectAt takes them
+        float progress = std::min(m_animProgress, 1.0f);
+        float x = m_pendingMove.fromCol() + (m_pendingMove.toCol() - m_pendingMove.fromCol()) * progress;
+        float y = (7 - m_pendingMove.fromRow()) + (m_pendingMove.fromRow() - m_pendingMove.toRow()) * progress;
+        batch.addTexturedRect(layout.rectAt(x, y), atlas.rect(m_movingPiece.getType(), m_movingPiece.getColor()));
+    }
+}
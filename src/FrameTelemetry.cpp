@@ -0,0 +1,135 @@
+#include "FrameTelemetry.h"
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+
+void LatencyHistogram::record(double ms)
+{
+    ms = std::max(ms, 0.0);
+    if (ms >= bucketStartMs(BUCKET_COUNT))
+        m_overflow++;
+    else if (ms < FINE_BUCKETS * FINE_MS)
+        m_buckets[std::min(static_cast<int>(ms / FINE_MS), FINE_BUCKETS - 1)]++;
+    else
+        m_buckets[std::min(FINE_BUCKETS + static_cast<int>((ms - FINE_BUCKETS * FINE_MS) / COARSE_MS), BUCKET_COUNT - 1)]++;
+    m_count++;
+    m_totalMs += ms;
+    m_maxMs = std::max(m_maxMs, ms);
+}
+
+double LatencyHistogram::percentileMs(double fraction) const
+{
+    if (m_count == 0)
+        return 0.0;
+
+    uint64_t target = static_cast<uint64_t>(fraction * m_count);
+    if (target == 0)
+        target = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++)
+    {
+        seen += m_buckets[i];
+        if (seen >= target)
+            return std::min(bucketEndMs(i), m_maxMs);
+    }
+    return m_maxMs;
+}
+
+const char* FrameTelemetry::metricName(Metric metric)
+{
+    switch (metric)
+    {
+    case Frame: return "frame";
+    case Update: return "update";
+    case Render: return "render";
+    case AiWait: return "ai_wait";
+    case ClickToHighlight: return "click_to_highlight";
+    default: return "unknown";
+    }
+}
+
+void FrameTelemetry::writeCsv(std::ostream& out) const
+{
+    out << "metric,bucket_start_ms,bucket_end_ms,count\n";
+    for (int m = 0; m < MetricCount; m++)
+    {
+        const LatencyHistogram& histogram = m_histograms[m];
+        const char* name = metricName(static_cast<Metric>(m));
+        for (int i = 0; i < LatencyHistogram::BUCKET_COUNT; i++)
+        {
+            if (histogram.bucket(i))
+            {
+                out << name << ',' << LatencyHistogram::bucketStartMs(i) << ','
+                    << LatencyHistogram::bucketEndMs(i) << ',' << histogram.bucket(i) << '\n';
+            }
+        }
+        if (histogram.overflow())
+        {
+            out << name << ',' << LatencyHistogram::bucketStartMs(LatencyHistogram::BUCKET_COUNT) << ",,"
+                << histogram.overflow() << '\n';
+        }
+    }
+}
+
+void FrameTelemetry::writeSummary(std::ostream& out) const
+{
+    out << std::left << std::setw(20) << "metric" << std::right << std::setw(9) << "samples"
+        << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p95"
+        << std::setw(10) << "p99" << std::setw(10) << "max" << "  (ms)\n";
+    out << std::fixed << std::setprecision(2);
+    for (int m = 0; m < MetricCount; m++)
+    {
+        const LatencyHistogram& histogram = m_histograms[m];
+        out << std::left << std::setw(20) << metricName(static_cast<Metric>(m)) << std::right
+            << std::setw(9) << histogram.count() << std::setw(10) << histogram.meanMs()
+            << std::setw(10) << histogram.percentileMs(0.50) << std::setw(10) << histogram.percentileMs(0.95)
+            << std::setw(10) << histogram.percentileMs(0.99) << std::setw(10) << histogram.maxMs() << '\n';
+    }
+    out << std::defaultfloat;
+}
+
+void FrameTelemetry::drawOverlay(SDL_Renderer* renderer, float x, float y) const
+{
+    const float ROW_HEIGHT = 24.0f;
+    const float BAR_WIDTH = 240.0f;
+    const double SCALE_MS = 1000.0 / 30.0;      // full bar width
+    const double BUDGET_MS = 1000.0 / 60.0;
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 170);
+    SDL_FRect background = {x, y, BAR_WIDTH + 16.0f, ROW_HEIGHT * MetricCount + 8.0f};
+    SDL_RenderFillRect(renderer, &background);
+
+    const double fractions[3] = {0.50, 0.95, 0.99};
+    const SDL_Color colors[3] = {{80, 200, 120, 255}, {240, 200, 60, 255}, {230, 70, 60, 255}};
+    for (int m = 0; m < MetricCount; m++)
+    {
+        const LatencyHistogram& histogram = m_histograms[m];
+        float rowY = y + 4.0f + m * ROW_HEIGHT;
+        double values[3];
+        for (int i = 0; i < 3; i++)
+            values[i] = histogram.percentileMs(fractions[i]);
+
+#ifndef USE_SDL2
+        // SDL2 has no debug text; the bars alone are drawn there
+        char label[96];
+        std::snprintf(label, sizeof(label), "%-18s %5.1f %5.1f %5.1f", metricName(static_cast<Metric>(m)),
+                      values[0], values[1], values[2]);
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderDebugText(renderer, x + 8.0f, rowY, label);
+#endif
+
+        for (int i = 0; i < 3; i++)
+        {
+            float length = (float)(std::min(values[i] / SCALE_MS, 1.0) * BAR_WIDTH);
+            SDL_SetRenderDrawColor(renderer, colors[i].r, colors[i].g, colors[i].b, colors[i].a);
+            SDL_FRect bar = {x + 8.0f, rowY + 10.0f + i * 4.0f, std::max(length, 1.0f), 3.0f};
+            SDL_RenderFillRect(renderer, &bar);
+        }
+    }
+
+    // The 60 Hz budget line
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 160);
+    SDL_FRect budget = {x + 8.0f + (float)(BUDGET_MS / SCALE_MS * BAR_WIDTH), y + 4.0f, 1.0f, ROW_HEIGHT * MetricCount};
+    SDL_RenderFillRect(renderer, &budget);
+}
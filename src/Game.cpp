@@ -1,11 +1,13 @@
 #include "Game.h"
 #include <iostream>
 #include "SDLIncludes.h"
-#include <future>
 #include "Board.h"
+#include "Trace.h"
 #include <cmath>
-#include "AI.h"
-#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <future>
 
 
 #include "Game.h"
@@ -32,13 +34,97 @@ Game::~Game()
     if (m_whiteWinsTexture) SDL_DestroyTexture(m_whiteWinsTexture);
     if (m_blackWinsTexture) SDL_DestroyTexture(m_blackWinsTexture);
     if (m_drawTexture) SDL_DestroyTexture(m_drawTexture);
-    
+    m_boardCompositor.releaseTextures();
+    m_pieceAtlas.destroy();
 
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
 }
 
+void Game::resetGameStatus()
+{
+    m_positionHistory.clear();
+    m_status = GameStatus();
+    m_historyPly = -1;
+    m_boardView = BoardView();
+
+    char date[16] = "????.??.??";
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y.%m.%d", std::localtime(&now));
+
+    m_record.clear();
+    m_record.setTag("Event", "Casual game");
+    m_record.setTag("Site", "Chess Game");
+    m_record.setTag("Date", date);
+    m_record.setTag("Round", "-");
+    m_record.setTag("White", "Player");
+    m_record.setTag("Black", m_engine.kind == EngineConfig::Kind::Stockfish ? "Stockfish" : "Minimax AI");
+    m_recordBoard = board;
+    m_recordPrevious = board;
+    m_recordSaved = false;
+}
+
+void Game::recordPosition()
+{
+    uint64_t key = board.getZobristKey();
+    if (m_recordSaved || key == m_recordBoard.getZobristKey())
+    {
+        return;
+    }
+
+    // Choosing a promotion piece changes the position but not the ply; the
+    // move was first recorded with the queen
+    if (!m_record.moves.empty() && board.getPly() == m_recordBoard.getPly())
+    {
+        m_record.moves.pop_back();
+        m_recordBoard = m_recordPrevious;
+    }
+
+    // The board only exposes the position, so find the move that leads to it
+    MoveList moves;
+    m_recordBoard.generateLegalMoves(m_recordBoard.getCurrentTurn(), moves);
+    for (Move move : moves)
+    {
+        Board next = m_recordBoard;
+        next.makeMove(move);
+        if (next.getZobristKey() == key)
+        {
+            m_record.moves.push_back(move);
+            m_recordPrevious = m_recordBoard;
+            m_recordBoard = next;
+            return;
+        }
+    }
+    std::cerr << "Game record: no legal move leads to the current position" << std::endl;
+}
+
+void Game::refreshGameStatus()
+{
+    // The ply only moves forward within a game; a smaller one means a new game
+    int ply = board.getPly();
+    if (ply < m_historyPly)
+    {
+        m_positionHistory.clear();
+    }
+
+    // Each committed position is recorded once. One that changes without a
+    // move (choosing the promotion piece) replaces the position it revised.
+    uint64_t key = board.getZobristKey();
+    if (ply == m_historyPly && m_positionHistory.size() > 0)
+    {
+        m_positionHistory.replaceLatest(key);
+    }
+    else
+    {
+        m_positionHistory.push(key);
+    }
+    m_status = evaluateGameStatus(board, m_positionHistory);
+    m_historyPly = ply;
+    m_boardView.refreshLegalTargets(board);
+    recordPosition();
+}
+
 void Game::displayEndGameMessage()
 {   
     // std::cout << "Enter displayEndGameMessage\n";
@@ -47,7 +133,7 @@ void Game::displayEndGameMessage()
         // Store the time when game over was triggered
         m_gameOverStartTime = SDL_GetTicks();
         
-        if (board.isCheckmate())
+        if (m_status.isCheckmate())
         {
             Color losingColor = board.getCurrentTurn();
             std::string winner = (losingColor == Color::White) ? "Black" : "White";
@@ -67,126 +153,337 @@ void Game::displayEndGameMessage()
                 std::cerr << "Black king at: " << m_losingKingRow << "," << m_losingKingCol << std::endl;
             }
         }
-        else if (board.isStalemate())
+        else if (m_status.state == GameState::Stalemate)
         {
             std::cout << "Game over: Stalemate! Game is a draw." << std::endl;
             m_showLosingKing = false;
         }
+        else if (m_status.drawReason != DrawReason::None)
+        {
+            const char* reason = (m_status.drawReason == DrawReason::FiftyMoveRule) ? "Fifty-move rule"
+                               : (m_status.drawReason == DrawReason::ThreefoldRepetition) ? "Threefold repetition"
+                               : "Insufficient material";
+            std::cout << "Game over: " << reason << "! Game is a draw." << std::endl;
+            m_showLosingKing = false;
+        }
         
         m_endgameMessageDisplayed = true;
     }
 }
 
+void Game::processEvent(const SDL_Event &event)
+{
+    // Resizes arrive as window events; clicks must use the layout they were made against
+    updateLayout();
+
+    if (event.type == SDL_EVENT_QUIT)
+    {
+        running = false;
+    }
+    else if (event.type == SDL_EVENT_RENDER_TARGETS_RESET || event.type == SDL_EVENT_RENDER_DEVICE_RESET)
+    {
+        // The atlas and the board layer are render targets, so their contents are gone
+        if (m_pieceAtlas.build(renderer, m_assets))
+        {
+            m_boardCompositor.setAtlas(m_pieceAtlas);
+        }
+        m_boardCompositor.releaseTextures();
+        m_boardCompositor.invalidateAll();
+    }
+    else if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN)
+    {
+        int x = event.button.x;
+        int y = event.button.y;
+        
+        // Handle clicks based on current game state
+        if (m_gameState == UIState::MainMenu) {
+            handleMainMenuClick(x, y);
+        }
+        else if (m_gameState == UIState::Playing) {
+            if (m_gameOver) { 
+                // Handle game over click
+                int w, h;
+                SDL_GetWindowSize(window, &w, &h);
+                int boxHeight = 150;
+                int btnWidth = 100;
+                int btnHeight = 40;
+                SDL_FRect button = {
+                    (float)(w - btnWidth) / 2,
+                    (float)(h + boxHeight/2 - btnHeight - 20) / 2,
+                    (float)btnWidth,
+                    (float)btnHeight
+                };
+                
+                if (x >= button.x && x <= button.x + button.w &&
+                    y >= button.y && y <= button.y + button.h) {
+                    // Return to main menu when game ends
+                    m_gameState = UIState::MainMenu;
+                    m_searchWorker.stop();
+                    m_searchPending = false;
+                    m_gameOver = false;
+                    m_endgameMessageDisplayed = false;
+                    m_showLosingKing = false;
+                }
+            }
+            else if (!m_boardView.isAnimating() && !m_gameOver) {
+                m_boardView.handleClick(board, x, y, m_boardCompositor.getLayout());
+                if (m_telemetryEnabled) {
+                    m_clickTime = FrameTelemetry::Clock::now();
+                    m_clickPending = true;
+                }
+            }
+        }
+    }
+    else if (event.type == SDL_EVENT_KEY_DOWN)
+    {
+#ifdef USE_SDL2
+        SDL_Keycode key = event.key.keysym.sym;
+#else
+        SDL_Keycode key = event.key.key;
+#endif
+        if (key == SDLK_F9 && !m_tracePath.empty())
+        {
+            writeTrace();
+        }
+        return;
+    }
+    else if (event.type == SDL_EVENT_MOUSE_MOTION)
+    {
+        // Only the menu and game-over buttons react to hovering
+        if (m_gameState == UIState::MainMenu || m_gameOver)
+        {
+            m_needsRedraw = true;
+        }
+        return;
+    }
+
+    // Clicks, window exposure, resizes and focus changes all need a fresh frame
+    m_needsRedraw = true;
+}
+
+void Game::updateLayout()
+{
+    int w, h;
+    SDL_GetWindowSize(window, &w, &h);
+    // The explorer panel takes a strip on the right when there is room for it
+    m_explorerShown = m_explorer.isOpen() && w - EXPLORER_PANEL_WIDTH >= MIN_WINDOW_SIZE;
+    BoardLayout layout = BoardLayout::fromWindow(m_explorerShown ? w - EXPLORER_PANEL_WIDTH : w, h);
+    if (layout == m_boardCompositor.getLayout() && m_pieceAtlas.cellSize() == layout.squareSize)
+    {
+        return;
+    }
+
+    // Pieces are scaled once per square size instead of on every draw
+    m_pieceAtlas.setCellSize(renderer, layout.squareSize);
+    m_boardCompositor.setLayout(layout);
+}
+
+Game::FrameSignature Game::currentFrameSignature() const
+{
+    FrameSignature signature;
+    signature.uiState = m_gameState;
+    signature.ply = board.getPly();
+    signature.selectedSquare = m_boardView.getSelectedSquare();
+    signature.gameOver = m_gameOver;
+    signature.searchPending = m_searchPending;
+    signature.searchDepth = m_searchReport.depth;
+
+    // Time-driven overlays advance in coarse steps so only real changes redraw
+    Uint32 now = SDL_GetTicks();
+    if (m_gameState == UIState::Playing && m_showLosingKing)
+        signature.overlayPhase = losingKingFlashMs() / FLASH_FRAME_MS;
+    else if (m_searchPending && m_searchReport.depth == 0)
+        signature.overlayPhase = now / 500;
+    return signature;
+}
+
+Uint32 Game::losingKingFlashMs() const
+{
+    return std::min<Uint32>(SDL_GetTicks() - m_gameOverStartTime, FLASH_PERIOD_MS * FLASH_CYCLES);
+}
+
+int Game::frameWaitTimeout() const
+{
+    if (m_gameState == UIState::MainMenu)
+        return IDLE_WAIT_MS;
+    if (m_boardView.isAnimating() || m_moveJustFinished)
+        return 0;
+    if (m_showLosingKing && losingKingFlashMs() < FLASH_PERIOD_MS * FLASH_CYCLES)
+        return FLASH_FRAME_MS;
+    // update() has to run to hand the position to the search worker
+    if (!m_gameOver && !m_searchPending && board.getCurrentTurn() == Color::Black)
+        return 0;
+    if (m_searchPending)
+        return SEARCH_POLL_MS;
+    return IDLE_WAIT_MS;
+}
+
 void Game::run()
 {
     running = true;
+    m_needsRedraw = true;
+    if (Trace::isEnabled())
+    {
+        Trace::setThreadName("UI");
+    }
     while (running)
     {
+        // Sleep in the event queue until input arrives or something on screen is due to change
         SDL_Event event;
-        while (SDL_PollEvent(&event))
+        bool gotEvent;
         {
-            if (event.type == SDL_EVENT_QUIT)
-            {
-                running = false;
-            }
-            else if (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN)
+            TRACE_ZONE("Game::waitForEvent");
+            gotEvent = SDL_WaitEventTimeout(&event, frameWaitTimeout());
+        }
+        FrameTelemetry::Clock::time_point frameStart = FrameTelemetry::Clock::now();
+        if (gotEvent)
+        {
+            TRACE_ZONE("Game::processEvents");
+            processEvent(event);
+            while (SDL_PollEvent(&event))
             {
-                int x = event.button.x;
-                int y = event.button.y;
-                
-                // Handle clicks based on current game state
-                if (m_gameState == UIState::MainMenu) {
-                    handleMainMenuClick(x, y);
-                }
-                else if (m_gameState == UIState::Playing) {
-                    if (m_gameOver) { 
-                        // Handle game over click
-                        int w, h;
-                        SDL_GetWindowSize(window, &w, &h);
-                        int boxHeight = 150;
-                        int btnWidth = 100;
-                        int btnHeight = 40;
-                        SDL_FRect button = {
-                            (float)(w - btnWidth) / 2,
-                            (float)(h + boxHeight/2 - btnHeight - 20) / 2,
-                            (float)btnWidth,
-                            (float)btnHeight
-                        };
-                        
-                        if (x >= button.x && x <= button.x + button.w &&
-                            y >= button.y && y <= button.y + button.h) {
-                            // Return to main menu when game ends
-                            m_gameState = UIState::MainMenu;
-                            m_gameOver = false;
-                            m_endgameMessageDisplayed = false;
-                        }
-                    }
-                    else if (board.isAnimationDone() && !m_gameOver) {
-                        board.handleClick(x, y);
-                    }
-                }
+                processEvent(event);
             }
         }
 
-        // Update and render based on current game state
-        float deltaTime = 1.0f / 60.0f;
-        
+        Uint32 now = SDL_GetTicks();
+        float deltaTime = std::min((now - lastFrameTime) / 1000.0f, 1.0f / 30.0f);
+        lastFrameTime = now;
+
+        bool animating = false;
         try {
-            if (m_gameState == UIState::MainMenu) {
-                renderMainMenu();
-            }
-            else if (m_gameState == UIState::Playing) {
+            if (m_gameState == UIState::Playing) {
+                FrameTelemetry::Clock::time_point updateStart = FrameTelemetry::Clock::now();
                 update(deltaTime);
-                
+                if (m_telemetryEnabled) {
+                    m_telemetry.record(FrameTelemetry::Update, FrameTelemetry::elapsedMs(updateStart));
+                }
+
                 if (m_gameOver) {
                     displayEndGameMessage();
                 }
-                render();
+            }
+
+            animating = m_boardView.isAnimating();
+            FrameSignature signature = currentFrameSignature();
+            if (m_needsRedraw || animating || !(signature == m_lastFrame)) {
+                FrameTelemetry::Clock::time_point renderStart = FrameTelemetry::Clock::now();
+                if (m_gameState == UIState::MainMenu) {
+                    renderMainMenu();
+                }
+                else {
+                    render();
+                }
+                m_lastFrame = signature;
+                m_needsRedraw = false;
+
+                // Render time includes the present, so with vsync it also covers the wait for the display
+                if (m_telemetryEnabled) {
+                    m_telemetry.record(FrameTelemetry::Render, FrameTelemetry::elapsedMs(renderStart));
+                    m_telemetry.record(FrameTelemetry::Frame, FrameTelemetry::elapsedMs(frameStart));
+                    if (m_clickPending) {
+                        m_telemetry.record(FrameTelemetry::ClickToHighlight, FrameTelemetry::elapsedMs(m_clickTime));
+                        m_clickPending = false;
+                    }
+                }
             }
         }
         catch (const std::exception &e) {
             std::cerr << "Exception in game loop: " << e.what() << std::endl;
         }
 
-        // Cap the frame rate
-        Uint32 frameTime = SDL_GetTicks() - lastFrameTime;
-        if (frameTime < 16) {
-            SDL_Delay(16 - frameTime);
+        // With vsync the present call paces animation frames; without it, cap them here
+        if (animating && !m_vsyncEnabled) {
+            Uint32 frameTime = SDL_GetTicks() - now;
+            if (frameTime < 16) {
+                SDL_Delay(16 - frameTime);
+            }
         }
-        lastFrameTime = SDL_GetTicks();
     }
+
+    // An unfinished game is kept with an open result
+    saveRecord();
+
+    if (m_telemetryEnabled)
+    {
+        exportTelemetry();
+    }
+    if (!m_tracePath.empty())
+    {
+        writeTrace();
+    }
+}
+
+void Game::enableTrace(const std::string &path)
+{
+    m_tracePath = path;
+    Trace::setEnabled(true);
+}
+
+void Game::writeTrace() const
+{
+    if (Trace::writeJson(m_tracePath))
+    {
+        std::cout << "Trace written to " << m_tracePath << std::endl;
+    }
+}
+
+void Game::enableTelemetry(bool showOverlay, const std::string &csvPath)
+{
+    m_telemetryEnabled = true;
+    m_telemetryOverlay = showOverlay;
+    m_telemetryCsvPath = csvPath;
+}
+
+void Game::exportTelemetry() const
+{
+    m_telemetry.writeSummary(std::cout);
+    if (m_telemetryCsvPath.empty())
+    {
+        return;
+    }
+
+    std::ofstream csv(m_telemetryCsvPath);
+    if (!csv)
+    {
+        std::cerr << "Cannot write telemetry to " << m_telemetryCsvPath << std::endl;
+        return;
+    }
+    m_telemetry.writeCsv(csv);
+    std::cout << "Telemetry histograms written to " << m_telemetryCsvPath << std::endl;
 }
 
 void Game::render()
 {
+    TRACE_ZONE("Game::render");
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
     SDL_RenderClear(renderer);
     
-    // Draw the board and pieces
-    board.render(renderer, *this);
+    // Draw the board, highlights and pieces; only layers that changed are rebuilt
+    m_boardCompositor.draw(renderer, board, m_boardView);
+    if (m_explorerShown)
+    {
+        renderExplorerPanel();
+    }
 
     // If game is over and we have a losing king, highlight it with a flashing red square
     if (m_showLosingKing && m_losingKingRow >= 0 && m_losingKingCol >= 0) {
-        const int SQUARE_SIZE = 75; // Make sure this matches your board's square size
-        
-        // Make the square flash by changing alpha based on time
-        Uint8 alpha = 128 + (Uint8)(127 * sin((SDL_GetTicks() - m_gameOverStartTime) / 300.0));
+        // Make the square flash by changing alpha based on time, then hold it
+        Uint32 flashMs = losingKingFlashMs();
+        Uint8 alpha = 192;
+        if (flashMs < FLASH_PERIOD_MS * FLASH_CYCLES)
+            alpha = (Uint8)(128 + 127 * sin(6.283185307 * flashMs / FLASH_PERIOD_MS));
         
         SDL_SetRenderDrawColor(renderer, 255, 0, 0, alpha);
         SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
         
-        SDL_FRect kingRect = {
-            (float)(m_losingKingCol * SQUARE_SIZE),
-            (float)((7 - m_losingKingRow) * SQUARE_SIZE), // Convert from board to screen coordinates
-            (float)SQUARE_SIZE,
-            (float)SQUARE_SIZE
-        };
+        SDL_FRect kingRect = m_boardCompositor.getLayout().squareRect(m_losingKingRow, m_losingKingCol);
         
         SDL_RenderFillRect(renderer, &kingRect);
     }
 
     // Show thinking indicator when Stockfish is calculating
-    if (stockfishMovePending) {
+    if (m_searchPending) {
         // Draw a semi-transparent overlay for the thinking indicator
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 64);
         SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
@@ -197,8 +494,8 @@ void Game::render()
         SDL_FRect indicatorRect = {10.0f, h - 40.0f, 120.0f, 30.0f};
         SDL_RenderFillRect(renderer, &indicatorRect);
         
-        // Simple animation of dots
-        int numDots = (SDL_GetTicks() / 500) % 4; // Changes every 500ms
+        // One dot per completed search depth, cycling while the first one runs
+        int numDots = (m_searchReport.depth > 0) ? std::min(m_searchReport.depth, 5) : (SDL_GetTicks() / 500) % 4;
         SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
         
         for (int i = 0; i < numDots; i++) {
@@ -238,7 +535,7 @@ void Game::render()
         
         // Draw appropriate game over message
         SDL_Texture* messageTexture = nullptr;
-        if (board.isCheckmate()) {
+        if (m_status.isCheckmate()) {
             Color losingColor = board.getCurrentTurn();
             if (losingColor == Color::White) {
                 messageTexture = m_blackWinsTexture;
@@ -246,7 +543,7 @@ void Game::render()
                 messageTexture = m_whiteWinsTexture;
             }
         } else {
-            messageTexture = m_drawTexture; // Stalemate
+            messageTexture = m_drawTexture; // Stalemate or a draw rule
         }
         
         if (messageTexture) {
@@ -293,16 +590,92 @@ void Game::render()
     }
     
 
-    SDL_RenderPresent(renderer);
+    if (m_telemetryOverlay)
+    {
+        m_telemetry.drawOverlay(renderer, 8.0f, 8.0f);
+    }
+    {
+        TRACE_ZONE("SDL_RenderPresent");
+        SDL_RenderPresent(renderer);
+    }
+}
+
+void Game::renderExplorerPanel()
+{
+    const float ROW_HEIGHT = 36.0f;
+    const BoardLayout &layout = m_boardCompositor.getLayout();
+    float x = (float)(layout.originX + layout.boardSize() + 8);
+    float y = (float)(layout.originY + 8);
+    float width = EXPLORER_PANEL_WIDTH - 16.0f;
+
+    // One binary search in the mapped table; everything shown was aggregated when it was built
+    OpeningExplorer::MoveRange moves = m_explorer.find(board.getZobristKey());
+    int rows = std::min((int)moves.size(), EXPLORER_ROWS);
+    uint32_t total = moves.games();
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 40, 40, 40, 230);
+    SDL_FRect background = {x, y, width, ROW_HEIGHT * (rows + 1)};
+    SDL_RenderFillRect(renderer, &background);
+
+#ifndef USE_SDL2
+    // SDL2 has no debug text; the result bars alone are drawn there
+    char line[64];
+    if (rows == 0)
+        std::snprintf(line, sizeof(line), "Out of book");
+    else
+        std::snprintf(line, sizeof(line), "%u games", total);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderDebugText(renderer, x + 8.0f, y + 14.0f, line);
+#endif
+
+    for (int i = 0; i < rows; i++)
+    {
+        const ExplorerMove &move = moves.first[i];
+        float rowY = y + ROW_HEIGHT * (i + 1);
+
+#ifndef USE_SDL2
+        std::string san = moveToSan(board, Move::fromRaw(move.move));
+        std::snprintf(line, sizeof(line), "%-7s %5.1f%% %8u", san.c_str(), 100.0 * move.games / total, move.games);
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderDebugText(renderer, x + 8.0f, rowY + 2.0f, line);
+        std::snprintf(line, sizeof(line), "elo %4u  last %04u.%02u.%02u", move.averageElo, move.lastDate / 10000,
+                      move.lastDate / 100 % 100, move.lastDate % 100);
+        SDL_SetRenderDrawColor(renderer, 190, 190, 190, 255);
+        SDL_RenderDebugText(renderer, x + 8.0f, rowY + 24.0f, line);
+#endif
+
+        // White wins, draws and black wins as one bar, scaled to how often the move was played
+        float barWidth = (width - 16.0f) * move.games / std::max(1u, moves.first->games);
+        uint32_t decided = move.whiteWins + move.draws + move.blackWins;
+        const uint32_t counts[3] = {move.whiteWins, move.draws, move.blackWins};
+        const SDL_Color colors[3] = {{240, 240, 240, 255}, {140, 140, 140, 255}, {10, 10, 10, 255}};
+        float barX = x + 8.0f;
+        for (int part = 0; part < 3; part++)
+        {
+            float partWidth = decided ? barWidth * counts[part] / decided : (part == 1 ? barWidth : 0.0f);
+            SDL_SetRenderDrawColor(renderer, colors[part].r, colors[part].g, colors[part].b, colors[part].a);
+            SDL_FRect bar = {barX, rowY + 13.0f, partWidth, 8.0f};
+            SDL_RenderFillRect(renderer, &bar);
+            barX += partWidth;
+        }
+    }
 }
 
 void Game::update(float deltaTime)
 {
-    board.updateAnimation(deltaTime);
-    
-    if (!m_gameOver && board.isAnimationDone() && (board.isCheckmate() || board.isStalemate()))
+    TRACE_ZONE("Game::update");
+    m_boardView.updateAnimation(board, deltaTime);
+
+    if (!m_boardView.isAnimating() && board.getZobristKey() != m_status.key)
+    {
+        refreshGameStatus();
+    }
+
+    if (!m_gameOver && !m_boardView.isAnimating() && m_status.isOver())
     {
         m_gameOver = true;
+        saveRecord();
         displayEndGameMessage();
         return;
     }
@@ -312,161 +685,53 @@ void Game::update(float deltaTime)
         m_moveJustFinished = false;
         return;
     }
-        // In the update method where Stockfish is used, modify the timeout check
-    if (board.getCurrentTurn() == Color::Black && board.isAnimationDone() && !m_promotionInProgress && !m_gameOver)
+
+    // Searches run on the worker thread; the frame loop only reads its mailbox
+    SearchReport report;
+    while (m_searchWorker.poll(report))
     {
-        if (stockfishInitInProgress) {
-            // Don't make a move yet, wait for initialization to complete
-            return;
+        if (report.searchId == m_searchId)
+        {
+            m_searchReport = report;
         }
-    
-        try
+    }
+
+    if (board.getCurrentTurn() == Color::Black && !m_boardView.isAnimating() && !m_promotionInProgress && !m_gameOver)
+    {
+        if (!m_searchPending)
         {
-            if (useStockfish && stockfishInitialized) {
-                std::string currentPosition = boardToFEN(board);
-    
-                // If we've already started analyzing this position, check if result is ready
-                if (stockfishMovePending) {
-                    // Check if the future is ready without blocking
-                    auto status = stockfishFuture.wait_for(std::chrono::milliseconds(100));
-                    
-                    // Add timeout check for Stockfish calculation
-                    static Uint32 stockfishStartTime = SDL_GetTicks();
-                    if (status == std::future_status::ready) {
-                        try {
-                            // Move calculation finished, get the result
-                            lastAnalyzedMove = stockfishFuture.get();
-                            lastAnalyzedPosition = currentPosition;
-                            stockfishMovePending = false;
-                            stockfishStartTime = 0;
-                            
-                            // Make the move
-                            auto [fromRow, fromCol, toRow, toCol] = lastAnalyzedMove;
-                            
-                            if (fromRow != -1 && fromCol != -1 && toRow != -1 && toCol != -1) {
-                                board.movePiece(fromRow, fromCol, toRow, toCol);
-                                m_moveJustFinished = true;
-                            } else {
-                                m_gameOver = true;
-                                displayEndGameMessage();
-                            }
-                        } catch (const std::exception& e) {
-                            std::cerr << "Exception getting Stockfish move: " << e.what() << std::endl;
-                            stockfishMovePending = false;
-                            
-                            // Fall back to built-in AI
-                            std::cout << "Falling back to built-in AI due to Stockfish error" << std::endl;
-                            AI ai(Color::Black, 2);
-                            auto move = ai.getBestMove(board);
-                            auto [fromRow, fromCol, toRow, toCol] = move;
-                            
-                            if (fromRow != -1) {
-                                board.movePiece(fromRow, fromCol, toRow, toCol);
-                                m_moveJustFinished = true;
-                            } else {
-                                m_gameOver = true;
-                                displayEndGameMessage();
-                            }
-                        }
-                    } else if (SDL_GetTicks() - stockfishStartTime > 5000) { // 5 second timeout (reduced from 30s)
-                        // Stockfish is taking too long or crashed - use quick fallback
-                        std::cerr << "Stockfish calculation timeout, falling back to built-in AI" << std::endl;
-                        stockfishMovePending = false;
-                        
-                        // Kill the hanging Stockfish process if possible
-                        try {
-                            stockfish.stopEngine();// Try to stop Stockfish gracefully
-                        } catch (...) {
-                            // Ignore errors when trying to stop Stockfish
-                        }
-                        
-                        // Use the built-in AI instead
-                        AI ai(Color::Black, 2);
-                        auto move = ai.getBestMove(board);
-                        auto [fromRow, fromCol, toRow, toCol] = move;
-                        
-                        if (fromRow != -1) {
-                            board.movePiece(fromRow, fromCol, toRow, toCol);
-                            m_moveJustFinished = true;
-                        } else {
-                            m_gameOver = true;
-                            displayEndGameMessage();
-                        }
-                    }
-                    // Still calculating and within timeout, don't do anything
-                    return;
-                }
-                
-                // If this is a new position and no calculation is pending, start a new one
-                if (currentPosition != lastAnalyzedPosition && !stockfishMovePending) {
-                    // Start async calculation
-                    stockfishMovePending = true;
-                    static Uint32 stockfishStartTime = SDL_GetTicks();
-                    try {
-                        stockfishFuture = std::async(std::launch::async, [this, currentPosition]() {
-                            if (!stockfish.ensureEngineRunning()) {
-                                std::cerr << "Failed to ensure Stockfish is running, falling back to built-in AI" << std::endl;
-                                // Fall back to built-in AI
-                                AI ai(Color::Black, 2);
-                                return ai.getBestMove(board);
-                            }
-                            return stockfish.getBestMove(board, 1000);
-                        });
-                    } catch (const std::exception& e) {
-                        std::cerr << "Failed to start Stockfish calculation: " << e.what() << std::endl;
-                        stockfishMovePending = false;
-                        useStockfish = false;  // Disable Stockfish after failure
-                        
-                        // Use built-in AI immediately
-                        AI ai(Color::Black, 2);
-                        auto move = ai.getBestMove(board);
-                        auto [fromRow, fromCol, toRow, toCol] = move;
-                        if (fromRow != -1) {
-                            board.movePiece(fromRow, fromCol, toRow, toCol);
-                            m_moveJustFinished = true;
-                        }
-                    }
-                    return;
-                }
-                
-                // Use cached result if position hasn't changed
-                if (currentPosition == lastAnalyzedPosition && !stockfishMovePending) {
-                    auto [fromRow, fromCol, toRow, toCol] = lastAnalyzedMove;
-                    if (fromRow != -1 && fromCol != -1 && toRow != -1 && toCol != -1) {
-                        board.movePiece(fromRow, fromCol, toRow, toCol);
-                        m_moveJustFinished = true;
-                    } else {
-                        m_gameOver = true;
-                        displayEndGameMessage();
-                    }
-                }
-            } else {
-                // Use original AI
-                static AI ai(Color::Black, 2);
-                auto move = ai.getBestMove(board);
-                
-                auto [fromRow, fromCol, toRow, toCol] = move;
-                
-                if (fromRow != -1) {
-                    board.movePiece(fromRow, fromCol, toRow, toCol);
-                    m_moveJustFinished = true;
-                } else {
-                    m_gameOver = true;
-                    displayEndGameMessage();
-                }
-            }
+            m_searchReport = SearchReport();
+            m_searchId = m_searchWorker.start(board, m_engine);
+            m_searchPending = true;
+            m_searchStartTime = FrameTelemetry::Clock::now();
         }
-        catch (const std::exception &e)
+        else if (m_searchReport.finished)
         {
-            std::cerr << "AI move error: " << e.what() << std::endl;
-            m_gameOver = true;
-            displayEndGameMessage();
+            m_searchPending = false;
+            if (m_telemetryEnabled)
+            {
+                m_telemetry.record(FrameTelemetry::AiWait, FrameTelemetry::elapsedMs(m_searchStartTime));
+            }
+            Move move = m_searchReport.bestMove;
+            if (!move.isNone())
+            {
+                PieceType promotion = move.isPromotion() ? move.promotionType() : PieceType::Queen;
+                m_boardView.movePiece(board, move.fromRow(), move.fromCol(), move.toRow(), move.toCol(), promotion);
+                m_moveJustFinished = true;
+            }
+            else
+            {
+                m_gameOver = true;
+                saveRecord();
+                displayEndGameMessage();
+            }
         }
     }
 }
 
 void Game::renderMainMenu()
 {
+    TRACE_ZONE("Game::renderMainMenu");
     // Clear background with a chess-themed gradient
     SDL_SetRenderDrawColor(renderer, 50, 50, 80, 255);
     SDL_RenderClear(renderer);
@@ -542,7 +807,14 @@ void Game::renderMainMenu()
         SDL_RenderTexture(renderer, buttonTextures[i], nullptr, &menuButtons[i]);
     }
     
-    SDL_RenderPresent(renderer);
+    if (m_telemetryOverlay)
+    {
+        m_telemetry.drawOverlay(renderer, 8.0f, 8.0f);
+    }
+    {
+        TRACE_ZONE("SDL_RenderPresent");
+        SDL_RenderPresent(renderer);
+    }
 }
 
 void Game::handleMainMenuClick(int x, int y)
@@ -570,61 +842,124 @@ void Game::handleMainMenuClick(int x, int y)
     }
 }
 
-void Game::startGameWithStockfish()
+EngineConfig Game::stockfishEngine()
 {
-    m_gameState = UIState::Playing;
-    useStockfish = true;
-    stockfishInitInProgress = true;
-    
+    EngineConfig engine;
+    engine.kind = EngineConfig::Kind::Stockfish;
+    engine.moveTimeMs = 1000;
     #ifdef _WIN32
-    const std::string stockfishPath = "stockfish.exe";
+    engine.path = "stockfish.exe";
     #else
-    const std::string stockfishPath = "./stockfish";
+    engine.path = "./stockfish";
     #endif
-    
-    stockfishInitThread = std::thread([this, stockfishPath]() {
-        try {
-            if (stockfish.initialize(stockfishPath)) {
-                std::cout << "Successfully initialized Stockfish!" << std::endl;
-                useStockfish = true;
-                stockfishInitialized = true;
-            } else {
-                std::cout << "Failed to initialize Stockfish, falling back to built-in AI" << std::endl;
-                useStockfish = false;
-                stockfishInitialized = false;
-            }
-        } catch (const std::exception& e) {
-            std::cout << "Exception during Stockfish initialization: " << e.what() << std::endl;
-            useStockfish = false;
-            stockfishInitialized = false;
-        } catch (...) {
-            std::cout << "Unknown exception during Stockfish initialization" << std::endl;
-            useStockfish = false;
-            stockfishInitialized = false;
-        }
-        stockfishInitInProgress = false;
-    });
-    
-    stockfishInitThread.detach();
+    return engine;
+}
+
+void Game::startGameWithStockfish()
+{
+    m_gameState = UIState::Playing;
+    m_engine = stockfishEngine();
+
+    // The engine has been running since startup; this only sends ucinewgame
+    m_searchWorker.newGame(m_engine);
+    m_searchPending = false;
     board.initialize();
+    resetGameStatus();
 }
 
 void Game::startGameWithMinimaxAI()
 {
     m_gameState = UIState::Playing;
-    useStockfish = false;
-    stockfishInitialized = false;
-    stockfishInitInProgress = false;
+    m_engine = EngineConfig();
+    m_engine.kind = EngineConfig::Kind::BuiltIn;
+    m_engine.depth = 2;
+
+    m_searchWorker.newGame(m_engine);
+    m_searchPending = false;
     board.initialize();
+    resetGameStatus();
+}
+namespace
+{
+    // Caches and saved games live in the per-user data directory
+    std::string prefFilePath(const char* name)
+    {
+        char *prefPath = SDL_GetPrefPath("ChessGame", "Chess");
+        if (!prefPath)
+        {
+            return std::string();
+        }
+        std::string path = std::string(prefPath) + name;
+        SDL_free(prefPath);
+        return path;
+    }
+}
+
+void Game::saveRecord()
+{
+    if (m_recordSaved)
+    {
+        return;
+    }
+    m_recordSaved = true;
+    if (m_record.moves.empty())
+    {
+        return;
+    }
+
+    if (m_status.isCheckmate())
+    {
+        m_record.result = (board.getCurrentTurn() == Color::White) ? "0-1" : "1-0";
+    }
+    else if (m_status.isDraw())
+    {
+        m_record.result = "1/2-1/2";
+    }
+    else
+    {
+        m_record.result = "*";
+    }
+
+    std::string path = prefFilePath("games.pgn");
+    if (path.empty())
+    {
+        return;
+    }
+    std::ofstream out(path, std::ios::app);
+    writePgn(out, m_record);
+    if (!out)
+    {
+        std::cerr << "Could not write the game to " << path << std::endl;
+    }
 }
+
 bool Game::initialize()
 {
     // Set up initial game state to show menu
     m_gameState = UIState::MainMenu;
-    useStockfish = false;
-    stockfishInitInProgress = false;
-    stockfishInitialized = false;
 
+    // Opening statistics, when a table has been built with chess_cli db import
+    std::string bookPath = m_bookPath.empty() ? prefFilePath("openings.book") : m_bookPath;
+    if (!bookPath.empty() && m_explorer.open(bookPath))
+    {
+        m_searchWorker.setOpeningBook(&m_explorer);
+    }
+
+    // Stockfish starts and completes its UCI handshake on the search thread
+    // while the menu comes up, so a game against it can begin at once
+    m_searchWorker.warmUp(stockfishEngine());
+    std::string analysisPath = prefFilePath("analysis.cache");
+    if (!analysisPath.empty())
+    {
+        m_searchWorker.openAnalysisCache(analysisPath);
+    }
+
+    // Decode the asset pack while the window and renderer are created
+    std::string cachePath = prefFilePath("assets.cache");
+    std::future<bool> assetsDecoded = std::async(std::launch::async, [this, cachePath]()
+    {
+        return m_assets.open(AssetPack::DEFAULT_PATH) && m_assets.decode(cachePath);
+    });
 
     if (SDL_Init(SDL_INIT_VIDEO) < 0)
     {
@@ -632,7 +967,8 @@ bool Game::initialize()
         return false;
     }
 
-    window = SDL_CreateWindow("Chess Game", 600, 600, 0);
+    int windowWidth = 600 + (m_explorer.isOpen() ? EXPLORER_PANEL_WIDTH : 0);
+    window = SDL_CreateWindow("Chess Game", windowWidth, 600, SDL_WINDOW_RESIZABLE);
     if (!window)
     {
         std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
@@ -640,6 +976,7 @@ bool Game::initialize()
     }
 
     SDL_SetWindowPosition(window, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED);
+    SDL_SetWindowMinimumSize(window, MIN_WINDOW_SIZE, MIN_WINDOW_SIZE);
 
     renderer = SDL_CreateRenderer(window, NULL);
     if (!renderer)
@@ -647,7 +984,12 @@ bool Game::initialize()
         std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
         return false;
     }
-    
+    m_vsyncEnabled = SDL_SetRenderVSync(renderer, 1);
+
+    if (!assetsDecoded.get())
+    {
+        std::cerr << "Asset pack unavailable, loading the BMP files instead" << std::endl;
+    }
     m_titleTexture = loadTexture("images/Title.bmp");
     m_stockfishButtonTexture = loadTexture("images/PlayvsStockfish(Strong).bmp");
     m_minimaxButtonTexture = loadTexture("images/PlayvsMinimax(Medium).bmp");
@@ -664,30 +1006,13 @@ bool Game::initialize()
         std::cerr << "Failed to load UI textures!" << std::endl;
         return false;
     }
-    // Load piece textures
-    pieceTextures["wK"] = loadTexture("images/wK.bmp");
-    pieceTextures["wQ"] = loadTexture("images/wQ.bmp");
-    pieceTextures["wB"] = loadTexture("images/wB.bmp");
-    pieceTextures["wN"] = loadTexture("images/wN.bmp");
-    pieceTextures["wR"] = loadTexture("images/wR.bmp");
-    pieceTextures["wp"] = loadTexture("images/wp.bmp");
-
-    pieceTextures["bK"] = loadTexture("images/bK.bmp");
-    pieceTextures["bQ"] = loadTexture("images/bQ.bmp");
-    pieceTextures["bB"] = loadTexture("images/bB.bmp");
-    pieceTextures["bN"] = loadTexture("images/bN.bmp");
-    pieceTextures["bR"] = loadTexture("images/bR.bmp");
-    pieceTextures["bp"] = loadTexture("images/bp.bmp");
-
-    // Check if all textures loaded successfully
-    for (const auto &[key, texture] : pieceTextures)
-    {
-        if (!texture)
-        {
-            std::cerr << "Failed to load texture: " << key << std::endl;
-            return false;
-        }
+    if (!m_pieceAtlas.build(renderer, m_assets))
+    {
+        std::cerr << "Failed to build the piece atlas!" << std::endl;
+        return false;
     }
+    m_boardCompositor.setAtlas(m_pieceAtlas);
+    updateLayout();
 
     // Initialize the chess board
     board.initialize();
@@ -699,71 +1024,13 @@ bool Game::initialize()
 
 SDL_Texture *Game::loadTexture(const char *path) const
 {
-    SDL_Surface *surface = SDL_LoadBMP(path);
-    if (!surface)
-    {
-        std::cerr << "Failed to load image: " << path << std::endl;
-        return nullptr;
-    }
-
-    SDL_SetSurfaceColorKey(surface, true, SDL_MapSurfaceRGB(surface, 255, 0, 255));
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_DestroySurface(surface); 
-
-    return texture;
-}
-SDL_Texture *Game::getPieceTexture(PieceType type, Color color) const
-{
-    std::string key;
-
-    
-    key += (color == Color::White) ? 'w' : 'b';
-
-    
-    switch (type)
-    {
-    case PieceType::King:
-        key += "K";
-        break;
-    case PieceType::Queen:
-        key += "Q";
-        break;
-    case PieceType::Bishop:
-        key += "B";
-        break;
-    case PieceType::Knight:
-        key += "N";
-        break;
-    case PieceType::Rook:
-        key += "R";
-        break;
-    case PieceType::Pawn:
-        key += "p";
-        break;
-    }
-
-    auto it = pieceTextures.find(key);
-    if (it != pieceTextures.end())
-    {
-        return it->second;
-    }
-
-    return nullptr;
+    return loadImageTexture(renderer, m_assets, path);
 }
 
 void Game::cleanup()
 {
-    
-    for (auto &[key, texture] : pieceTextures)
-    {
-        if (texture)
-        {
-            SDL_DestroyTexture(texture);
-            texture = nullptr;
-        }
-    }
-
-    pieceTextures.clear();
+    m_boardCompositor.releaseTextures();
+    m_pieceAtlas.destroy();
 
     if (renderer)
     {
@@ -785,7 +1052,7 @@ void Game::handleEvents()
 {
     
     static bool lastAnimatingState = false;
-    bool currentlyAnimating = !board.isAnimationDone();
+    bool currentlyAnimating = m_boardView.isAnimating();
 
     if (lastAnimatingState != currentlyAnimating)
     {
@@ -823,7 +1090,7 @@ void Game::handleEvents()
             if (event.button.button == SDL_BUTTON_LEFT)
             {
                 
-                board.handleClick(event.button.x, event.button.y);
+                m_boardView.handleClick(board, event.button.x, event.button.y, m_boardCompositor.getLayout());
             }
             break;
         }
@@ -840,30 +1107,8 @@ void Game::startPromotion(int row, int col, Color color)
 
 void Game::handlePromotion(PieceType type)
 {
-    
-    Piece *newPiece = nullptr;
-    switch (type)
-    {
-    case PieceType::Queen:
-        newPiece = new Queen(m_promotionColor, m_promotionRow, m_promotionCol);
-        break;
-    case PieceType::Rook:
-        newPiece = new Rook(m_promotionColor, m_promotionRow, m_promotionCol);
-        break;
-    case PieceType::Bishop:
-        newPiece = new Bishop(m_promotionColor, m_promotionRow, m_promotionCol);
-        break;
-    case PieceType::Knight:
-        newPiece = new Knight(m_promotionColor, m_promotionRow, m_promotionCol);
-        break;
-    default:
-        newPiece = new Queen(m_promotionColor, m_promotionRow, m_promotionCol);
-        break;
-    }
-
-    
-    delete board.getPiece(m_promotionRow, m_promotionCol);
-    board.placePiece(newPiece, m_promotionRow, m_promotionCol);
-
+    if (type != PieceType::Rook && type != PieceType::Bishop && type != PieceType::Knight)
+        type = PieceType::Queen;
+    board.placePiece(Piece(type, m_promotionColor), m_promotionRow, m_promotionCol);
     m_promotionInProgress = false;
 }
\ No newline at end of file
@@ -0,0 +1,513 @@
+#include "GameDatabase.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+namespace
+{
+    const uint32_t DATABASE_VERSION = 1;
+    const uint32_t INDEX_VERSION = 1;
+    // Games a worker claims at a time while building the index
+    const uint32_t INDEX_BATCH = 256;
+    // Entries each merge input reads ahead
+    const size_t MERGE_BLOCK = 4096;
+
+    struct DatabaseHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t gameCount;
+        uint32_t reserved;
+        uint64_t entriesOffset;
+    };
+
+    struct IndexHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t gameCount;     // of the database it was built from
+        uint32_t reserved;
+        uint64_t positionCount;
+    };
+
+    bool entryLess(const PositionEntry& a, const PositionEntry& b)
+    {
+        if (a.key != b.key)
+            return a.key < b.key;
+        if (a.game != b.game)
+            return a.game < b.game;
+        return a.ply < b.ply;
+    }
+
+    GameResult parseResult(const std::string& result)
+    {
+        if (result == "1-0")
+            return GameResult::WhiteWins;
+        if (result == "0-1")
+            return GameResult::BlackWins;
+        if (result == "1/2-1/2")
+            return GameResult::Draw;
+        return GameResult::Unknown;
+    }
+
+    const char* resultText(GameResult result)
+    {
+        switch (result)
+        {
+        case GameResult::WhiteWins: return "1-0";
+        case GameResult::BlackWins: return "0-1";
+        case GameResult::Draw: return "1/2-1/2";
+        default: return "*";
+        }
+    }
+
+    // "2024.03.??" becomes 20240300
+    uint32_t parseDate(const std::string* date)
+    {
+        if (!date || date->size() < 10)
+            return 0;
+        auto field = [&](size_t start, size_t length) {
+            uint32_t value = 0;
+            for (size_t i = start; i < start + length; i++)
+            {
+                char c = (*date)[i];
+                if (c < '0' || c > '9')
+                    return 0u;
+                value = value * 10 + (c - '0');
+            }
+            return value;
+        };
+        return field(0, 4) * 10000 + field(5, 2) * 100 + field(8, 2);
+    }
+
+    uint16_t parseElo(const std::string* elo)
+    {
+        return elo ? static_cast<uint16_t>(std::min(std::max(std::atoi(elo->c_str()), 0), 65535)) : 0;
+    }
+
+    // Pseudo-legal moves of the side to move in square order. Stored games
+    // only hold legal moves, so decoding needs no legality test, and the
+    // list still never exceeds a byte's range.
+    void generateCandidates(const Board& board, MoveList& moves)
+    {
+        moves.clear();
+        Color color = board.getCurrentTurn();
+        for (int square = 0; square < 64; square++)
+        {
+            Piece piece = board.getPiece(square);
+            if (piece && piece.getColor() == color)
+                board.fastGenerateMoves(square, moves);
+        }
+    }
+
+    // A run file of sorted entries read back in blocks
+    struct RunReader {
+        std::ifstream in;
+        std::vector<PositionEntry> block;
+        size_t next = 0;
+
+        bool refill()
+        {
+            block.resize(MERGE_BLOCK);
+            in.read(reinterpret_cast<char*>(block.data()), MERGE_BLOCK * sizeof(PositionEntry));
+            block.resize(static_cast<size_t>(in.gcount()) / sizeof(PositionEntry));
+            next = 0;
+            return !block.empty();
+        }
+        const PositionEntry& current() const { return block[next]; }
+        bool advance() { return ++next < block.size() || refill(); }
+    };
+}
+
+bool GameDatabaseWriter::create(const std::string& path)
+{
+    m_out.close();
+    m_out.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_out)
+    {
+        std::cerr << "GameDatabase: cannot create " << path << std::endl;
+        return false;
+    }
+    m_path = path;
+    m_entries.clear();
+
+    // Rewritten by finish(); until then the entry offset of zero marks the file incomplete
+    DatabaseHeader header = {{'C', 'H', 'G', 'D'}, DATABASE_VERSION, 0, 0, 0};
+    m_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_offset = sizeof(header);
+    return static_cast<bool>(m_out);
+}
+
+bool GameDatabaseWriter::add(const PgnGame& game)
+{
+    if (!m_out.is_open())
+        return false;
+
+    GameEntry entry = {};
+    entry.offset = m_offset;
+    entry.date = parseDate(game.tag("Date"));
+    entry.whiteElo = parseElo(game.tag("WhiteElo"));
+    entry.blackElo = parseElo(game.tag("BlackElo"));
+    entry.result = parseResult(game.result);
+    if (!game.error.empty())
+        entry.flags |= GameEntry::Truncated;
+    if (game.tag("FEN"))
+        entry.flags |= GameEntry::CustomStart;
+
+    m_buffer.clear();
+    for (const auto& tag : game.tags)
+    {
+        // Results live in the entry; overlong tags are dropped rather than cut
+        if (tag.first == "Result" || m_buffer.size() + tag.first.size() + tag.second.size() + 2 > UINT16_MAX)
+            continue;
+        m_buffer.append(tag.first).push_back('\0');
+        m_buffer.append(tag.second).push_back('\0');
+    }
+    entry.tagBytes = static_cast<uint16_t>(m_buffer.size());
+
+    Board board;
+    if (!game.startPosition(board))
+        return false;
+    size_t plies = std::min<size_t>(game.moves.size(), UINT16_MAX);
+    MoveList candidates;
+    for (size_t i = 0; i < plies; i++)
+    {
+        Move move = game.moves[i];
+        generateCandidates(board, candidates);
+        const Move* found = std::find(candidates.begin(), candidates.end(), move);
+        if (found == candidates.end() ||
+            !board.movePieceForSimulation(move.fromRow(), move.fromCol(), move.toRow(), move.toCol()))
+        {
+            entry.flags |= GameEntry::Truncated;
+            break;
+        }
+        m_buffer.push_back(static_cast<char>(found - candidates.begin()));
+        board.makeMove(move);
+        entry.plyCount++;
+    }
+
+    m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_offset += m_buffer.size();
+    m_entries.push_back(entry);
+    return static_cast<bool>(m_out);
+}
+
+bool GameDatabaseWriter::finish()
+{
+    if (!m_out.is_open())
+        return false;
+
+    // The entry table is read in place, so align it
+    const char padding[8] = {};
+    m_out.write(padding, static_cast<std::streamsize>((8 - m_offset % 8) % 8));
+    m_offset += (8 - m_offset % 8) % 8;
+
+    DatabaseHeader header = {{'C', 'H', 'G', 'D'}, DATABASE_VERSION, gameCount(), 0, m_offset};
+    m_out.write(reinterpret_cast<const char*>(m_entries.data()),
+                static_cast<std::streamsize>(m_entries.size() * sizeof(GameEntry)));
+    m_out.seekp(0);
+    m_out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_out.close();
+    if (!m_out)
+    {
+        std::cerr << "GameDatabase: failed writing " << m_path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool GameDatabase::open(const std::string& path)
+{
+    close();
+    if (!m_games.open(path) || m_games.size() < sizeof(DatabaseHeader))
+    {
+        std::cerr << "GameDatabase: cannot open " << path << std::endl;
+        m_games.close();
+        return false;
+    }
+
+    DatabaseHeader header;
+    std::memcpy(&header, m_games.data(), sizeof(header));
+    if (std::memcmp(header.magic, "CHGD", 4) != 0 || header.version != DATABASE_VERSION ||
+        header.entriesOffset + uint64_t(header.gameCount) * sizeof(GameEntry) != m_games.size())
+    {
+        std::cerr << "GameDatabase: " << path << " is not a complete game database" << std::endl;
+        m_games.close();
+        return false;
+    }
+
+    m_path = path;
+    m_entries = reinterpret_cast<const GameEntry*>(m_games.data() + header.entriesOffset);
+    m_gameCount = header.gameCount;
+    openIndex();
+    return true;
+}
+
+bool GameDatabase::openIndex()
+{
+    m_index.close();
+    m_positions = nullptr;
+    m_positionCount = 0;
+    if (!m_index.open(indexPath(m_path)) || m_index.size() < sizeof(IndexHeader))
+    {
+        m_index.close();
+        return false;
+    }
+
+    IndexHeader header;
+    std::memcpy(&header, m_index.data(), sizeof(header));
+    if (std::memcmp(header.magic, "CHPI", 4) != 0 || header.version != INDEX_VERSION ||
+        header.gameCount != m_gameCount ||
+        sizeof(IndexHeader) + header.positionCount * sizeof(PositionEntry) != m_index.size())
+    {
+        // Left over from another version of the database; rebuild it
+        m_index.close();
+        return false;
+    }
+    m_positions = reinterpret_cast<const PositionEntry*>(m_index.data() + sizeof(IndexHeader));
+    m_positionCount = header.positionCount;
+    return true;
+}
+
+void GameDatabase::close()
+{
+    m_index.close();
+    m_games.close();
+    m_entries = nullptr;
+    m_gameCount = 0;
+    m_positions = nullptr;
+    m_positionCount = 0;
+}
+
+const uint8_t* GameDatabase::moveCodes(uint32_t game) const
+{
+    const GameEntry& e = m_entries[game];
+    return m_games.data() + e.offset + e.tagBytes;
+}
+
+bool GameDatabase::startPosition(uint32_t game, Board& board) const
+{
+    PgnGame tags;
+    const GameEntry& e = m_entries[game];
+    if (e.flags & GameEntry::CustomStart)
+    {
+        const char* text = reinterpret_cast<const char*>(m_games.data() + e.offset);
+        const char* end = text + e.tagBytes;
+        while (text < end)
+        {
+            const char* name = text;
+            const char* value = name + std::strlen(name) + 1;
+            text = value + std::strlen(value) + 1;
+            if (std::strcmp(name, "FEN") == 0)
+                tags.setTag(name, value);
+        }
+    }
+    return tags.startPosition(board);
+}
+
+bool GameDatabase::positionAt(uint32_t game, int ply, Board& board) const
+{
+    if (game >= m_gameCount || ply > m_entries[game].plyCount || !startPosition(game, board))
+        return false;
+
+    const uint8_t* codes = moveCodes(game);
+    MoveList candidates;
+    for (int i = 0; i < ply; i++)
+    {
+        generateCandidates(board, candidates);
+        if (codes[i] >= candidates.size())
+            return false;
+        board.makeMove(candidates[codes[i]]);
+    }
+    return true;
+}
+
+Move GameDatabase::decodeMove(const Board& board, uint8_t code)
+{
+    MoveList candidates;
+    generateCandidates(board, candidates);
+    return code < candidates.size() ? candidates[code] : Move::none();
+}
+
+bool GameDatabase::readGame(uint32_t game, PgnGame& pgn) const
+{
+    pgn.clear();
+    if (game >= m_gameCount)
+        return false;
+
+    const GameEntry& e = m_entries[game];
+    const char* text = reinterpret_cast<const char*>(m_games.data() + e.offset);
+    const char* end = text + e.tagBytes;
+    while (text < end)
+    {
+        const char* name = text;
+        const char* value = name + std::strlen(name) + 1;
+        text = value + std::strlen(value) + 1;
+        pgn.tags.emplace_back(name, value);
+    }
+    pgn.result = resultText(e.result);
+
+    Board board;
+    if (!pgn.startPosition(board))
+        return false;
+    const uint8_t* codes = moveCodes(game);
+    MoveList candidates;
+    for (int ply = 0; ply < e.plyCount; ply++)
+    {
+        generateCandidates(board, candidates);
+        if (codes[ply] >= candidates.size())
+            return false;
+        pgn.moves.push_back(candidates[codes[ply]]);
+        board.makeMove(candidates[codes[ply]]);
+    }
+    return true;
+}
+
+bool GameDatabase::buildIndex(int threads, size_t memoryBytes)
+{
+    if (!isOpen())
+        return false;
+    if (threads <= 0)
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    size_t runEntries = std::max<size_t>(memoryBytes / sizeof(PositionEntry) / threads, MERGE_BLOCK);
+
+    // Phase 1: replay games in parallel into sorted runs on disk
+    std::string target = indexPath(m_path);
+    std::atomic<uint32_t> nextGame(0);
+    std::atomic<bool> failed(false);
+    std::mutex runMutex;
+    std::vector<std::string> runPaths;
+
+    auto writeRun = [&](std::vector<PositionEntry>& entries)
+    {
+        std::sort(entries.begin(), entries.end(), entryLess);
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(runMutex);
+            path = target + ".run" + std::to_string(runPaths.size());
+            runPaths.push_back(path);
+        }
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(entries.data()),
+                  static_cast<std::streamsize>(entries.size() * sizeof(PositionEntry)));
+        if (!out)
+            failed = true;
+        entries.clear();
+    };
+
+    auto worker = [&]()
+    {
+        std::vector<PositionEntry> entries;
+        entries.reserve(runEntries);
+        MoveList candidates;
+        Board board;
+        while (!failed)
+        {
+            uint32_t first = nextGame.fetch_add(INDEX_BATCH);
+            if (first >= m_gameCount)
+                break;
+            uint32_t last = std::min(first + INDEX_BATCH, m_gameCount);
+            for (uint32_t game = first; game < last; game++)
+            {
+                if (!startPosition(game, board))
+                    continue;
+                const uint8_t* codes = moveCodes(game);
+                int plies = m_entries[game].plyCount;
+                for (int ply = 0; ; ply++)
+                {
+                    entries.push_back({board.getZobristKey(), game, static_cast<uint16_t>(ply), 0});
+                    if (entries.size() >= runEntries)
+                        writeRun(entries);
+                    if (ply == plies)
+                        break;
+                    generateCandidates(board, candidates);
+                    if (codes[ply] >= candidates.size())
+                        break;
+                    board.makeMove(candidates[codes[ply]]);
+                }
+            }
+        }
+        if (!entries.empty())
+            writeRun(entries);
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; i++)
+        pool.emplace_back(worker);
+    for (std::thread& thread : pool)
+        thread.join();
+
+    // Phase 2: merge the runs into the index
+    bool ok = !failed;
+    m_index.close();
+    m_positions = nullptr;
+    m_positionCount = 0;
+    uint64_t count = 0;
+    if (ok)
+    {
+        std::ofstream out(target, std::ios::binary | std::ios::trunc);
+        IndexHeader header = {{'C', 'H', 'P', 'I'}, INDEX_VERSION, m_gameCount, 0, 0};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::vector<RunReader> runs(runPaths.size());
+        auto later = [&runs](size_t a, size_t b) { return entryLess(runs[b].current(), runs[a].current()); };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
+        for (size_t i = 0; i < runs.size(); i++)
+        {
+            runs[i].in.open(runPaths[i], std::ios::binary);
+            if (runs[i].refill())
+                heap.push(i);
+        }
+
+        std::vector<PositionEntry> block;
+        block.reserve(MERGE_BLOCK);
+        while (!heap.empty())
+        {
+            size_t run = heap.top();
+            heap.pop();
+            block.push_back(runs[run].current());
+            if (runs[run].advance())
+                heap.push(run);
+            if (block.size() == MERGE_BLOCK || heap.empty())
+            {
+                out.write(reinterpret_cast<const char*>(block.data()),
+                          static_cast<std::streamsize>(block.size() * sizeof(PositionEntry)));
+                count += block.size();
+                block.clear();
+            }
+        }
+
+        header.positionCount = count;
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.close();
+        ok = static_cast<bool>(out);
+    }
+
+    for (const std::string& path : runPaths)
+        std::remove(path.c_str());
+    if (!ok)
+    {
+        std::cerr << "GameDatabase: failed to build " << target << std::endl;
+        return false;
+    }
+    return openIndex();
+}
+
+GameDatabase::PositionRange GameDatabase::find(uint64_t key) const
+{
+    PositionRange range;
+    if (!m_positions)
+        return range;
+
+    const PositionEntry* end = m_positions + m_positionCount;
+    range.first = std::lower_bound(m_positions, end, key,
+                                   [](const PositionEntry& entry, uint64_t k) { return entry.key < k; });
+    range.last = std::upper_bound(range.first, end, key,
+                                  [](uint64_t k, const PositionEntry& entry) { return k < entry.key; });
+    return range;
+}
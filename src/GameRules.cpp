@@ -0,0 +1,81 @@
+#include "GameRules.h"
+
+int PositionHistory::repetitionCount(int halfmoveClock) const
+{
+    if (m_keys.empty())
+        return 0;
+
+    uint64_t current = m_keys.back();
+    int count = 1;
+    // Only positions with the same side to move can repeat: step back two plies
+    int oldest = std::max(0, static_cast<int>(m_keys.size()) - 1 - halfmoveClock);
+    for (int i = static_cast<int>(m_keys.size()) - 3; i >= oldest; i -= 2)
+    {
+        if (m_keys[i] == current)
+            count++;
+    }
+    return count;
+}
+
+bool hasInsufficientMaterial(const Board& board)
+{
+    int minors = 0;
+    int bishopSquareColors = 0; // bit 0: a light-squared bishop, bit 1: a dark one
+    bool onlyBishops = true;
+
+    for (int row = 0; row < 8; ++row)
+    {
+        for (int col = 0; col < 8; ++col)
+        {
+            Piece piece = board.getPiece(row, col);
+            if (!piece || piece.getType() == PieceType::King)
+                continue;
+
+            switch (piece.getType())
+            {
+            case PieceType::Knight:
+                minors++;
+                onlyBishops = false;
+                break;
+            case PieceType::Bishop:
+                minors++;
+                bishopSquareColors |= ((row + col) % 2 == 0) ? 2 : 1;
+                break;
+            default:
+                return false;
+            }
+        }
+    }
+
+    // K vs K, K+minor vs K, or any number of bishops all on one square color
+    return minors <= 1 || (onlyBishops && bishopSquareColors != 3);
+}
+
+DrawReason checkDrawRules(const Board& board, const PositionHistory& history)
+{
+    if (hasInsufficientMaterial(board))
+        return DrawReason::InsufficientMaterial;
+    if (history.repetitionCount(board.getHalfmoveClock()) >= 3)
+        return DrawReason::ThreefoldRepetition;
+    if (board.getHalfmoveClock() >= 100)
+        return DrawReason::FiftyMoveRule;
+    return DrawReason::None;
+}
+
+GameStatus evaluateGameStatus(const Board& board, const PositionHistory& history)
+{
+    GameStatus status;
+    status.key = history.size() ? history.latest() : board.getZobristKey();
+
+    Color toMove = board.getCurrentTurn();
+    bool inCheck = board.isInCheck(toMove);
+    if (!board.hasLegalMoves(toMove))
+        status.state = inCheck ? GameState::Checkmate : GameState::Stalemate;
+    else
+        status.state = inCheck ? GameState::Check : GameState::Active;
+
+    // Mate on the move that completes a draw condition still counts as mate
+    if (status.state != GameState::Checkmate && status.state != GameState::Stalemate)
+        status.drawReason = checkDrawRules(board, history);
+    return status;
+}
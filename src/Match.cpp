@@ -0,0 +1,556 @@
+#include "Match.h"
+#include "AnalysisCache.h"
+#include "AI.h"
+#include "Board.h"
+#include "GameRules.h"
+#include "StockFish.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+    const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    double eloToScore(double elo)
+    {
+        return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+    }
+
+    double scoreToElo(double score)
+    {
+        score = std::min(std::max(score, 1e-6), 1.0 - 1e-6);
+        return -400.0 * std::log10(1.0 / score - 1.0);
+    }
+
+    // Per-game score variance of a W/D/L sample
+    double scoreVariance(int wins, int draws, int losses)
+    {
+        double n = wins + draws + losses;
+        if (n == 0)
+            return 0.0;
+        double w = wins / n, d = draws / n, l = losses / n;
+        double mean = w + d / 2.0;
+        return w * (1.0 - mean) * (1.0 - mean) + d * (0.5 - mean) * (0.5 - mean) + l * mean * mean;
+    }
+
+    int materialBalance(const Board& board)
+    {
+        static const int values[6] = {0, 900, 500, 310, 300, 100};
+        int balance = 0;
+        for (int row = 0; row < 8; ++row)
+        {
+            for (int col = 0; col < 8; ++col)
+            {
+                Piece piece = board.getPiece(row, col);
+                if (piece)
+                {
+                    int value = values[static_cast<int>(piece.getType())];
+                    balance += (piece.getColor() == Color::White) ? value : -value;
+                }
+            }
+        }
+        return balance;
+    }
+
+    class MatchPlayer
+    {
+    public:
+        virtual ~MatchPlayer() = default;
+        virtual bool start() { return true; }
+        virtual void newGame() {}
+        // Returns Move::none() when the engine fails to produce a legal move.
+        // cached is set when the move came from the analysis cache unsearched.
+        virtual Move chooseMove(const Board& board, uint64_t& nodes, bool& cached) = 0;
+    };
+
+    class BuiltInPlayer : public MatchPlayer
+    {
+    public:
+        explicit BuiltInPlayer(const EngineConfig& config) : m_config(config) {}
+
+        Move chooseMove(const Board& board, uint64_t& nodes, bool& cached) override
+        {
+            cached = false;
+            AI ai(board.getCurrentTurn(), m_config.depth);
+            Move move = ai.findBestMove(board);
+            nodes = ai.getNodeCount();
+            return move;
+        }
+
+    private:
+        EngineConfig m_config;
+    };
+
+    class StockfishPlayer : public MatchPlayer
+    {
+    public:
+        StockfishPlayer(const EngineConfig& config, AnalysisCache* cache) : m_config(config), m_cache(cache) {}
+
+        bool start() override
+        {
+            return m_engine.initialize(m_config.path);
+        }
+
+        void newGame() override
+        {
+            m_engine.newGame();
+        }
+
+        Move chooseMove(const Board& board, uint64_t& nodes, bool& cached) override
+        {
+            uint32_t engineId = AnalysisCache::engineId(m_engine.getEngineName());
+            AnalysisRecord record;
+            Move move;
+            cached = m_cache && m_cache->findMove(board, engineId, m_config.moveTimeMs, m_config.depth, record, move);
+            if (cached)
+            {
+                nodes = 0;
+                return move;
+            }
+
+            EngineSearchResult result = m_engine.search(board, m_config.goCommand());
+            nodes = result.nodes;
+            Move best = uciToMove(board, result.bestMove);
+            if (m_cache)
+                m_cache->storeMove(board, engineId, m_config.moveTimeMs, result.depth, result.score, best, result.nodes);
+            return best;
+        }
+
+    private:
+        EngineConfig m_config;
+        StockfishConnector m_engine;
+        AnalysisCache* m_cache;
+    };
+
+    std::unique_ptr<MatchPlayer> createPlayer(const EngineConfig& config, AnalysisCache* cache)
+    {
+        if (config.kind == EngineConfig::Kind::Stockfish)
+            return std::make_unique<StockfishPlayer>(config, cache);
+        return std::make_unique<BuiltInPlayer>(config);
+    }
+
+    enum class GameEnd
+    {
+        Checkmate,
+        Stalemate,
+        Draw,
+        MaterialAdjudication,
+        MoveLimit,
+        EngineFailure,
+        UnreadableOpening   // not played, and left out of the results
+    };
+
+    struct GameRecord
+    {
+        double whiteScore = 0.5;
+        GameEnd end = GameEnd::MoveLimit;
+        int plies = 0;
+        EngineTiming timing[2]; // [0] white, [1] black
+    };
+
+    GameRecord playGame(const std::string& fen, MatchPlayer* players[2], const MatchOptions& options)
+    {
+        GameRecord record;
+        Board board;
+        if (!board.loadFEN(fen))
+        {
+            std::cerr << "Match: skipping unreadable opening: " << fen << std::endl;
+            record.end = GameEnd::UnreadableOpening;
+            return record;
+        }
+
+        players[0]->newGame();
+        players[1]->newGame();
+
+        PositionHistory history;
+        history.push(board.getZobristKey());
+        int materialStreak = 0;
+
+        for (record.plies = 0; record.plies < options.maxPlies; ++record.plies)
+        {
+            Color toMove = board.getCurrentTurn();
+            int side = (toMove == Color::White) ? 0 : 1;
+
+            if (!board.hasLegalMoves(toMove))
+            {
+                if (board.isInCheck(toMove))
+                {
+                    record.end = GameEnd::Checkmate;
+                    record.whiteScore = (toMove == Color::White) ? 0.0 : 1.0;
+                }
+                else
+                {
+                    record.end = GameEnd::Stalemate;
+                    record.whiteScore = 0.5;
+                }
+                return record;
+            }
+
+            if (checkDrawRules(board, history) != DrawReason::None)
+            {
+                record.end = GameEnd::Draw;
+                record.whiteScore = 0.5;
+                return record;
+            }
+
+            if (options.materialThreshold > 0)
+            {
+                int balance = materialBalance(board);
+                bool decisive = std::abs(balance) >= options.materialThreshold;
+                materialStreak = decisive ? materialStreak + 1 : 0;
+                if (materialStreak >= options.materialPlies)
+                {
+                    record.end = GameEnd::MaterialAdjudication;
+                    record.whiteScore = (balance > 0) ? 1.0 : 0.0;
+                    return record;
+                }
+            }
+
+            uint64_t nodes = 0;
+            bool cached = false;
+            auto start = std::chrono::steady_clock::now();
+            Move move = players[side]->chooseMove(board, nodes, cached);
+            double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            // A cache hit costs no search, so it would only drag the averages down
+            EngineTiming& timing = record.timing[side];
+            if (cached)
+            {
+                timing.cachedMoves++;
+            }
+            else
+            {
+                timing.moves++;
+                timing.nodes += nodes;
+                timing.totalMs += elapsedMs;
+                timing.maxMs = std::max(timing.maxMs, elapsedMs);
+            }
+
+            if (move.isNone())
+            {
+                std::cerr << "Match: engine returned no legal move in " << boardToFEN(board) << std::endl;
+                record.end = GameEnd::EngineFailure;
+                record.whiteScore = (side == 0) ? 0.0 : 1.0;
+                return record;
+            }
+
+            board.makeMove(move);
+            history.push(board.getZobristKey());
+        }
+
+        record.end = GameEnd::MoveLimit;
+        record.whiteScore = 0.5;
+        return record;
+    }
+
+    // One opening per game pair, each a few random legal plies from the start
+    std::vector<std::string> randomOpenings(int count, int plies, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<std::string> openings;
+        MoveList moves;
+        while (static_cast<int>(openings.size()) < count)
+        {
+            Board board;
+            board.loadFEN(START_FEN);
+            bool finished = true;
+            for (int ply = 0; ply < plies && finished; ++ply)
+            {
+                board.generateLegalMoves(board.getCurrentTurn(), moves);
+                if (moves.size() == 0)
+                    finished = false;
+                else
+                    board.makeMove(moves[std::uniform_int_distribution<int>(0, moves.size() - 1)(rng)]);
+            }
+            // A line that ends the game early is drawn again
+            if (finished && board.hasLegalMoves(board.getCurrentTurn()))
+                openings.push_back(boardToFEN(board));
+        }
+        return openings;
+    }
+
+    void addTiming(EngineTiming& total, const EngineTiming& game)
+    {
+        total.moves += game.moves;
+        total.cachedMoves += game.cachedMoves;
+        total.nodes += game.nodes;
+        total.totalMs += game.totalMs;
+        total.maxMs = std::max(total.maxMs, game.maxMs);
+    }
+}
+
+std::string EngineConfig::goCommand() const
+{
+    if (moveTimeMs > 0)
+        return "go movetime " + std::to_string(moveTimeMs);
+    return "go depth " + std::to_string(depth);
+}
+
+double MatchResult::score() const
+{
+    return games() ? (wins + draws * 0.5) / games() : 0.5;
+}
+
+double MatchResult::elo() const
+{
+    return scoreToElo(score());
+}
+
+bool MatchResult::hasEloError() const
+{
+    return games() >= 2 && scoreVariance(wins, draws, losses) > 0.0;
+}
+
+std::string MatchResult::eloErrorText() const
+{
+    if (!hasEloError())
+        return "n/a";
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1) << eloError();
+    return text.str();
+}
+
+double MatchResult::eloError() const
+{
+    if (!hasEloError())
+        return 0.0;
+    double margin = 1.96 * std::sqrt(scoreVariance(wins, draws, losses) / games());
+    return (scoreToElo(score() + margin) - scoreToElo(score() - margin)) / 2.0;
+}
+
+double sprtLogLikelihoodRatio(int wins, int draws, int losses, double elo0, double elo1)
+{
+    int n = wins + draws + losses;
+    double variance = scoreVariance(wins, draws, losses);
+    if (n == 0 || variance <= 0.0)
+        return 0.0;
+
+    double s0 = eloToScore(elo0);
+    double s1 = eloToScore(elo1);
+    double mean = (wins + draws * 0.5) / n;
+    return (s1 - s0) * (2.0 * mean - s0 - s1) / (2.0 * variance / n);
+}
+
+std::vector<std::string> loadOpenings(const std::string& path)
+{
+    std::vector<std::string> openings;
+    std::ifstream file(path);
+    if (!file)
+    {
+        std::cerr << "Cannot open openings file: " << path << std::endl;
+        return openings;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        std::istringstream fields(line);
+        std::string placement, side, castling, enPassant;
+        if (!(fields >> placement >> side >> castling >> enPassant) || placement[0] == '#')
+            continue;
+
+        // Full FEN lines carry the clocks; EPD lines continue with operations
+        std::string halfmove, fullmove;
+        fields >> halfmove >> fullmove;
+        bool hasClocks = !halfmove.empty() && !fullmove.empty() &&
+                         std::all_of(halfmove.begin(), halfmove.end(), ::isdigit) &&
+                         std::all_of(fullmove.begin(), fullmove.end(), ::isdigit);
+        if (!hasClocks)
+        {
+            halfmove = "0";
+            fullmove = "1";
+        }
+
+        std::string fen = placement + " " + side + " " + castling + " " + enPassant + " " + halfmove + " " + fullmove;
+        Board board;
+        if (!board.loadFEN(fen))
+        {
+            std::cerr << "Skipping unreadable opening on line " << lineNumber << " of " << path << std::endl;
+            continue;
+        }
+        openings.push_back(fen);
+    }
+    return openings;
+}
+
+MatchRunner::MatchRunner(const MatchOptions& options) : m_options(options)
+{
+    if (m_options.first.name.empty())
+        m_options.first.name = "first";
+    if (m_options.second.name.empty())
+        m_options.second.name = "second";
+}
+
+MatchResult MatchRunner::run(std::ostream& progress)
+{
+    MatchResult result;
+    std::mutex resultMutex;
+    std::atomic<int> nextGame(0);
+    std::atomic<bool> stop(false);
+
+    // Deterministic engines replay the same two games from one position, so
+    // every pair after the first would only repeat the evidence
+    if (m_options.openings.empty())
+    {
+        if (m_options.useSprt)
+        {
+            progress << "Match: SPRT needs an openings file; the games would repeat from the start position"
+                     << std::endl;
+            return result;
+        }
+        m_options.openings = randomOpenings((m_options.maxGames + 1) / 2, m_options.randomOpeningPlies,
+                                            m_options.seed);
+    }
+
+    // A game that cannot start would otherwise count as a draw
+    auto unreadable = std::remove_if(m_options.openings.begin(), m_options.openings.end(),
+                                     [](const std::string& fen) { return !Board().loadFEN(fen); });
+    if (unreadable != m_options.openings.end())
+    {
+        progress << "Match: skipping " << (m_options.openings.end() - unreadable) << " unreadable openings"
+                 << std::endl;
+        m_options.openings.erase(unreadable, m_options.openings.end());
+    }
+    if (m_options.openings.empty())
+    {
+        progress << "Match: no readable openings" << std::endl;
+        return result;
+    }
+
+    std::set<std::string> distinctOpenings(m_options.openings.begin(), m_options.openings.end());
+    if (distinctOpenings.size() == 1 && m_options.maxGames > 2)
+    {
+        progress << "Warning: every game starts from the same position; deterministic engines will repeat "
+                    "the same two games" << std::endl;
+    }
+
+    const double lowerBound = std::log(m_options.sprt.beta / (1.0 - m_options.sprt.alpha));
+    const double upperBound = std::log((1.0 - m_options.sprt.beta) / m_options.sprt.alpha);
+
+    int threadCount = m_options.concurrency > 0
+        ? m_options.concurrency
+        : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    threadCount = std::min(threadCount, m_options.maxGames);
+
+    // One cache file shared by every worker's engines
+    AnalysisCache cache;
+    AnalysisCache* analysisCache = nullptr;
+    if (!m_options.analysisCachePath.empty())
+    {
+        if (cache.open(m_options.analysisCachePath))
+            analysisCache = &cache;
+    }
+
+    auto worker = [&]()
+    {
+        // Every worker owns its engines, so Stockfish runs one process per thread
+        std::unique_ptr<MatchPlayer> first = createPlayer(m_options.first, analysisCache);
+        std::unique_ptr<MatchPlayer> second = createPlayer(m_options.second, analysisCache);
+        if (!first->start() || !second->start())
+        {
+            std::cerr << "Match: failed to start an engine, worker exiting" << std::endl;
+            return;
+        }
+
+        while (!stop)
+        {
+            int game = nextGame++;
+            if (game >= m_options.maxGames)
+                break;
+
+            // Each opening is played twice so both engines get both colors
+            const std::string& opening = m_options.openings[(game / 2) % m_options.openings.size()];
+            bool firstIsWhite = (game % 2 == 0);
+            MatchPlayer* players[2] = {firstIsWhite ? first.get() : second.get(),
+                                       firstIsWhite ? second.get() : first.get()};
+
+            GameRecord record = playGame(opening, players, m_options);
+            if (record.end == GameEnd::UnreadableOpening)
+                continue;
+            double firstScore = firstIsWhite ? record.whiteScore : 1.0 - record.whiteScore;
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (firstScore > 0.75)
+                result.wins++;
+            else if (firstScore < 0.25)
+                result.losses++;
+            else
+                result.draws++;
+            addTiming(result.timing[0], record.timing[firstIsWhite ? 0 : 1]);
+            addTiming(result.timing[1], record.timing[firstIsWhite ? 1 : 0]);
+
+            progress << "Game " << std::setw(5) << result.games()
+                     << "  +" << result.wins << " -" << result.losses << " =" << result.draws
+                     << std::fixed << std::setprecision(1)
+                     << "  Elo " << result.elo() << " +/- " << result.eloErrorText();
+
+            if (m_options.useSprt)
+            {
+                result.llr = sprtLogLikelihoodRatio(result.wins, result.draws, result.losses,
+                                                    m_options.sprt.elo0, m_options.sprt.elo1);
+                progress << std::setprecision(2) << "  LLR " << result.llr
+                         << " [" << lowerBound << ", " << upperBound << "]";
+                if (result.decision == MatchResult::SprtDecision::None)
+                {
+                    if (result.llr >= upperBound)
+                        result.decision = MatchResult::SprtDecision::AcceptH1;
+                    else if (result.llr <= lowerBound)
+                        result.decision = MatchResult::SprtDecision::AcceptH0;
+                    if (result.decision != MatchResult::SprtDecision::None)
+                        stop = true;
+                }
+            }
+            progress << std::endl;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threadCount; ++i)
+        workers.emplace_back(worker);
+    for (auto& thread : workers)
+        thread.join();
+
+    progress << std::fixed << std::setprecision(1)
+             << "\nResult: " << m_options.first.name << " vs " << m_options.second.name
+             << "  +" << result.wins << " -" << result.losses << " =" << result.draws
+             << "  Elo " << result.elo() << " +/- " << result.eloErrorText() << "\n";
+    if (m_options.useSprt)
+    {
+        progress << "SPRT (" << m_options.sprt.elo0 << ", " << m_options.sprt.elo1 << "): "
+                 << (result.decision == MatchResult::SprtDecision::AcceptH1 ? "H1 accepted"
+                     : result.decision == MatchResult::SprtDecision::AcceptH0 ? "H0 accepted"
+                     : "inconclusive")
+                 << std::setprecision(2) << " (LLR " << result.llr << ")\n";
+    }
+
+    const EngineConfig* configs[2] = {&m_options.first, &m_options.second};
+    for (int i = 0; i < 2; ++i)
+    {
+        const EngineTiming& timing = result.timing[i];
+        progress << std::setprecision(1) << configs[i]->name << ": " << timing.moves << " moves";
+        if (timing.cachedMoves > 0)
+            progress << " (+" << timing.cachedMoves << " from the cache)";
+        progress << ", " << timing.averageMs() << " ms/move avg, " << timing.maxMs << " ms max, "
+                 << std::setprecision(0) << timing.nodesPerSecond() << " nps\n";
+    }
+    if (analysisCache)
+    {
+        progress << "analysis cache: " << analysisCache->hits() << " hits, " << analysisCache->misses()
+                 << " misses, " << analysisCache->size() << " positions\n";
+    }
+
+    return result;
+}
@@ -0,0 +1,236 @@
+#include "OpeningExplorer.h"
+#include "GameDatabase.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    const uint32_t EXPLORER_VERSION = 1;
+
+    struct ExplorerHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t positionCount;
+        uint32_t moveCount;
+        uint32_t sourceGames;   // games in the database it was built from
+        uint32_t reserved;
+    };
+
+    // Totals for one move while its position is aggregated
+    struct MoveTotals {
+        uint8_t code;
+        ExplorerMove stats;
+        uint64_t eloSum;
+        uint32_t eloCount;
+    };
+}
+
+uint32_t OpeningExplorer::MoveRange::games() const
+{
+    uint32_t total = 0;
+    for (const ExplorerMove& move : *this)
+        total += move.games;
+    return total;
+}
+
+bool OpeningExplorer::build(const GameDatabase& database, const std::string& path, int maxPly, uint32_t minGames)
+{
+    if (!database.hasIndex())
+    {
+        std::cerr << "OpeningExplorer: " << database.path() << " has no position index" << std::endl;
+        return false;
+    }
+
+    // Whether an index entry is a game continuing from the position within
+    // the ply limit. Entries are ordered by game and ply, so a repetition
+    // within a game is skipped and each game counts once.
+    auto counts = [&](const PositionEntry* it, const PositionEntry* groupStart)
+    {
+        return (it == groupStart || it[-1].game != it->game) && it->ply <= maxPly &&
+               it->ply < database.entry(it->game).plyCount;
+    };
+
+    std::vector<ExplorerPosition> positions;
+    std::vector<ExplorerMove> moves;
+    std::vector<MoveTotals> totals;
+    Board board;
+
+    // The index is sorted by key, so each position's occurrences are adjacent
+    const PositionEntry* end = database.positions() + database.positionCount();
+    for (const PositionEntry* group = database.positions(); group != end;)
+    {
+        const PositionEntry* groupEnd = group;
+        const PositionEntry* sample = nullptr;
+        uint32_t games = 0;
+        for (; groupEnd != end && groupEnd->key == group->key; ++groupEnd)
+        {
+            if (counts(groupEnd, group))
+            {
+                sample = sample ? sample : groupEnd;
+                games++;
+            }
+        }
+        if (games < minGames || !database.positionAt(sample->game, sample->ply, board))
+        {
+            group = groupEnd;
+            continue;
+        }
+
+        bool whiteMoves = board.getCurrentTurn() == Color::White;
+        totals.clear();
+        for (const PositionEntry* it = group; it != groupEnd; ++it)
+        {
+            if (!counts(it, group))
+                continue;
+            const GameEntry& game = database.entry(it->game);
+            uint8_t code = database.moveCodes(it->game)[it->ply];
+            auto found = std::find_if(totals.begin(), totals.end(),
+                                      [code](const MoveTotals& t) { return t.code == code; });
+            if (found == totals.end())
+            {
+                totals.push_back(MoveTotals{code, {}, 0, 0});
+                found = totals.end() - 1;
+            }
+
+            ExplorerMove& stats = found->stats;
+            stats.games++;
+            stats.whiteWins += game.result == GameResult::WhiteWins;
+            stats.draws += game.result == GameResult::Draw;
+            stats.blackWins += game.result == GameResult::BlackWins;
+            if (stats.games == 1 || game.date > stats.lastDate ||
+                (game.date == stats.lastDate && it->game > stats.lastGame))
+            {
+                stats.lastDate = game.date;
+                stats.lastGame = it->game;
+            }
+            uint16_t elo = whiteMoves ? game.whiteElo : game.blackElo;
+            if (elo)
+            {
+                found->eloSum += elo;
+                found->eloCount++;
+            }
+        }
+
+        ExplorerPosition position = {group->key, static_cast<uint32_t>(moves.size()), 0, 0};
+        for (MoveTotals& t : totals)
+        {
+            Move move = GameDatabase::decodeMove(board, t.code);
+            if (move.isNone())
+                continue;
+            t.stats.move = move.raw();
+            t.stats.averageElo = t.eloCount ? static_cast<uint16_t>(t.eloSum / t.eloCount) : 0;
+            moves.push_back(t.stats);
+            position.moveCount++;
+        }
+        std::sort(moves.begin() + position.firstMove, moves.end(),
+                  [](const ExplorerMove& a, const ExplorerMove& b) { return a.games > b.games; });
+        if (position.moveCount)
+            positions.push_back(position);
+        group = groupEnd;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    ExplorerHeader header = {{'C', 'H', 'O', 'X'}, EXPLORER_VERSION, static_cast<uint32_t>(positions.size()),
+                             static_cast<uint32_t>(moves.size()), database.gameCount(), 0};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(positions.data()),
+              static_cast<std::streamsize>(positions.size() * sizeof(ExplorerPosition)));
+    out.write(reinterpret_cast<const char*>(moves.data()),
+              static_cast<std::streamsize>(moves.size() * sizeof(ExplorerMove)));
+    if (!out)
+    {
+        std::cerr << "OpeningExplorer: failed writing " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool OpeningExplorer::open(const std::string& path)
+{
+    close();
+    if (!m_file.open(path) || m_file.size() < sizeof(ExplorerHeader))
+    {
+        m_file.close();
+        return false;
+    }
+
+    ExplorerHeader header;
+    std::memcpy(&header, m_file.data(), sizeof(header));
+    if (std::memcmp(header.magic, "CHOX", 4) != 0 || header.version != EXPLORER_VERSION ||
+        sizeof(header) + uint64_t(header.positionCount) * sizeof(ExplorerPosition) +
+        uint64_t(header.moveCount) * sizeof(ExplorerMove) != m_file.size())
+    {
+        std::cerr << "OpeningExplorer: " << path << " is not an opening table" << std::endl;
+        m_file.close();
+        return false;
+    }
+
+    m_positions = reinterpret_cast<const ExplorerPosition*>(m_file.data() + sizeof(header));
+    m_moves = reinterpret_cast<const ExplorerMove*>(m_positions + header.positionCount);
+    m_positionCount = header.positionCount;
+    m_moveCount = header.moveCount;
+    return true;
+}
+
+void OpeningExplorer::close()
+{
+    m_file.close();
+    m_positions = nullptr;
+    m_moves = nullptr;
+    m_positionCount = 0;
+    m_moveCount = 0;
+}
+
+OpeningExplorer::MoveRange OpeningExplorer::find(uint64_t key) const
+{
+    MoveRange range;
+    if (!m_positions)
+        return range;
+
+    const ExplorerPosition* end = m_positions + m_positionCount;
+    const ExplorerPosition* found = std::lower_bound(m_positions, end, key,
+        [](const ExplorerPosition& position, uint64_t k) { return position.key < k; });
+    if (found == end || found->key != key || uint64_t(found->firstMove) + found->moveCount > m_moveCount)
+        return range;
+    range.first = m_moves + found->firstMove;
+    range.last = range.first + found->moveCount;
+    return range;
+}
+
+Move OpeningExplorer::bookMove(const Board& board, std::mt19937& rng) const
+{
+    MoveRange range = find(board.getZobristKey());
+    if (range.empty())
+        return Move::none();
+
+    // Moves are sorted most played first
+    uint32_t threshold = std::max(1u, range.first->games / 10);
+    uint32_t total = 0;
+    for (const ExplorerMove& move : range)
+    {
+        if (move.games >= threshold)
+            total += move.games;
+    }
+
+    uint32_t pick = std::uniform_int_distribution<uint32_t>(0, total - 1)(rng);
+    Move chosen = Move::none();
+    for (const ExplorerMove& move : range)
+    {
+        if (move.games < threshold)
+            continue;
+        if (pick < move.games)
+        {
+            chosen = Move::fromRaw(move.move);
+            break;
+        }
+        pick -= move.games;
+    }
+
+    // A key collision could name a move that does not exist here
+    MoveList legalMoves;
+    board.generateLegalMoves(board.getCurrentTurn(), legalMoves);
+    return legalMoves.contains(chosen) ? chosen : Move::none();
+}
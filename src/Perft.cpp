@@ -0,0 +1,213 @@
+#include "Perft.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    // Subtrees this deep are split into tasks per move, down to this many
+    // plies below the root
+    const int SPLIT_DEPTH = 4;
+    const int SPLIT_PLIES = 2;
+
+    struct PerftTask {
+        Board board;
+        int depth;
+        int ply;
+        int root;           // index of the root move the subtree belongs to
+    };
+
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<PerftTask> tasks;
+    };
+
+    uint64_t countLeaves(const Board& board, int depth, PerftHash* hash, uint64_t& hits)
+    {
+        if (depth == 0)
+            return 1;
+
+        uint64_t key = 0;
+        uint64_t count = 0;
+        if (hash && depth >= 2)
+        {
+            key = board.getZobristKey();
+            if (hash->probe(key, depth, count))
+            {
+                hits++;
+                return count;
+            }
+        }
+
+        MoveList moves;
+        board.generateLegalMoves(board.getCurrentTurn(), moves);
+        // Bulk counting: every legal move at the last ply is one leaf
+        if (depth == 1)
+            return moves.size();
+
+        for (Move move : moves)
+        {
+            Board child = board;
+            child.makeMove(move);
+            count += countLeaves(child, depth - 1, hash, hits);
+        }
+        if (hash && depth >= 2)
+            hash->store(key, depth, count);
+        return count;
+    }
+}
+
+PerftHash::PerftHash(size_t bytes)
+{
+    size_t entries = bytes / sizeof(Entry);
+    if (entries == 0)
+        return;
+    while (entries & (entries - 1))
+        entries &= entries - 1;
+    m_entries.reset(new Entry[entries]);
+    for (size_t i = 0; i < entries; ++i)
+    {
+        m_entries[i].check.store(0, std::memory_order_relaxed);
+        m_entries[i].data.store(0, std::memory_order_relaxed);
+    }
+    m_mask = entries - 1;
+}
+
+bool PerftHash::probe(uint64_t key, int depth, uint64_t& count) const
+{
+    const Entry& entry = m_entries[key & m_mask];
+    uint64_t data = entry.data.load(std::memory_order_relaxed);
+    uint64_t check = entry.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != key || (data & 0xFF) != static_cast<uint64_t>(depth))
+        return false;
+    count = data >> 8;
+    return true;
+}
+
+void PerftHash::store(uint64_t key, int depth, uint64_t count)
+{
+    Entry& entry = m_entries[key & m_mask];
+    uint64_t data = count << 8 | static_cast<uint64_t>(depth);
+    entry.check.store(key ^ data, std::memory_order_relaxed);
+    entry.data.store(data, std::memory_order_relaxed);
+}
+
+uint64_t perft(const Board& board, int depth, PerftHash* hash)
+{
+    uint64_t hits = 0;
+    return countLeaves(board, depth, hash && hash->enabled() ? hash : nullptr, hits);
+}
+
+PerftResult runPerft(const Board& board, const PerftOptions& options)
+{
+    PerftResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    MoveList rootMoves;
+    board.generateLegalMoves(board.getCurrentTurn(), rootMoves);
+    for (Move move : rootMoves)
+        result.divide.emplace_back(move, options.depth <= 1 ? 1 : 0);
+    if (options.depth <= 1)
+    {
+        result.nodes = options.depth == 1 ? rootMoves.size() : 1;
+        return result;
+    }
+
+    int threadCount = options.threads > 0
+        ? options.threads
+        : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    result.threads = threadCount;
+
+    PerftHash table(options.hashBytes);
+    PerftHash* hash = table.enabled() ? &table : nullptr;
+
+    // Root moves are dealt round-robin; stealing evens out the rest
+    std::vector<TaskQueue> queues(threadCount);
+    std::vector<std::atomic<uint64_t>> rootCounts(rootMoves.size());
+    for (int i = 0; i < rootMoves.size(); ++i)
+    {
+        Board child = board;
+        child.makeMove(rootMoves[i]);
+        queues[i % threadCount].tasks.push_back(PerftTask{child, options.depth - 1, 1, i});
+        rootCounts[i].store(0, std::memory_order_relaxed);
+    }
+    std::atomic<size_t> pending(rootMoves.size());
+    std::atomic<uint64_t> hashHits(0);
+
+    auto takeTask = [&](int self, PerftTask& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queues[self].mutex);
+            if (!queues[self].tasks.empty())
+            {
+                task = std::move(queues[self].tasks.back());
+                queues[self].tasks.pop_back();
+                return true;
+            }
+        }
+        for (int offset = 1; offset < threadCount; ++offset)
+        {
+            TaskQueue& victim = queues[(self + offset) % threadCount];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto worker = [&](int self)
+    {
+        uint64_t hits = 0;
+        PerftTask task{Board(), 0, 0, 0};
+        while (pending.load() > 0)
+        {
+            if (!takeTask(self, task))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (task.depth >= SPLIT_DEPTH && task.ply < SPLIT_PLIES)
+            {
+                MoveList moves;
+                task.board.generateLegalMoves(task.board.getCurrentTurn(), moves);
+                // Children are counted as pending before this task is finished
+                pending += moves.size();
+                std::lock_guard<std::mutex> lock(queues[self].mutex);
+                for (Move move : moves)
+                {
+                    Board child = task.board;
+                    child.makeMove(move);
+                    queues[self].tasks.push_back(PerftTask{child, task.depth - 1, task.ply + 1, task.root});
+                }
+            }
+            else
+            {
+                rootCounts[task.root] += countLeaves(task.board, task.depth, hash, hits);
+            }
+            pending--;
+        }
+        hashHits += hits;
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i)
+        threads.emplace_back(worker, i);
+    for (std::thread& thread : threads)
+        thread.join();
+
+    for (int i = 0; i < rootMoves.size(); ++i)
+    {
+        result.divide[i].second = rootCounts[i].load();
+        result.nodes += result.divide[i].second;
+    }
+    result.hashHits = hashHits.load();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,214 @@
+#include "PerftValidator.h"
+#include "Board.h"
+#include "Perft.h"
+#include "StockFish.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace
+{
+    // Walks down from board until the move lists differ. Returns true when
+    // every count matches.
+    bool compareWithEngine(StockfishConnector& engine, Board board, int depth, ValidatorFailure& failure,
+                           uint64_t& nodes)
+    {
+        failure.rootFen = boardToFEN(board);
+        bool root = true;
+        for (;;)
+        {
+            std::map<std::string, uint64_t> theirs;
+            uint64_t theirTotal = 0;
+            if (!engine.perft(board, depth, theirs, theirTotal))
+            {
+                failure.fen = boardToFEN(board);
+                failure.error = "no perft result from the engine";
+                return false;
+            }
+            if (root)
+                nodes += theirTotal;
+            root = false;
+
+            MoveList moves;
+            board.generateLegalMoves(board.getCurrentTurn(), moves);
+            std::map<std::string, std::pair<Move, uint64_t>> ours;
+            for (Move move : moves)
+            {
+                Board child = board;
+                child.makeMove(move);
+                ours[move.toUci()] = {move, perft(child, depth - 1)};
+            }
+
+            for (const auto& entry : theirs)
+            {
+                if (!ours.count(entry.first))
+                    failure.missing.push_back(entry.first);
+            }
+            for (const auto& entry : ours)
+            {
+                if (!theirs.count(entry.first))
+                    failure.extra.push_back(entry.first);
+            }
+            if (!failure.missing.empty() || !failure.extra.empty())
+            {
+                failure.fen = boardToFEN(board);
+                return false;
+            }
+
+            // Same moves; descend into the first whose subtree differs
+            auto differs = std::find_if(ours.begin(), ours.end(), [&](const auto& entry) {
+                return entry.second.second != theirs[entry.first];
+            });
+            if (differs == ours.end())
+                return true;
+            failure.line.push_back(differs->first);
+            board.makeMove(differs->second.first);
+            depth--;
+        }
+    }
+
+    void printFailure(std::ostream& out, const ValidatorFailure& failure)
+    {
+        out << "MISMATCH " << failure.rootFen << std::endl;
+        if (!failure.line.empty())
+        {
+            out << "  after";
+            for (const std::string& move : failure.line)
+                out << ' ' << move;
+            out << std::endl;
+        }
+        out << "  at " << failure.fen << std::endl;
+        if (!failure.error.empty())
+            out << "  " << failure.error << std::endl;
+        if (!failure.missing.empty())
+        {
+            out << "  missing";
+            for (const std::string& move : failure.missing)
+                out << ' ' << move;
+            out << std::endl;
+        }
+        if (!failure.extra.empty())
+        {
+            out << "  extra";
+            for (const std::string& move : failure.extra)
+                out << ' ' << move;
+            out << std::endl;
+        }
+    }
+}
+
+const std::vector<std::string>& perftSuitePositions()
+{
+    static const std::vector<std::string> positions = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    };
+    return positions;
+}
+
+PerftValidator::PerftValidator(const ValidatorOptions& options) : m_options(options) {}
+
+std::vector<std::string> PerftValidator::collectPositions() const
+{
+    std::vector<std::string> positions = m_options.positions.empty() ? perftSuitePositions() : m_options.positions;
+    std::vector<std::string> starts = positions;
+
+    // Random play reaches promotions, en passant and lost castling rights the
+    // fixed positions do not
+    std::mt19937 rng(m_options.seed);
+    for (int i = 0; i < m_options.randomPositions && !starts.empty(); ++i)
+    {
+        Board board;
+        if (!board.loadFEN(starts[i % starts.size()]))
+            continue;
+        int plies = std::uniform_int_distribution<int>(1, std::max(1, m_options.maxRandomPlies))(rng);
+        MoveList moves;
+        for (int ply = 0; ply < plies; ++ply)
+        {
+            board.generateLegalMoves(board.getCurrentTurn(), moves);
+            if (moves.size() == 0)
+                break;
+            board.makeMove(moves[std::uniform_int_distribution<int>(0, moves.size() - 1)(rng)]);
+        }
+        positions.push_back(boardToFEN(board));
+    }
+    return positions;
+}
+
+ValidatorReport PerftValidator::run(std::ostream& progress)
+{
+    ValidatorReport report;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> positions = collectPositions();
+
+    int processCount = m_options.processes > 0
+        ? m_options.processes
+        : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    processCount = std::min<int>(processCount, static_cast<int>(positions.size()));
+
+    std::atomic<size_t> nextPosition(0);
+    std::atomic<int> checked(0);
+    std::atomic<uint64_t> nodes(0);
+    std::mutex reportMutex;
+
+    auto worker = [&]()
+    {
+        StockfishConnector engine;
+        if (!engine.initialize(m_options.enginePath))
+        {
+            std::lock_guard<std::mutex> lock(reportMutex);
+            progress << "Cannot start " << m_options.enginePath << std::endl;
+            return;
+        }
+
+        for (size_t i = nextPosition++; i < positions.size(); i = nextPosition++)
+        {
+            Board board;
+            ValidatorFailure failure;
+            uint64_t positionNodes = 0;
+            bool matched;
+            if (!board.loadFEN(positions[i]))
+            {
+                failure.rootFen = failure.fen = positions[i];
+                failure.error = "invalid FEN";
+                matched = false;
+            }
+            else
+            {
+                matched = compareWithEngine(engine, board, m_options.depth, failure, positionNodes);
+            }
+            nodes += positionNodes;
+
+            std::lock_guard<std::mutex> lock(reportMutex);
+            if (!matched)
+            {
+                printFailure(progress, failure);
+                report.failures.push_back(failure);
+            }
+            if (++checked % 100 == 0)
+                progress << checked << "/" << positions.size() << " positions checked" << std::endl;
+        }
+        engine.close();
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < processCount; ++i)
+        threads.emplace_back(worker);
+    for (std::thread& thread : threads)
+        thread.join();
+
+    report.positions = checked.load();
+    report.nodes = nodes.load();
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
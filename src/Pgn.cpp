@@ -0,0 +1,584 @@
+#include "Pgn.h"
+#include "Attacks.h"
+#include <cstring>
+
+namespace
+{
+    const char* const SEVEN_TAG_ROSTER[] = {"Event", "Site", "Date", "Round", "White", "Black", "Result"};
+    const int LINE_WIDTH = 80;
+
+    bool isSpace(int c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    bool isResult(const std::string& token)
+    {
+        return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+    }
+
+    bool isRosterTag(const std::string& name)
+    {
+        for (const char* roster : SEVEN_TAG_ROSTER)
+        {
+            if (name == roster)
+                return true;
+        }
+        return false;
+    }
+
+    PieceType pieceFromLetter(char letter)
+    {
+        switch (letter)
+        {
+        case 'N': return PieceType::Knight;
+        case 'B': return PieceType::Bishop;
+        case 'R': return PieceType::Rook;
+        case 'Q': return PieceType::Queen;
+        default: return PieceType::King;
+        }
+    }
+
+    char letterFromPiece(PieceType type)
+    {
+        switch (type)
+        {
+        case PieceType::Knight: return 'N';
+        case PieceType::Bishop: return 'B';
+        case PieceType::Rook: return 'R';
+        case PieceType::Queen: return 'Q';
+        case PieceType::King: return 'K';
+        default: return 'P';
+        }
+    }
+
+    const Board& initialBoard()
+    {
+        static const Board board = []()
+        {
+            Board start;
+            start.initialize();
+            return start;
+        }();
+        return board;
+    }
+
+    bool isLegal(Board& board, Move move)
+    {
+        return board.movePieceForSimulation(move.fromRow(), move.fromCol(), move.toRow(), move.toCol());
+    }
+
+    Move parseCastle(Board& board, bool kingside)
+    {
+        int row = (board.getCurrentTurn() == Color::White) ? 0 : 7;
+        Move castle(row, 4, row, kingside ? 6 : 2, kingside ? MoveFlag::KingCastle : MoveFlag::QueenCastle);
+        if (board.getPiece(row, 4) != Piece(PieceType::King, board.getCurrentTurn()))
+            return Move::none();
+
+        MoveList moves;
+        board.fastGenerateMoves(castle.from(), moves);
+        return (moves.contains(castle) && isLegal(board, castle)) ? castle : Move::none();
+    }
+
+    Move parseSan(Board& board, const char* san, size_t length)
+    {
+        // Check marks and annotation glyphs carry nothing the board does not know
+        while (length > 0 && std::strchr("+#!?", san[length - 1]))
+            length--;
+        if (length < 2)
+            return Move::none();
+
+        if (san[0] == 'O' || san[0] == '0')
+        {
+            if (length == 3 && (std::memcmp(san, "O-O", 3) == 0 || std::memcmp(san, "0-0", 3) == 0))
+                return parseCastle(board, true);
+            if (length == 5 && (std::memcmp(san, "O-O-O", 5) == 0 || std::memcmp(san, "0-0-0", 5) == 0))
+                return parseCastle(board, false);
+            return Move::none();
+        }
+
+        size_t begin = 0;
+        PieceType type = PieceType::Pawn;
+        if (std::strchr("NBRQK", san[0]))
+        {
+            type = pieceFromLetter(san[0]);
+            begin = 1;
+        }
+
+        // "e8=Q", and the "e8Q" some exporters write
+        size_t end = length;
+        PieceType promotion = PieceType::Queen;
+        if (type == PieceType::Pawn && end >= 3 && std::strchr("NBRQ", san[end - 1]))
+        {
+            promotion = pieceFromLetter(san[end - 1]);
+            end -= (san[end - 2] == '=') ? 2 : 1;
+        }
+
+        if (end < begin + 2)
+            return Move::none();
+        int toCol = san[end - 2] - 'a';
+        int toRow = san[end - 1] - '1';
+        if (toCol < 0 || toCol > 7 || toRow < 0 || toRow > 7)
+            return Move::none();
+        int to = toRow * 8 + toCol;
+
+        // Whatever sits between the piece and the target: disambiguation and
+        // capture marks, or the source square of long algebraic input
+        int fromCol = -1;
+        int fromRow = -1;
+        for (size_t i = begin; i < end - 2; i++)
+        {
+            char c = san[i];
+            if (c >= 'a' && c <= 'h')
+                fromCol = c - 'a';
+            else if (c >= '1' && c <= '8')
+                fromRow = c - '1';
+            else if (c != 'x' && c != ':' && c != '-')
+                return Move::none();
+        }
+
+        // Pawns only leave their file to capture, and a capture names the file
+        if (type == PieceType::Pawn && fromCol < 0)
+            fromCol = toCol;
+
+        Color color = board.getCurrentTurn();
+        Piece wanted(type, color);
+        Piece target = board.getPiece(to);
+        if (target && target.getColor() == color)
+            return Move::none();
+
+        // Walk back from the target along the piece's own steps; the moves
+        // are symmetric, so whatever the walk meets first could have come
+        uint64_t candidates = 0;
+        if (type == PieceType::Pawn)
+        {
+            int back = (color == Color::White) ? -1 : 1;
+            for (int step = 1; step <= 2; step++)
+            {
+                Piece piece = board.getPiece(toRow + back * step, fromCol);
+                if (piece == wanted)
+                    candidates |= Attacks::squareBit((toRow + back * step) * 8 + fromCol);
+                if (piece)
+                    break;
+            }
+        }
+        else
+        {
+            const PieceMovement& movement = PIECE_MOVEMENT[static_cast<int>(type)];
+            for (int d = 0; d < movement.count; d++)
+            {
+                int r = toRow, c = toCol;
+                while (true)
+                {
+                    r += movement.steps[d][0];
+                    c += movement.steps[d][1];
+                    Piece piece = board.getPiece(r, c);
+                    if (piece == wanted)
+                        candidates |= Attacks::squareBit(r * 8 + c);
+                    if (piece || !movement.slides || r < 0 || r > 7 || c < 0 || c > 7)
+                        break;
+                }
+            }
+        }
+        if (fromCol >= 0)
+            candidates &= 0x0101010101010101ULL << fromCol;
+        if (fromRow >= 0)
+            candidates &= 0xFFULL << (fromRow * 8);
+
+        // Only pawns need the generator, for pushes, en passant and promotions
+        int flags = target ? MoveFlag::Capture : MoveFlag::Quiet;
+        Move found = Move::none();
+        MoveList moves;
+        while (candidates)
+        {
+            int square = Attacks::popLsb(candidates);
+            moves.clear();
+            if (type == PieceType::Pawn)
+                board.fastGenerateMoves(square, moves);
+            else
+                moves.push_back(Move(square, to, flags));
+
+            for (Move move : moves)
+            {
+                if (move.to() != to || (move.isPromotion() && move.promotionType() != promotion))
+                    continue;
+                if (!isLegal(board, move))
+                    continue;
+                // Two legal candidates means the SAN was ambiguous
+                if (!found.isNone())
+                    return Move::none();
+                found = move;
+            }
+        }
+        return found;
+    }
+
+    void writeTag(std::ostream& out, const std::string& name, const std::string& value)
+    {
+        out << '[' << name << " \"";
+        for (char c : value)
+        {
+            if (c == '"' || c == '\\')
+                out << '\\';
+            out << c;
+        }
+        out << "\"]\n";
+    }
+}
+
+void PgnGame::clear()
+{
+    tags.clear();
+    moves.clear();
+    result = "*";
+    error.clear();
+}
+
+const std::string* PgnGame::tag(const std::string& name) const
+{
+    for (const auto& tag : tags)
+    {
+        if (tag.first == name)
+            return &tag.second;
+    }
+    return nullptr;
+}
+
+void PgnGame::setTag(const std::string& name, const std::string& value)
+{
+    for (auto& tag : tags)
+    {
+        if (tag.first == name)
+        {
+            tag.second = value;
+            return;
+        }
+    }
+    tags.emplace_back(name, value);
+}
+
+bool PgnGame::startPosition(Board& board) const
+{
+    const std::string* fen = tag("FEN");
+    if (fen)
+        return board.loadFEN(*fen);
+    board = initialBoard();
+    return true;
+}
+
+Move parseSan(Board& board, const std::string& san)
+{
+    return parseSan(board, san.data(), san.size());
+}
+
+std::string moveToSan(const Board& board, Move move)
+{
+    Piece piece = board.getPiece(move.from());
+    std::string san;
+    if (move.isCastle())
+    {
+        san = (move.flags() == MoveFlag::KingCastle) ? "O-O" : "O-O-O";
+    }
+    else if (piece.getType() == PieceType::Pawn)
+    {
+        if (move.isCapture())
+        {
+            san += char('a' + move.fromCol());
+            san += 'x';
+        }
+        san += char('a' + move.toCol());
+        san += char('1' + move.toRow());
+        if (move.isPromotion())
+        {
+            san += '=';
+            san += letterFromPiece(move.promotionType());
+        }
+    }
+    else
+    {
+        // Other pieces of the same kind that could also go to the target
+        Board scratch = board;
+        bool ambiguous = false, sameCol = false, sameRow = false;
+        MoveList moves;
+        for (int square = 0; square < 64; square++)
+        {
+            if (square == move.from() || scratch.getPiece(square) != piece)
+                continue;
+            moves.clear();
+            scratch.fastGenerateMoves(square, moves);
+            for (Move other : moves)
+            {
+                if (other.to() == move.to() && isLegal(scratch, other))
+                {
+                    ambiguous = true;
+                    sameCol |= (square % 8 == move.fromCol());
+                    sameRow |= (square / 8 == move.fromRow());
+                    break;
+                }
+            }
+        }
+
+        san += letterFromPiece(piece.getType());
+        if (ambiguous && (!sameCol || sameRow))
+            san += char('a' + move.fromCol());
+        if (ambiguous && sameCol)
+            san += char('1' + move.fromRow());
+        if (move.isCapture())
+            san += 'x';
+        san += char('a' + move.toCol());
+        san += char('1' + move.toRow());
+    }
+
+    Board after = board;
+    after.makeMove(move);
+    if (after.isInCheck(after.getCurrentTurn()))
+        san += after.hasLegalMoves(after.getCurrentTurn()) ? '+' : '#';
+    return san;
+}
+
+void writePgn(std::ostream& out, const PgnGame& game)
+{
+    for (const char* name : SEVEN_TAG_ROSTER)
+    {
+        const std::string* value = game.tag(name);
+        if (std::strcmp(name, "Result") == 0)
+            writeTag(out, name, game.result);
+        else if (value)
+            writeTag(out, name, *value);
+        else
+            writeTag(out, name, std::strcmp(name, "Date") == 0 ? "????.??.??" : "?");
+    }
+    for (const auto& tag : game.tags)
+    {
+        if (!isRosterTag(tag.first))
+            writeTag(out, tag.first, tag.second);
+    }
+    out << '\n';
+
+    Board board;
+    if (!game.startPosition(board))
+    {
+        out << game.result << "\n\n";
+        return;
+    }
+
+    std::string line;
+    auto emit = [&](const std::string& token)
+    {
+        if (!line.empty() && line.size() + 1 + token.size() > static_cast<size_t>(LINE_WIDTH))
+        {
+            out << line << '\n';
+            line.clear();
+        }
+        if (!line.empty())
+            line += ' ';
+        line += token;
+    };
+
+    for (size_t i = 0; i < game.moves.size(); i++)
+    {
+        bool white = board.getCurrentTurn() == Color::White;
+        if (white || i == 0)
+            emit(std::to_string(board.getFullmoveNumber()) + (white ? "." : "..."));
+        emit(moveToSan(board, game.moves[i]));
+        board.makeMove(game.moves[i]);
+    }
+    emit(game.result);
+    out << line << "\n\n";
+}
+
+PgnReader::PgnReader(std::istream& in) : m_in(in), m_buffer(BUFFER_SIZE)
+{
+}
+
+bool PgnReader::refill()
+{
+    if (!m_in)
+        return false;
+    bool first = (m_bytesRead == 0);
+    m_in.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_end = static_cast<size_t>(m_in.gcount());
+    m_pos = 0;
+    m_bytesRead += m_end;
+    // A UTF-8 byte order mark is not part of the movetext
+    if (first && m_end >= 3 && std::memcmp(m_buffer.data(), "\xEF\xBB\xBF", 3) == 0)
+        m_pos = 3;
+    return m_pos < m_end;
+}
+
+void PgnReader::skipLine()
+{
+    int c;
+    while ((c = get()) >= 0 && c != '\n')
+    {
+    }
+}
+
+void PgnReader::skipComment()
+{
+    get();
+    int c;
+    while ((c = get()) >= 0 && c != '}')
+    {
+    }
+}
+
+void PgnReader::skipVariation()
+{
+    int depth = 0;
+    int c;
+    while ((c = peek()) >= 0)
+    {
+        if (c == '{')
+        {
+            skipComment();
+            continue;
+        }
+        if (c == ';')
+        {
+            skipLine();
+            continue;
+        }
+        advance(c);
+        if (c == '(')
+            depth++;
+        else if (c == ')' && --depth == 0)
+            return;
+    }
+}
+
+bool PgnReader::readTag(PgnGame& game)
+{
+    get();
+    int c;
+    while ((c = peek()) >= 0 && isSpace(c))
+        advance(c);
+
+    m_tagName.clear();
+    while ((c = peek()) >= 0 && !isSpace(c) && c != '"' && c != ']')
+    {
+        m_tagName += static_cast<char>(c);
+        advance(c);
+    }
+    while ((c = peek()) >= 0 && isSpace(c))
+        advance(c);
+
+    m_token.clear();
+    if (c == '"')
+    {
+        advance(c);
+        while ((c = get()) >= 0 && c != '"' && c != '\n')
+        {
+            if (c == '\\' && (peek() == '"' || peek() == '\\'))
+                c = get();
+            m_token += static_cast<char>(c);
+        }
+    }
+    // Anything else up to the bracket is malformed and dropped
+    while (c >= 0 && c != ']' && c != '\n')
+        c = get();
+
+    if (m_tagName.empty())
+        return false;
+    game.tags.emplace_back(m_tagName, m_token);
+    return true;
+}
+
+bool PgnReader::readToken()
+{
+    m_token.clear();
+    int c;
+    while ((c = peek()) >= 0 && !isSpace(c) && !std::strchr("{}()[];", c))
+    {
+        m_token += static_cast<char>(c);
+        advance(c);
+    }
+    return !m_token.empty();
+}
+
+bool PgnReader::next(PgnGame& game)
+{
+    game.clear();
+    bool hasTags = false;
+    bool inMovetext = false;
+
+    int c;
+    while ((c = peek()) >= 0)
+    {
+        if (c == '%' && m_lineStart)
+        {
+            skipLine();
+        }
+        else if (isSpace(c))
+        {
+            advance(c);
+        }
+        else if (c == '[')
+        {
+            // Tags after movetext belong to the next game, which had no result
+            if (inMovetext)
+                break;
+            hasTags |= readTag(game);
+        }
+        else if (c == '{')
+        {
+            skipComment();
+        }
+        else if (c == ';')
+        {
+            skipLine();
+        }
+        else if (c == '(')
+        {
+            skipVariation();
+        }
+        else if (!readToken())
+        {
+            // A stray closing bracket
+            advance(c);
+        }
+        else
+        {
+            if (!inMovetext)
+            {
+                inMovetext = true;
+                if (!game.startPosition(m_board))
+                    game.error = "invalid FEN tag";
+            }
+
+            if (isResult(m_token))
+            {
+                game.result = m_token;
+                break;
+            }
+            if (m_token[0] == '$' || !game.error.empty())
+                continue;
+
+            // Move numbers: "12.", "12...", or fused with the move as "12.e4"
+            size_t start = 0;
+            while (start < m_token.size() && m_token[start] >= '0' && m_token[start] <= '9')
+                start++;
+            if (start < m_token.size() && m_token[start] != '.')
+                start = 0;
+            while (start < m_token.size() && m_token[start] == '.')
+                start++;
+            if (start == m_token.size())
+                continue;
+
+            Move move = parseSan(m_board, m_token.data() + start, m_token.size() - start);
+            if (move.isNone())
+            {
+                game.error = "illegal or unreadable move " + m_token.substr(start) + " at ply " +
+                             std::to_string(game.moves.size() + 1);
+                continue;
+            }
+            m_board.makeMove(move);
+            game.moves.push_back(move);
+        }
+    }
+
+    if (!hasTags && !inMovetext)
+        return false;
+    m_gamesRead++;
+    return true;
+}
@@ -0,0 +1,161 @@
+#include "PieceAtlas.h"
+#include "AssetPack.h"
+#include "RenderBatch.h"
+#include <iostream>
+
+namespace
+{
+    // Indexed like PieceAtlas::rect: [Color][PieceType]
+    const char* const PIECE_IMAGES[2][6] = {
+        {"images/wK.bmp", "images/wQ.bmp", "images/wR.bmp", "images/wB.bmp", "images/wN.bmp", "images/wp.bmp"},
+        {"images/bK.bmp", "images/bQ.bmp", "images/bR.bmp", "images/bB.bmp", "images/bN.bmp", "images/bp.bmp"}
+    };
+
+    SDL_FRect cellRect(int type, int color, int cellSize)
+    {
+        return {(float)(type * cellSize), (float)(color * cellSize), (float)cellSize, (float)cellSize};
+    }
+
+    // A cleared, transparent atlas-shaped target with the solid strip filled
+    // in. Leaves it as the render target.
+    SDL_Texture* createAtlasTarget(SDL_Renderer* renderer, int cellSize)
+    {
+        int width = cellSize * 6;
+        int height = cellSize * 2 + PieceAtlas::SOLID_HEIGHT;
+        SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        if (!texture)
+        {
+            std::cerr << "Failed to create piece atlas: " << SDL_GetError() << std::endl;
+            return nullptr;
+        }
+
+        SDL_SetRenderTarget(renderer, texture);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_FRect solid = {0.0f, (float)(cellSize * 2), (float)width, (float)PieceAtlas::SOLID_HEIGHT};
+        SDL_RenderFillRect(renderer, &solid);
+        return texture;
+    }
+}
+
+PieceAtlas::~PieceAtlas()
+{
+    destroy();
+}
+
+void PieceAtlas::destroy()
+{
+    for (ScaledAtlas& scaled : m_scaled)
+    {
+        SDL_DestroyTexture(scaled.texture);
+    }
+    m_scaled.clear();
+    m_current = -1;
+
+    if (m_source)
+    {
+        SDL_DestroyTexture(m_source);
+        m_source = nullptr;
+    }
+}
+
+bool PieceAtlas::build(SDL_Renderer* renderer, const AssetPack& assets)
+{
+    int cellSize = this->cellSize();
+    destroy();
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    m_source = createAtlasTarget(renderer, SOURCE_CELL_SIZE);
+    if (!m_source)
+    {
+        SDL_SetRenderTarget(renderer, previousTarget);
+        return false;
+    }
+
+    bool complete = true;
+    for (int color = 0; color < 2; color++)
+    {
+        for (int type = 0; type < 6; type++)
+        {
+            SDL_Texture* image = loadImageTexture(renderer, assets, PIECE_IMAGES[color][type]);
+            if (!image)
+            {
+                complete = false;
+                continue;
+            }
+            // Copy the image as is so keyed-out pixels stay transparent in the atlas
+            SDL_SetTextureBlendMode(image, SDL_BLENDMODE_NONE);
+            SDL_FRect dest = cellRect(type, color, SOURCE_CELL_SIZE);
+            SDL_RenderTexture(renderer, image, nullptr, &dest);
+            SDL_DestroyTexture(image);
+        }
+    }
+    SDL_SetRenderTarget(renderer, previousTarget);
+
+    if (!complete)
+    {
+        destroy();
+        return false;
+    }
+
+    // The source is only ever copied, filtered, into the scaled atlases
+    SDL_SetTextureBlendMode(m_source, SDL_BLENDMODE_NONE);
+    SDL_SetTextureScaleMode(m_source, SDL_SCALEMODE_LINEAR);
+    return cellSize == 0 || setCellSize(renderer, cellSize);
+}
+
+bool PieceAtlas::setCellSize(SDL_Renderer* renderer, int cellSize)
+{
+    if (!m_source || cellSize <= 0)
+        return false;
+
+    for (int i = 0; i < (int)m_scaled.size(); i++)
+    {
+        if (m_scaled[i].cellSize == cellSize)
+        {
+            m_current = i;
+            m_scaled[i].lastUsed = ++m_useCount;
+            return true;
+        }
+    }
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    SDL_Texture* texture = createAtlasTarget(renderer, cellSize);
+    if (!texture)
+    {
+        SDL_SetRenderTarget(renderer, previousTarget);
+        return false;
+    }
+
+    RenderBatch batch;
+    batch.setTexture(m_source, SOURCE_CELL_SIZE * 6.0f, SOURCE_CELL_SIZE * 2.0f + SOLID_HEIGHT, 0.0f, 0.0f);
+    for (int color = 0; color < 2; color++)
+    {
+        for (int type = 0; type < 6; type++)
+        {
+            batch.addTexturedRect(cellRect(type, color, cellSize), cellRect(type, color, SOURCE_CELL_SIZE));
+        }
+    }
+    batch.draw(renderer);
+    SDL_SetRenderTarget(renderer, previousTarget);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    if ((int)m_scaled.size() >= MAX_CACHED_SIZES)
+    {
+        int oldest = 0;
+        for (int i = 1; i < (int)m_scaled.size(); i++)
+        {
+            if (m_scaled[i].lastUsed < m_scaled[oldest].lastUsed)
+                oldest = i;
+        }
+        SDL_DestroyTexture(m_scaled[oldest].texture);
+        m_scaled.erase(m_scaled.begin() + oldest);
+    }
+
+    m_scaled.push_back({cellSize, texture, ++m_useCount});
+    m_current = (int)m_scaled.size() - 1;
+    return true;
+}
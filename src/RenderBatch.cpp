@@ -0,0 +1,81 @@
+#include "RenderBatch.h"
+#include <iostream>
+
+namespace
+{
+    SDL_Vertex makeVertex(float x, float y, float u, float v, SDL_Color color)
+    {
+        SDL_Vertex vertex;
+        vertex.position.x = x;
+        vertex.position.y = y;
+        vertex.tex_coord.x = u;
+        vertex.tex_coord.y = v;
+#ifdef USE_SDL2
+        vertex.color = color;
+#else
+        // SDL3 vertices carry float colors
+        vertex.color.r = color.r / 255.0f;
+        vertex.color.g = color.g / 255.0f;
+        vertex.color.b = color.b / 255.0f;
+        vertex.color.a = color.a / 255.0f;
+#endif
+        return vertex;
+    }
+}
+
+void RenderBatch::setTexture(SDL_Texture* texture, float width, float height, float solidX, float solidY)
+{
+    m_texture = texture;
+    m_width = width;
+    m_height = height;
+    m_solidU = solidX / width;
+    m_solidV = solidY / height;
+}
+
+void RenderBatch::clear()
+{
+    m_vertices.clear();
+    m_indices.clear();
+}
+
+void RenderBatch::addQuad(const SDL_FRect& dst, float u0, float v0, float u1, float v1, SDL_Color color)
+{
+    int base = static_cast<int>(m_vertices.size());
+    m_vertices.push_back(makeVertex(dst.x, dst.y, u0, v0, color));
+    m_vertices.push_back(makeVertex(dst.x + dst.w, dst.y, u1, v0, color));
+    m_vertices.push_back(makeVertex(dst.x + dst.w, dst.y + dst.h, u1, v1, color));
+    m_vertices.push_back(makeVertex(dst.x, dst.y + dst.h, u0, v1, color));
+
+    const int corners[6] = {0, 1, 2, 0, 2, 3};
+    for (int corner : corners)
+        m_indices.push_back(base + corner);
+}
+
+void RenderBatch::addTexturedRect(const SDL_FRect& dst, const SDL_FRect& src, SDL_Color color)
+{
+    addQuad(dst, src.x / m_width, src.y / m_height,
+            (src.x + src.w) / m_width, (src.y + src.h) / m_height, color);
+}
+
+void RenderBatch::addFilledRect(const SDL_FRect& dst, SDL_Color color)
+{
+    addQuad(dst, m_solidU, m_solidV, m_solidU, m_solidV, color);
+}
+
+void RenderBatch::draw(SDL_Renderer* renderer) const
+{
+    if (m_indices.empty())
+        return;
+
+    int vertexCount = static_cast<int>(m_vertices.size());
+    int indexCount = static_cast<int>(m_indices.size());
+#ifdef USE_SDL2
+    bool drawn = SDL_RenderGeometry(renderer, m_texture, m_vertices.data(), vertexCount, m_indices.data(), indexCount) == 0;
+#else
+    bool drawn = SDL_RenderGeometry(renderer, m_texture, m_vertices.data(), vertexCount, m_indices.data(), indexCount);
+#endif
+    if (!drawn)
+    {
+        std::cerr << "SDL_RenderGeometry failed: " << SDL_GetError() << std::endl;
+    }
+}
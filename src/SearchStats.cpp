@@ -0,0 +1,60 @@
+#include "SearchStats.h"
+#include <sstream>
+
+double SearchStats::branchingFactor() const
+{
+    if (depths.size() < 2 || depths[depths.size() - 2].nodes == 0)
+        return 0.0;
+    return double(depths.back().nodes) / depths[depths.size() - 2].nodes;
+}
+
+std::string SearchStats::toJson() const
+{
+    std::ostringstream out;
+    out << "{\"enabled\":" << (enabled ? "true" : "false")
+        << ",\"nodes\":" << nodes
+        << ",\"qnodes\":" << qnodes
+        << ",\"nps\":" << static_cast<uint64_t>(nodesPerSecond())
+        << ",\"time_ms\":" << elapsedMs
+        << ",\"eval_calls\":" << evalCalls
+        << ",\"beta_cutoffs\":" << betaCutoffs
+        << ",\"first_move_cutoff_rate\":" << firstMoveCutoffRate()
+        << ",\"tt_probes\":" << ttProbes
+        << ",\"tt_hit_rate\":" << ttHitRate()
+        << ",\"tt_cutoff_rate\":" << ttCutoffRate()
+        << ",\"branching_factor\":" << branchingFactor()
+        << ",\"depths\":[";
+    for (size_t i = 0; i < depths.size(); ++i)
+    {
+        const DepthStats& d = depths[i];
+        out << (i ? "," : "")
+            << "{\"depth\":" << d.depth
+            << ",\"score\":" << d.score
+            << ",\"nodes\":" << d.nodes
+            << ",\"time_ms\":" << d.elapsedMs
+            << ",\"best\":\"" << d.bestMove << "\"}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+std::vector<std::string> SearchStats::toUciInfo() const
+{
+    std::vector<std::string> lines;
+    uint64_t totalNodes = 0;
+    double totalMs = 0.0;
+    for (const DepthStats& d : depths)
+    {
+        totalNodes += d.nodes;
+        totalMs += d.elapsedMs;
+        std::ostringstream line;
+        line << "info depth " << d.depth
+             << " score cp " << d.score
+             << " nodes " << totalNodes
+             << " nps " << static_cast<uint64_t>(totalMs > 0.0 ? totalNodes * 1000.0 / totalMs : 0.0)
+             << " time " << static_cast<uint64_t>(totalMs)
+             << " pv " << d.bestMove;
+        lines.push_back(line.str());
+    }
+    return lines;
+}
@@ -0,0 +1,198 @@
+#include "SearchWorker.h"
+#include "AI.h"
+#include "Trace.h"
+#include <chrono>
+#include <iostream>
+
+SearchWorker::SearchWorker()
+{
+    m_thread = std::thread(&SearchWorker::run, this);
+}
+
+SearchWorker::~SearchWorker()
+{
+    Command quit;
+    quit.type = CommandType::Quit;
+    push(quit);
+    m_thread.join();
+}
+
+void SearchWorker::push(Command command)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        // Every command supersedes the search in progress
+        m_stop = true;
+        m_queue.push_back(std::move(command));
+    }
+    // Stockfish does not poll m_stop; it has to be told
+    m_stockfish.stopEngine();
+    m_queueReady.notify_one();
+}
+
+uint32_t SearchWorker::start(const Board& board, const EngineConfig& engine)
+{
+    Command command;
+    command.type = CommandType::Start;
+    command.searchId = ++m_nextSearchId;
+    command.board = board;
+    command.engine = engine;
+    push(command);
+    return command.searchId;
+}
+
+void SearchWorker::stop()
+{
+    Command command;
+    command.type = CommandType::Stop;
+    push(command);
+}
+
+void SearchWorker::newGame(const EngineConfig& engine)
+{
+    Command command;
+    command.type = CommandType::NewGame;
+    command.engine = engine;
+    push(command);
+}
+
+void SearchWorker::warmUp(const EngineConfig& engine)
+{
+    Command command;
+    command.type = CommandType::WarmUp;
+    command.engine = engine;
+    push(command);
+}
+
+void SearchWorker::run()
+{
+    while (true)
+    {
+        Command command;
+        bool superseded = false;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueReady.wait(lock, [this] { return !m_queue.empty(); });
+            command = std::move(m_queue.front());
+            m_queue.pop_front();
+            // A search with newer commands behind it was cancelled before it began
+            superseded = !m_queue.empty();
+            m_stop = superseded;
+        }
+
+        switch (command.type)
+        {
+        case CommandType::Quit:
+            return;
+        case CommandType::Stop:
+            break;
+        case CommandType::NewGame:
+            if (command.engine.kind == EngineConfig::Kind::Stockfish && prepareStockfish(command.engine))
+                m_stockfish.newGame();
+            break;
+        case CommandType::WarmUp:
+            if (command.engine.kind == EngineConfig::Kind::Stockfish)
+                prepareStockfish(command.engine);
+            break;
+        case CommandType::Start:
+            if (!superseded)
+                search(command);
+            break;
+        }
+    }
+}
+
+bool SearchWorker::prepareStockfish(const EngineConfig& engine)
+{
+    if (m_stockfishReady && m_stockfishPath == engine.path)
+        return true;
+
+    m_stockfish.close();
+    m_stockfishPath = engine.path;
+    m_stockfishReady = m_stockfish.initialize(engine.path);
+    if (!m_stockfishReady)
+        std::cerr << "SearchWorker: Stockfish unavailable at " << engine.path << ", using the built-in AI" << std::endl;
+    return m_stockfishReady;
+}
+
+Move SearchWorker::searchBuiltIn(const Command& command, const EngineConfig& engine, SearchReport& report)
+{
+    AI ai(command.board.getCurrentTurn(), engine.depth);
+    ai.setStopFlag(&m_stop);
+    ai.setOpeningBook(m_openingBook, static_cast<uint32_t>(m_bookRng()));
+    ai.setProgressCallback([this, &report](const DepthStats& iteration, Move best)
+    {
+        report.depth = iteration.depth;
+        report.score = iteration.score;
+        report.nodes += iteration.nodes;
+        report.elapsedMs += iteration.elapsedMs;
+        report.bestMove = best;
+        m_mailbox.publish(report);
+    });
+    return ai.findBestMove(command.board);
+}
+
+Move SearchWorker::searchStockfish(const Command& command, SearchReport& report)
+{
+    const EngineConfig& engine = command.engine;
+    uint32_t engineId = AnalysisCache::engineId(m_stockfish.getEngineName());
+
+    auto start = std::chrono::steady_clock::now();
+    AnalysisRecord cached;
+    Move move;
+    if (m_analysisCache.findMove(command.board, engineId, engine.moveTimeMs, engine.depth, cached, move))
+    {
+        report.depth = cached.depth;
+        report.score = cached.score;
+        report.nodes = cached.nodes;
+        report.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return move;
+    }
+
+    // A stop makes Stockfish answer at once with its best move so far
+    EngineSearchResult result = m_stockfish.search(command.board, engine.goCommand(), &m_stop);
+    report.depth = result.depth;
+    report.score = result.score;
+    report.nodes = result.nodes;
+    report.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    Move best = uciToMove(command.board, result.bestMove);
+    // An interrupted search would pass for a full one of its movetime
+    if (!m_stop)
+        m_analysisCache.storeMove(command.board, engineId, engine.moveTimeMs, result.depth, result.score, best,
+                                  result.nodes);
+    return best;
+}
+
+void SearchWorker::search(const Command& command)
+{
+    if (Trace::isEnabled())
+        Trace::setThreadName("Search worker");
+    TRACE_ZONE("SearchWorker::search");
+    SearchReport report;
+    report.searchId = command.searchId;
+
+    Move best = Move::none();
+    bool useStockfish = command.engine.kind == EngineConfig::Kind::Stockfish &&
+                        prepareStockfish(command.engine) && m_stockfish.ensureEngineRunning();
+    if (useStockfish)
+    {
+        best = searchStockfish(command, report);
+        if (best.isNone() && !m_stop && command.board.hasLegalMoves(command.board.getCurrentTurn()))
+        {
+            std::cerr << "SearchWorker: no usable Stockfish move, using the built-in AI" << std::endl;
+            useStockfish = false;
+        }
+    }
+
+    if (!useStockfish)
+    {
+        // The built-in fallback keeps the depth the GUI has always used for it
+        EngineConfig builtIn;
+        builtIn.depth = (command.engine.kind == EngineConfig::Kind::BuiltIn) ? command.engine.depth : 2;
+        best = searchBuiltIn(command, builtIn, report);
+    }
+
+    report.bestMove = best;
+    report.finished = true;
+    m_mailbox.publish(report);
+}
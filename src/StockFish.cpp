@@ -1,4 +1,5 @@
 #include "StockFish.h"
+#include "Trace.h"
 #include <iostream>
 #include <sstream>
 #include <chrono>
@@ -7,6 +8,7 @@
 #include <string>
 #include <unistd.h>
 #include <algorithm>
+#include <cstdlib>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -15,12 +17,20 @@
 #else
 #include <sys/wait.h>
 #include <fcntl.h>
+#include <spawn.h>
+#include <cstring>
+
+extern char** environ;
 #endif
 
 StockfishConnector::StockfishConnector() : stockfishProcess(nullptr), initialized(false)
 #ifdef _WIN32
                                            ,
                                            childProcess(NULL), childStdin(NULL), childStdout(NULL)
+#else
+                                           ,
+                                           stockfish_pid(0), stockfish_in_fd(-1), stockfish_out_fd(-1),
+                                           stockfishIn(nullptr), stockfishOut(nullptr)
 #endif
 {
 }
@@ -30,6 +40,19 @@ StockfishConnector::~StockfishConnector()
     close();
 }
 
+namespace
+{
+    // The engine's "id name", or its path if it sent none
+    std::string parseEngineName(const std::string& uciOutput, const std::string& path)
+    {
+        size_t pos = uciOutput.find("id name ");
+        if (pos == std::string::npos)
+            return path;
+        std::string name = uciOutput.substr(pos + 8);
+        return name.substr(0, name.find_first_of("\r\n"));
+    }
+}
+
 #ifdef _WIN32
 
 void StockfishConnector::close()
@@ -212,6 +235,7 @@ bool StockfishConnector::initialize(const std::string &pathToStockfish)
     }
 
     // Store handles for later use
+    enginePath = pathToStockfish;
     childProcess = piProcInfo.hProcess;
     childStdin = hChildStdin_Write;
     childStdout = hChildStdout_Read;
@@ -262,11 +286,13 @@ bool StockfishConnector::initialize(const std::string &pathToStockfish)
         }
     }
 
+    engineName = parseEngineName(output, pathToStockfish);
     return true;
 }
 
 std::string StockfishConnector::getEngineOutput()
 {
+    TRACE_ZONE("StockfishConnector::getEngineOutput");
     // Check for valid handles instead of just initialized flag
     if (!childProcess || !childStdout)
     {
@@ -404,6 +430,7 @@ std::string StockfishConnector::getEngineOutput()
 
 void StockfishConnector::writeCommand(const std::string &cmd)
 {
+    TRACE_ZONE("StockfishConnector::writeCommand");
     if (!initialized || !childProcess || !childStdin || childStdin == INVALID_HANDLE_VALUE)
     {
         std::cerr << "Cannot write command - pipe or process invalid" << std::endl;
@@ -432,9 +459,6 @@ void StockfishConnector::writeCommand(const std::string &cmd)
         DWORD error = GetLastError();
         std::cerr << "DEBUG: Failed to flush pipe. Error code: " << error << std::endl;
     }
-
-    // Give Stockfish a moment to process the command
-    std::this_thread::sleep_for(std::chrono::milliseconds(20));
 }
 
 #else
@@ -447,16 +471,12 @@ bool StockfishConnector::initialize(const std::string &pathToStockfish)
         close();
     }
     
-    std::cout << "Attempting to initialize Stockfish at: " << pathToStockfish << std::endl;
-    
     // Find executable path
     std::string execPath = pathToStockfish;
     if (access(execPath.c_str(), X_OK) != 0) {
         // Try adding ./ if not already present
         if (pathToStockfish.substr(0,2) != "./") {
             std::string altPath = "./" + pathToStockfish;
-            std::cout << "Trying alternate path with ./ prefix: " << altPath << std::endl;
-            
             if (access(altPath.c_str(), X_OK) == 0) {
                 execPath = altPath;
             } else if (access("/usr/bin/stockfish", X_OK) == 0) {
@@ -477,67 +497,59 @@ bool StockfishConnector::initialize(const std::string &pathToStockfish)
     int stdin_pipe[2];  // Parent writes to [1], child reads from [0]
     int stdout_pipe[2]; // Child writes to [1], parent reads from [0]
     
-    if (pipe(stdin_pipe) < 0 || pipe(stdout_pipe) < 0) {
+    if (pipe(stdin_pipe) < 0) {
         std::perror("Failed to create pipes");
         return false;
     }
-    
-    // Fork a child process
-    pid_t child_pid = fork();
-    
-    if (child_pid < 0) {
-        std::perror("Failed to fork process");
+    if (pipe(stdout_pipe) < 0) {
+        std::perror("Failed to create pipes");
         ::close(stdin_pipe[0]);
         ::close(stdin_pipe[1]);
-        ::close(stdout_pipe[0]);
-        ::close(stdout_pipe[1]);
         return false;
     }
-    
-    if (child_pid == 0) {
-        // Child process
-        
-        // Close unused pipe ends
-        ::close(stdin_pipe[1]);
-        ::close(stdout_pipe[0]);
-        
-        // Redirect stdin to read from parent
-        dup2(stdin_pipe[0], STDIN_FILENO);
-        ::close(stdin_pipe[0]);
-        
-        // Redirect stdout to write to parent
-        dup2(stdout_pipe[1], STDOUT_FILENO);
-        ::close(stdout_pipe[1]);
-        
-        int devnull = open("/dev/null", O_WRONLY);
-        if (devnull >= 0) {
-            dup2(devnull, STDERR_FILENO);
-            ::close(devnull);
-        }
-        
 
-        // Execute stockfish
-        execlp(execPath.c_str(), execPath.c_str(), NULL);
-        
-        // If we get here, execlp failed
-        std::perror("Failed to execute Stockfish");
-        exit(1);
-    }
-    
-    // Parent process
-    
-    // Close unused pipe ends
+    // The parent's ends must not leak into the engine
+    fcntl(stdin_pipe[1], F_SETFD, FD_CLOEXEC);
+    fcntl(stdout_pipe[0], F_SETFD, FD_CLOEXEC);
+
+    // posix_spawn avoids copying the address space of a process that
+    // already holds a renderer and decoded images, as fork would
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, stdin_pipe[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, stdout_pipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addclose(&actions, stdin_pipe[0]);
+    posix_spawn_file_actions_addclose(&actions, stdout_pipe[1]);
+
+    char* argv[] = {const_cast<char*>(execPath.c_str()), nullptr};
+    pid_t child_pid = 0;
+    int spawnError = posix_spawnp(&child_pid, execPath.c_str(), &actions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+
+    // Close the child's pipe ends
     ::close(stdin_pipe[0]);
     ::close(stdout_pipe[1]);
+
+    if (spawnError != 0) {
+        std::cerr << "Failed to start Stockfish: " << std::strerror(spawnError) << std::endl;
+        ::close(stdin_pipe[1]);
+        ::close(stdout_pipe[0]);
+        return false;
+    }
     
     // Store file descriptors for communication
     stockfish_in_fd = stdin_pipe[1];
     stockfish_out_fd = stdout_pipe[0];
     stockfish_pid = child_pid;
+    enginePath = execPath;
     
     // Convert file descriptors to FILE* for easier I/O
     stockfishIn = fdopen(stockfish_in_fd, "w");
     stockfishOut = fdopen(stockfish_out_fd, "r");
+
+    // From here on close() reaps the process if the handshake fails
+    initialized = true;
     
     if (!stockfishIn || !stockfishOut) {
         std::perror("Failed to create FILE streams");
@@ -545,8 +557,6 @@ bool StockfishConnector::initialize(const std::string &pathToStockfish)
         return false;
     }
     
-    std::cout << "Stockfish process started successfully" << std::endl;
-    
     // Initialize UCI protocol
     fprintf(stockfishIn, "uci\n");
     fflush(stockfishIn);
@@ -556,7 +566,6 @@ bool StockfishConnector::initialize(const std::string &pathToStockfish)
     int timeout = 0;
     while (fgets(buffer, sizeof(buffer), stockfishOut) != nullptr) {
         output += buffer;
-        std::cout << "UCI response: " << buffer;
         if (output.find("uciok") != std::string::npos) {
             break;
         }
@@ -575,8 +584,7 @@ bool StockfishConnector::initialize(const std::string &pathToStockfish)
         close();
         return false;
     }
-    
-    std::cout << "UCI protocol initialized" << std::endl;
+    engineName = parseEngineName(output, execPath);
     
     // Ensure engine is ready
     fprintf(stockfishIn, "isready\n");
@@ -586,7 +594,6 @@ bool StockfishConnector::initialize(const std::string &pathToStockfish)
     timeout = 0;
     while (fgets(buffer, sizeof(buffer), stockfishOut) != nullptr) {
         output += buffer;
-        std::cout << "isready response: " << buffer;
         if (output.find("readyok") != std::string::npos) {
             break;
         }
@@ -606,8 +613,6 @@ bool StockfishConnector::initialize(const std::string &pathToStockfish)
         return false;
     }
     
-    std::cout << "Stockfish initialization successful!" << std::endl;
-    initialized = true;
     return true;
 }
 
@@ -620,12 +625,18 @@ void StockfishConnector::close()
             fflush(stockfishIn);
             fclose(stockfishIn);
             stockfishIn = nullptr;
+        } else if (stockfish_in_fd >= 0) {
+            ::close(stockfish_in_fd);
         }
         
         if (stockfishOut) {
             fclose(stockfishOut);
             stockfishOut = nullptr;
+        } else if (stockfish_out_fd >= 0) {
+            ::close(stockfish_out_fd);
         }
+        stockfish_in_fd = -1;
+        stockfish_out_fd = -1;
         
         // Wait for process to terminate
         if (stockfish_pid > 0) {
@@ -655,6 +666,7 @@ std::string StockfishConnector::sendCommand(const std::string &cmd)
 
 std::string StockfishConnector::getEngineOutput()
 {
+    TRACE_ZONE("StockfishConnector::getEngineOutput");
     if (!initialized || !stockfishIn || !stockfishOut)
     {
         return "";
@@ -696,6 +708,7 @@ std::string StockfishConnector::getEngineOutput()
 
 void StockfishConnector::writeCommand(const std::string &cmd)
 {
+    TRACE_ZONE("StockfishConnector::writeCommand");
     if (!initialized || !stockfishIn)
     {
         std::cerr << "Cannot write command - pipe or process invalid" << std::endl;
@@ -712,9 +725,6 @@ void StockfishConnector::writeCommand(const std::string &cmd)
     // Write command to pipe
     fprintf(stockfishIn, "%s", fullCmd.c_str());
     fflush(stockfishIn);
-
-    // Give Stockfish a moment to process the command
-    std::this_thread::sleep_for(std::chrono::milliseconds(20));
 }
 
 #endif
@@ -725,14 +735,13 @@ std::string boardToFEN(const Board &board)
 {
     std::stringstream fen;
 
-    // In standard FEN notation, the 8th rank (top) is first, 1st rank (bottom) is last
-    // Since your board is inverted, we need to invert it back
+    // FEN lists rank 8 first; row 0 of the board is rank 1
     for (int row = 7; row >= 0; --row)
-    { // Iterate from 7 to 0 (top to bottom in standard notation)
+    {
         int emptyCount = 0;
         for (int col = 0; col < 8; ++col)
         {
-            auto piece = board.getPiece(7 - row, col); // Flip row index to match your board
+            auto piece = board.getPiece(row, col);
             if (piece)
             {
                 if (emptyCount > 0)
@@ -742,7 +751,7 @@ std::string boardToFEN(const Board &board)
                 }
 
                 char pieceChar;
-                switch (piece->getType())
+                switch (piece.getType())
                 {
                 case PieceType::Pawn:
                     pieceChar = 'p';
@@ -767,8 +776,7 @@ std::string boardToFEN(const Board &board)
                     break;
                 }
 
-                // Swap colors too - your white is standard black and vice versa
-                if (piece->getColor() == Color::Black)
+                if (piece.getColor() == Color::White)
                 {
                     pieceChar = std::toupper(pieceChar);
                 }
@@ -792,27 +800,27 @@ std::string boardToFEN(const Board &board)
         }
     }
 
-    // Active color - invert this too
-    fen << ' ' << (board.getCurrentTurn() == Color::Black ? 'w' : 'b') << ' ';
+    // Active color
+    fen << ' ' << (board.getCurrentTurn() == Color::White ? 'w' : 'b') << ' ';
 
-    // Castling rights need to be inverted too
+    // Castling rights
     bool hasCastling = false;
-    if (board.canCastleKingside(Color::Black))
+    if (board.canCastleKingside(Color::White))
     {
         fen << 'K';
         hasCastling = true;
     }
-    if (board.canCastleQueenside(Color::Black))
+    if (board.canCastleQueenside(Color::White))
     {
         fen << 'Q';
         hasCastling = true;
     }
-    if (board.canCastleKingside(Color::White))
+    if (board.canCastleKingside(Color::Black))
     {
         fen << 'k';
         hasCastling = true;
     }
-    if (board.canCastleQueenside(Color::White))
+    if (board.canCastleQueenside(Color::Black))
     {
         fen << 'q';
         hasCastling = true;
@@ -823,13 +831,13 @@ std::string boardToFEN(const Board &board)
         fen << '-';
     }
 
-    // En passant target square needs to be flipped too
+    // En passant target square
     fen << ' ';
     auto epTarget = board.getEnPassantTarget();
     if (epTarget.first != -1 && epTarget.second != -1)
     {
         char file = 'a' + epTarget.second;
-        char rank = '1' + (7 - epTarget.first); // Flip the rank
+        char rank = '1' + epTarget.first;
         fen << file << rank;
     }
     else
@@ -837,8 +845,8 @@ std::string boardToFEN(const Board &board)
         fen << '-';
     }
 
-    // Halfmove clock and fullmove number (simplified)
-    fen << " 0 1";
+    // Halfmove clock and fullmove number
+    fen << ' ' << board.getHalfmoveClock() << ' ' << board.getFullmoveNumber();
 
     return fen.str();
 }
@@ -851,15 +859,9 @@ std::tuple<int, int, int, int> algebraicToCoordinates(const std::string &move)
     }
 
     int fromCol = move[0] - 'a';
-    int fromRow = 7 - (move[1] - '1'); // Convert from standard to your inverted board
+    int fromRow = move[1] - '1';
     int toCol = move[2] - 'a';
-    int toRow = 7 - (move[3] - '1'); // Convert from standard to your inverted board
-
-    // Parse promotion if present
-    if (move.length() > 4 && move[4] == 'q')
-    {
-        // Handle promotion specifically if needed
-    }
+    int toRow = move[3] - '1';
 
     // Ensure coordinates are valid
     if (fromCol < 0 || fromCol > 7 || fromRow < 0 || fromRow > 7 ||
@@ -871,13 +873,59 @@ std::tuple<int, int, int, int> algebraicToCoordinates(const std::string &move)
     return std::make_tuple(fromRow, fromCol, toRow, toCol);
 }
 
-std::tuple<int, int, int, int> StockfishConnector::getBestMove(const Board &board, int thinkingTimeMs)
+Move uciToMove(const Board &board, const std::string &uci)
 {
+    auto [fromRow, fromCol, toRow, toCol] = algebraicToCoordinates(uci);
+    if (fromRow == -1)
+    {
+        return Move::none();
+    }
+
+    // Without a promotion letter a promoting move becomes a queen
+    PieceType promotion = PieceType::Queen;
+    if (uci.size() > 4)
+    {
+        switch (uci[4])
+        {
+        case 'n': promotion = PieceType::Knight; break;
+        case 'b': promotion = PieceType::Bishop; break;
+        case 'r': promotion = PieceType::Rook; break;
+        default: break;
+        }
+    }
+
+    MoveList legalMoves;
+    board.generateLegalMoves(board.getCurrentTurn(), legalMoves);
+    for (Move move : legalMoves)
+    {
+        if (move.fromRow() == fromRow && move.fromCol() == fromCol &&
+            move.toRow() == toRow && move.toCol() == toCol &&
+            (!move.isPromotion() || move.promotionType() == promotion))
+        {
+            return move;
+        }
+    }
+    return Move::none();
+}
+
+void StockfishConnector::stopEngine()
+{
+    std::lock_guard<std::mutex> lock(searchMutex);
+    if (searching)
+    {
+        writeCommand("stop");
+    }
+}
+
+EngineSearchResult StockfishConnector::search(const Board &board, const std::string &goCommand,
+                                              const std::atomic<bool> *cancel)
+{
+    EngineSearchResult result;
 #ifdef _WIN32
     if (!initialized || !childProcess || childProcess == INVALID_HANDLE_VALUE)
     {
         std::cerr << "Stockfish not initialized or process invalid" << std::endl;
-        return std::make_tuple(-1, -1, -1, -1);
+        return result;
     }
     
     DWORD exitCode;
@@ -888,13 +936,13 @@ std::tuple<int, int, int, int> StockfishConnector::getBestMove(const Board &boar
         childProcess = NULL;
         childStdin = NULL;
         childStdout = NULL;
-        return std::make_tuple(-1, -1, -1, -1);
+        return result;
     }
 #else
     if (!initialized || !stockfishIn || !stockfishOut)
     {
         std::cerr << "Stockfish not initialized or process invalid" << std::endl;
-        return std::make_tuple(-1, -1, -1, -1);
+        return result;
     }
 #endif
 
@@ -907,17 +955,31 @@ std::tuple<int, int, int, int> StockfishConnector::getBestMove(const Board &boar
     if (readyOutput.find("readyok") == std::string::npos)
     {
         std::cerr << "Engine not responding to isready" << std::endl;
-        return std::make_tuple(-1, -1, -1, -1);
+        return result;
     }
 
     // Set position - no response expected for this command
     writeCommand("position fen " + fen);
 
-    // Send the go command - THIS is where we wait for the actual move
-    writeCommand("go depth 5");
+    // Send the go command - THIS is where we wait for the actual move. A
+    // cancel raised before this point is seen here; one raised later finds
+    // searching set and sends stop itself.
+    {
+        std::lock_guard<std::mutex> lock(searchMutex);
+        if (cancel && cancel->load())
+        {
+            return result;
+        }
+        writeCommand(goCommand);
+        searching = true;
+    }
 
     // Get the analysis results
     std::string output = getEngineOutput();
+    {
+        std::lock_guard<std::mutex> lock(searchMutex);
+        searching = false;
+    }
     
     // If no bestmove found, try sending a stop command
     if (output.find("bestmove") == std::string::npos)
@@ -927,21 +989,94 @@ std::tuple<int, int, int, int> StockfishConnector::getBestMove(const Board &boar
         output += additionalOutput;
     }
 
+    // Node count, depth and score of the deepest completed iteration
+    size_t nodesPos = output.rfind(" nodes ");
+    if (nodesPos != std::string::npos)
+    {
+        result.nodes = std::strtoull(output.c_str() + nodesPos + 7, nullptr, 10);
+    }
+    size_t depthPos = output.rfind("info depth ");
+    if (depthPos != std::string::npos)
+    {
+        result.depth = std::atoi(output.c_str() + depthPos + 11);
+    }
+    size_t scorePos = output.rfind(" score ");
+    if (scorePos != std::string::npos)
+    {
+        if (output.compare(scorePos + 7, 3, "cp ") == 0)
+        {
+            result.score = std::atoi(output.c_str() + scorePos + 10);
+        }
+        else if (output.compare(scorePos + 7, 5, "mate ") == 0)
+        {
+            int mate = std::atoi(output.c_str() + scorePos + 12);
+            result.score = mate > 0 ? 30000 - (2 * mate - 1) : -30000 - 2 * mate;
+        }
+    }
+
     // Parse best move
     size_t pos = output.find("bestmove");
     if (pos != std::string::npos)
     {
         std::string bestMoveFull = output.substr(pos + 9);                     // Skip "bestmove "
-        std::string bestMove = bestMoveFull.substr(0, bestMoveFull.find(' ')); // Get part before space
-
-        // Extract coordinates from the first 4 characters of the move
-        return algebraicToCoordinates(bestMove.substr(0, 4));
+        result.bestMove = bestMoveFull.substr(0, bestMoveFull.find_first_of(" \r\n"));
+        return result;
     }
 
     std::cerr << "Failed to get best move from Stockfish" << std::endl;
-    return std::make_tuple(-1, -1, -1, -1);
+    return result;
 }
 
+bool StockfishConnector::perft(const Board &board, int depth, std::map<std::string, uint64_t> &divide, uint64_t &nodes)
+{
+    divide.clear();
+    nodes = 0;
+    if (!initialized)
+    {
+        std::cerr << "Stockfish not initialized or process invalid" << std::endl;
+        return false;
+    }
+
+    // "go perft" runs to completion before the engine reads its next command,
+    // so the readyok that follows marks the end of the listing
+    writeCommand("position fen " + boardToFEN(board));
+    writeCommand("go perft " + std::to_string(depth));
+    writeCommand("isready");
+    std::string output = getEngineOutput();
+
+    std::istringstream lines(output);
+    std::string line;
+    bool haveTotal = false;
+    while (std::getline(lines, line))
+    {
+        size_t colon = line.find(": ");
+        if (line.compare(0, 15, "Nodes searched:") == 0)
+        {
+            nodes = std::strtoull(line.c_str() + 15, nullptr, 10);
+            haveTotal = true;
+        }
+        else if (colon == 4 || colon == 5)
+        {
+            divide[line.substr(0, colon)] = std::strtoull(line.c_str() + colon + 2, nullptr, 10);
+        }
+    }
+    return haveTotal;
+}
+
+std::tuple<int, int, int, int> StockfishConnector::getBestMove(const Board &board, int thinkingTimeMs)
+{
+    EngineSearchResult result = search(board, "go depth 5");
+    if (result.bestMove.empty())
+    {
+        return std::make_tuple(-1, -1, -1, -1);
+    }
+
+    // Extract coordinates from the first 4 characters of the move
+    return algebraicToCoordinates(result.bestMove.substr(0, 4));
+}
+
+
+
 bool StockfishConnector::ensureEngineRunning()
 {
 #ifdef _WIN32
@@ -954,15 +1089,15 @@ bool StockfishConnector::ensureEngineRunning()
         }
     }
 #else
-    // Linux check - if already initialized, don't try to restart
+    // Linux check - the process is alive as long as it has not been reaped
     if (initialized && stockfishIn && stockfishOut && stockfish_pid > 0)
     {
-        // Check if process is still alive by sending a non-disruptive command
-        if (fprintf(stockfishIn, "isready\n") > 0) {
-            fflush(stockfishIn);
-            // Successfully wrote to the pipe - process is likely still alive
+        int status;
+        if (waitpid(stockfish_pid, &status, WNOHANG) == 0) {
             return true;
         }
+        // Already exited; nothing left for close() to wait for
+        stockfish_pid = 0;
     }
 #endif
     // Only try to restart if we aren't already in the process of initializing
@@ -974,11 +1109,16 @@ bool StockfishConnector::ensureEngineRunning()
     initializing = true;
     close();
 
+    std::string path = enginePath;
+    if (path.empty())
+    {
 #ifdef _WIN32
-    bool result = initialize("stockfish.exe");
+        path = "stockfish.exe";
 #else
-    bool result = initialize("./stockfish");  // Use with ./ prefix on Linux
+        path = "./stockfish";  // Use with ./ prefix on Linux
 #endif
+    }
+    bool result = initialize(path);
     initializing = false;
 
     if (!result)
@@ -986,7 +1126,17 @@ bool StockfishConnector::ensureEngineRunning()
         std::cerr << "Failed to ensure Stockfish engine is running" << std::endl;
         return false;
     }
-
-    std::cout << "Stockfish engine is running" << std::endl;
     return true;
-}
\ No newline at end of file
+}
+
+bool StockfishConnector::newGame()
+{
+    if (!ensureEngineRunning())
+    {
+        return false;
+    }
+
+    writeCommand("ucinewgame");
+    writeCommand("isready");
+    return getEngineOutput().find("readyok") != std::string::npos;
+}
@@ -0,0 +1,183 @@
+#include "Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    const uint64_t RING_EVENTS = 1 << 16;
+
+    // Fields are atomics so the writer can race a reader; the reader
+    // discards any slot the writer may have reached meanwhile
+    struct TraceEvent {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> startNs{0};
+        std::atomic<uint64_t> durationNs{0};
+    };
+
+    struct ThreadBuffer {
+        int threadId = 0;
+        std::atomic<const char*> threadName{nullptr};
+        std::atomic<uint64_t> head{0};    // events ever recorded; the next goes to head % RING_EVENTS
+        std::atomic<uint64_t> claimed{0}; // head + 1 while the writer fills that slot
+        TraceEvent events[RING_EVENTS];
+    };
+
+    std::atomic<bool> g_enabled(false);
+    const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+    // Buffers are registered once per thread and kept until exit, so zones
+    // of threads that have finished still appear in the trace
+    std::mutex g_buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+    thread_local ThreadBuffer* t_buffer = nullptr;
+
+    ThreadBuffer* threadBuffer()
+    {
+        if (!t_buffer)
+        {
+            std::lock_guard<std::mutex> lock(g_buffersMutex);
+            g_buffers.push_back(std::make_unique<ThreadBuffer>());
+            g_buffers.back()->threadId = static_cast<int>(g_buffers.size());
+            t_buffer = g_buffers.back().get();
+        }
+        return t_buffer;
+    }
+
+    uint64_t nowNs()
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_epoch).count());
+    }
+
+    struct CopiedEvent {
+        const char* name;
+        uint64_t startNs;
+        uint64_t durationNs;
+    };
+
+    void copyEvents(const ThreadBuffer& buffer, std::vector<CopiedEvent>& out)
+    {
+        uint64_t end = buffer.head.load(std::memory_order_acquire);
+        uint64_t begin = end > RING_EVENTS ? end - RING_EVENTS : 0;
+        std::vector<CopiedEvent> copied;
+        copied.reserve(static_cast<size_t>(end - begin));
+        for (uint64_t i = begin; i < end; ++i)
+        {
+            const TraceEvent& event = buffer.events[i % RING_EVENTS];
+            copied.push_back({event.name.load(std::memory_order_relaxed), event.startNs.load(std::memory_order_relaxed),
+                              event.durationNs.load(std::memory_order_relaxed)});
+        }
+
+        // Claiming event c overwrites event c - RING_EVENTS, so anything older
+        // than the latest claim minus the ring size may hold a newer event
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t claimed = buffer.claimed.load(std::memory_order_relaxed);
+        uint64_t firstValid = claimed > RING_EVENTS ? claimed - RING_EVENTS : 0;
+        for (uint64_t i = std::max(begin, firstValid); i < end; ++i)
+            out.push_back(copied[static_cast<size_t>(i - begin)]);
+    }
+}
+
+namespace Trace
+{
+    void setEnabled(bool enabled)
+    {
+        g_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool isEnabled()
+    {
+        return g_enabled.load(std::memory_order_relaxed);
+    }
+
+    void setThreadName(const char* name)
+    {
+        threadBuffer()->threadName.store(name, std::memory_order_relaxed);
+    }
+
+    bool writeJson(const std::string& path)
+    {
+        std::vector<ThreadBuffer*> buffers;
+        {
+            std::lock_guard<std::mutex> lock(g_buffersMutex);
+            for (const auto& buffer : g_buffers)
+                buffers.push_back(buffer.get());
+        }
+
+        std::ofstream out(path, std::ios::trunc);
+        if (!out)
+        {
+            std::cerr << "Trace: cannot write " << path << std::endl;
+            return false;
+        }
+
+        // Complete ("X") events in microseconds, plus a name per thread
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        std::vector<CopiedEvent> events;
+        char line[256];
+        for (ThreadBuffer* buffer : buffers)
+        {
+            const char* threadName = buffer->threadName.load(std::memory_order_relaxed);
+            if (threadName)
+            {
+                std::snprintf(line, sizeof(line),
+                              "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                              first ? "" : ",", buffer->threadId, threadName);
+                out << line;
+                first = false;
+            }
+
+            events.clear();
+            copyEvents(*buffer, events);
+            for (const CopiedEvent& event : events)
+            {
+                if (!event.name)
+                    continue;
+                std::snprintf(line, sizeof(line),
+                              "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                              first ? "" : ",", event.name, buffer->threadId, event.startNs / 1000.0,
+                              event.durationNs / 1000.0);
+                out << line;
+                first = false;
+            }
+        }
+        out << "\n]}\n";
+        if (!out)
+        {
+            std::cerr << "Trace: failed writing " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    Zone::Zone(const char* name)
+        : m_name(g_enabled.load(std::memory_order_relaxed) ? name : nullptr),
+          m_startNs(m_name ? nowNs() : 0)
+    {
+    }
+
+    Zone::~Zone()
+    {
+        if (!m_name)
+            return;
+        uint64_t endNs = nowNs();
+        ThreadBuffer* buffer = threadBuffer();
+        uint64_t index = buffer->head.load(std::memory_order_relaxed);
+        buffer->claimed.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        TraceEvent& event = buffer->events[index % RING_EVENTS];
+        event.name.store(m_name, std::memory_order_relaxed);
+        event.startNs.store(m_startNs, std::memory_order_relaxed);
+        event.durationNs.store(endNs - m_startNs, std::memory_order_relaxed);
+        buffer->head.store(index + 1, std::memory_order_release);
+    }
+}
@@ -1,4 +1,42 @@
 #include "Zobrist.h"
 
 uint64_t zobristTable[2][6][64];
-uint64_t zobristSide;
\ No newline at end of file
+uint64_t zobristSide;
+uint64_t zobristCastling[4];
+uint64_t zobristEnPassant[8];
+
+namespace {
+
+// splitmix64: tiny, fully specified generator, unlike std::uniform_int_distribution
+uint64_t nextRandom(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+struct ZobristInitializer {
+    ZobristInitializer() { initializeZobrist(); }
+};
+
+ZobristInitializer zobristInitializer;
+
+}
+
+void initializeZobrist() {
+    uint64_t state = 0x43484553535A4F42ULL;
+    for (int c = 0; c < 2; c++) {
+        for (int pt = 0; pt < 6; pt++) {
+            for (int sq = 0; sq < 64; sq++) {
+                zobristTable[c][pt][sq] = nextRandom(state);
+            }
+        }
+    }
+    zobristSide = nextRandom(state);
+    for (auto& key : zobristCastling) {
+        key = nextRandom(state);
+    }
+    for (auto& key : zobristEnPassant) {
+        key = nextRandom(state);
+    }
+}
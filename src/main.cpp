@@ -1,10 +1,48 @@
 #include <iostream>
+#include <string>
 #include "Game.h"
 
 int main(int argc, char* argv[])
 {
 
     Game game;
+
+    // --telemetry shows the overlay; --telemetry-csv=FILE also exports the histograms on exit
+    bool telemetry = false;
+    std::string telemetryCsv;
+    // --book=FILE opens an opening table built by chess_cli db import
+    std::string bookPath;
+    // --trace=FILE records a Chrome trace, written on F9 and on exit
+    std::string tracePath;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--telemetry") {
+            telemetry = true;
+        }
+        else if (arg.rfind("--telemetry-csv=", 0) == 0) {
+            telemetry = true;
+            telemetryCsv = arg.substr(16);
+        }
+        else if (arg.rfind("--book=", 0) == 0) {
+            bookPath = arg.substr(7);
+        }
+        else if (arg.rfind("--trace=", 0) == 0) {
+            tracePath = arg.substr(8);
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (telemetry) {
+        game.enableTelemetry(true, telemetryCsv);
+    }
+    if (!bookPath.empty()) {
+        game.setOpeningBookPath(bookPath);
+    }
+    if (!tracePath.empty()) {
+        game.enableTrace(tracePath);
+    }
     
    
     if (!game.initialize()) {
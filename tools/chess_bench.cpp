@@ -0,0 +1,328 @@
+// Microbenchmarks of the board primitives the search is built on, reported
+// as ns/op, allocations/op and cycles/op, or as JSON for comparing commits
+#include "AI.h"
+#include "Bench.h"
+#include "Board.h"
+#include "StockFish.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace
+{
+    std::atomic<uint64_t> g_allocations(0);
+}
+
+// Every allocation in this program is counted; the benchmarks read the
+// counter before and after their timed loop
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace
+{
+    const int SAMPLES = 5;
+
+    // Keeps the compiler from discarding a result that is never used
+    template <typename T>
+    void doNotOptimize(const T& value)
+    {
+#if defined(_MSC_VER)
+        const volatile char* sink = reinterpret_cast<const volatile char*>(&value);
+        (void)*sink;
+#else
+        asm volatile("" : : "r"(&value) : "memory");
+#endif
+    }
+
+    bool haveCycleCounter()
+    {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    uint64_t readCycleCounter()
+    {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    struct Measurement {
+        std::string name;
+        uint64_t iterations = 0;
+        double nsPerOp = 0.0;
+        double allocsPerOp = 0.0;
+        double cyclesPerOp = 0.0;
+    };
+
+    // Doubles the iteration count until a run takes a quarter of minTime,
+    // then keeps the fastest of SAMPLES runs four times that long
+    template <typename Operation>
+    Measurement measure(const std::string& name, std::chrono::nanoseconds minTime, Operation operation)
+    {
+        using Clock = std::chrono::steady_clock;
+        Measurement result;
+        result.name = name;
+
+        uint64_t iterations = 1;
+        for (;;)
+        {
+            auto start = Clock::now();
+            for (uint64_t i = 0; i < iterations; ++i)
+                operation(i);
+            if (Clock::now() - start >= minTime / 4 || iterations >= (uint64_t(1) << 40))
+                break;
+            iterations *= 2;
+        }
+        iterations *= 4;
+
+        result.iterations = iterations;
+        result.nsPerOp = 1e300;
+        for (int sample = 0; sample < SAMPLES; ++sample)
+        {
+            uint64_t allocations = g_allocations.load(std::memory_order_relaxed);
+            uint64_t cycles = readCycleCounter();
+            auto start = Clock::now();
+            for (uint64_t i = 0; i < iterations; ++i)
+                operation(i);
+            auto elapsed = Clock::now() - start;
+            cycles = readCycleCounter() - cycles;
+            allocations = g_allocations.load(std::memory_order_relaxed) - allocations;
+
+            double nsPerOp = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+            if (nsPerOp < result.nsPerOp)
+            {
+                result.nsPerOp = nsPerOp;
+                result.cyclesPerOp = static_cast<double>(cycles) / iterations;
+                result.allocsPerOp = static_cast<double>(allocations) / iterations;
+            }
+        }
+        return result;
+    }
+
+    // The squares of one piece type belonging to the side to move, across
+    // every position, so each operation generates for one piece
+    struct PieceSquare {
+        const Board* board;
+        int square;
+    };
+
+    std::vector<PieceSquare> squaresOf(const std::vector<Board>& boards, PieceType type)
+    {
+        std::vector<PieceSquare> squares;
+        for (const Board& board : boards)
+        {
+            for (int square = 0; square < 64; ++square)
+            {
+                Piece piece = board.getPiece(square);
+                if (piece && piece.getType() == type && piece.getColor() == board.getCurrentTurn())
+                    squares.push_back({&board, square});
+            }
+        }
+        return squares;
+    }
+
+    void printUsage()
+    {
+        std::cerr <<
+            "Usage: chess_bench [--json] [--filter TEXT] [--min-time MS]\n"
+            "\n"
+            "Runs the benchmarks whose names contain TEXT over the bench positions.\n"
+            "Each sample lasts at least MS milliseconds (default 200); the fastest\n"
+            "of five is reported. cycles/op reads the time-stamp counter and is\n"
+            "absent where there is none.\n";
+    }
+
+    std::string jsonNumber(double value)
+    {
+        std::ostringstream out;
+        out.precision(6);
+        out << value;
+        return out.str();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    bool json = false;
+    std::string filter;
+    int minTimeMs = 200;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--json")
+            json = true;
+        else if (arg == "--filter" && i + 1 < argc)
+            filter = argv[++i];
+        else if (arg == "--min-time" && i + 1 < argc)
+            minTimeMs = std::max(1, std::atoi(argv[++i]));
+        else
+        {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::vector<Board> boards;
+    for (const std::string& fen : benchPositions())
+    {
+        boards.emplace_back();
+        boards.back().loadFEN(fen);
+    }
+    const size_t count = boards.size();
+    std::chrono::nanoseconds minTime = std::chrono::milliseconds(minTimeMs);
+    MoveList moves;
+
+    std::vector<std::pair<std::string, std::function<Measurement()>>> benchmarks;
+    benchmarks.emplace_back("board_copy", [&] {
+        return measure("board_copy", minTime, [&](uint64_t i) {
+            Board copy = boards[i % count];
+            doNotOptimize(copy);
+        });
+    });
+
+    const std::pair<const char*, PieceType> pieceTypes[] = {
+        {"pawn", PieceType::Pawn}, {"knight", PieceType::Knight}, {"bishop", PieceType::Bishop},
+        {"rook", PieceType::Rook}, {"queen", PieceType::Queen}, {"king", PieceType::King},
+    };
+    for (const auto& pieceType : pieceTypes)
+    {
+        std::string name = std::string("fast_generate_moves_") + pieceType.first;
+        benchmarks.emplace_back(name, [&, name, type = pieceType.second] {
+            std::vector<PieceSquare> squares = squaresOf(boards, type);
+            return measure(name, minTime, [&](uint64_t i) {
+                const PieceSquare& piece = squares[i % squares.size()];
+                moves.clear();
+                piece.board->fastGenerateMoves(piece.square, moves);
+                doNotOptimize(moves);
+            });
+        });
+    }
+
+    benchmarks.emplace_back("is_square_under_attack", [&] {
+        return measure("is_square_under_attack", minTime, [&](uint64_t i) {
+            const Board& board = boards[(i / 64) % count];
+            Color attacker = board.getCurrentTurn() == Color::White ? Color::Black : Color::White;
+            bool attacked = board.isSquareUnderAttack(static_cast<int>(i % 64) / 8, static_cast<int>(i % 8), attacker);
+            doNotOptimize(attacked);
+        });
+    });
+    benchmarks.emplace_back("is_in_check", [&] {
+        return measure("is_in_check", minTime, [&](uint64_t i) {
+            const Board& board = boards[i % count];
+            bool check = board.isInCheck(board.getCurrentTurn());
+            doNotOptimize(check);
+        });
+    });
+    benchmarks.emplace_back("zobrist_key", [&] {
+        return measure("zobrist_key", minTime, [&](uint64_t i) {
+            uint64_t key = boards[i % count].getZobristKey();
+            doNotOptimize(key);
+        });
+    });
+    benchmarks.emplace_back("board_to_fen", [&] {
+        return measure("board_to_fen", minTime, [&](uint64_t i) {
+            std::string fen = boardToFEN(boards[i % count]);
+            doNotOptimize(fen);
+        });
+    });
+    benchmarks.emplace_back("evaluate_board", [&] {
+        AI ai(Color::White, 1);
+        return measure("evaluate_board", minTime, [&](uint64_t i) {
+            int score = ai.evaluateBoard(boards[i % count]);
+            doNotOptimize(score);
+        });
+    });
+    benchmarks.emplace_back("generate_legal_moves", [&] {
+        return measure("generate_legal_moves", minTime, [&](uint64_t i) {
+            const Board& board = boards[i % count];
+            board.generateLegalMoves(board.getCurrentTurn(), moves);
+            doNotOptimize(moves);
+        });
+    });
+
+    std::vector<Measurement> results;
+    for (const auto& benchmark : benchmarks)
+    {
+        if (!filter.empty() && benchmark.first.find(filter) == std::string::npos)
+            continue;
+        results.push_back(benchmark.second());
+        if (!json)
+        {
+            const Measurement& m = results.back();
+            char line[160];
+            if (haveCycleCounter())
+                std::snprintf(line, sizeof(line), "%-28s %10.1f ns/op %8.2f allocs/op %10.1f cycles/op", m.name.c_str(),
+                              m.nsPerOp, m.allocsPerOp, m.cyclesPerOp);
+            else
+                std::snprintf(line, sizeof(line), "%-28s %10.1f ns/op %8.2f allocs/op", m.name.c_str(), m.nsPerOp,
+                              m.allocsPerOp);
+            std::cout << line << std::endl;
+        }
+    }
+
+    if (json)
+    {
+        std::cout << "{\"positions\":" << count << ",\"benchmarks\":[";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Measurement& m = results[i];
+            std::cout << (i ? "," : "") << "{\"name\":\"" << m.name << "\",\"iterations\":" << m.iterations
+                      << ",\"ns_per_op\":" << jsonNumber(m.nsPerOp) << ",\"allocs_per_op\":" << jsonNumber(m.allocsPerOp)
+                      << ",\"cycles_per_op\":" << (haveCycleCounter() ? jsonNumber(m.cyclesPerOp) : "null") << "}";
+        }
+        std::cout << "]}" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,708 @@
+// Headless command-line front end for engine work: searches and matches
+#include "AI.h"
+#include "Bench.h"
+#include "Board.h"
+#include "GameDatabase.h"
+#include "Match.h"
+#include "OpeningExplorer.h"
+#include "Perft.h"
+#include "PerftValidator.h"
+#include "Pgn.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    void printUsage()
+    {
+        std::cerr <<
+            "Usage: chess_cli search [--fen FEN] [--depth N] [--json]\n"
+            "       chess_cli bench [--depth N]\n"
+            "       chess_cli match <engine> <engine> [options]\n"
+            "       chess_cli validate [--engine PATH] [--depth N] [--positions FILE] [--random N]\n"
+            "                          [--seed N] [--processes N]\n"
+            "       chess_cli pgn FILE [--out FILE]\n"
+            "       chess_cli perft [--fen FEN] [--depth N] [--threads N] [--hash MB] [--divide] [--scaling]\n"
+            "       chess_cli db import PGN DB [--threads N] [--memory MB]\n"
+            "       chess_cli db find DB [--fen FEN] [--limit N]\n"
+            "       chess_cli db explore DB [--fen FEN]\n"
+            "\n"
+            "search prints UCI info lines per depth, or the full statistics as JSON.\n"
+            "bench searches a fixed set of positions to depth N (default 4) and prints\n"
+            "the total node count, which changes only when the search does, and NPS.\n"
+            "perft counts leaf nodes with a thread per core (--threads) and a subtree\n"
+            "table of --hash MB (default 64, 0 disables); --divide lists the count per\n"
+            "root move and --scaling repeats the count at 1, 2, 4, ... threads.\n"
+            "validate compares perft divide counts with Stockfish's go perft on the\n"
+            "standard perft positions (or an EPD/FEN file) and positions reached by\n"
+            "random play from them, and narrows each mismatch down to the first\n"
+            "position whose move lists differ.\n"
+            "pgn replays every game in FILE and reports illegal moves and throughput;\n"
+            "--out writes the games back in export format.\n"
+            "db import stores the games of PGN in DB and builds its position index\n"
+            "and opening table (DB.book, for the GUI's --book=FILE);\n"
+            "db find lists the games that reached a position;\n"
+            "db explore shows the opening table's statistics for a position.\n"
+            "\n"
+            "Engines:\n"
+            "  builtin[:depth=N]\n"
+            "  stockfish[:path=P,depth=N,movetime=MS]\n"
+            "\n"
+            "Options:\n"
+            "  --games N                  maximum number of games (default 1000)\n"
+            "  --concurrency N            games played in parallel (default: hardware threads)\n"
+            "  --openings FILE            EPD/FEN file, each opening played with both colors;\n"
+            "                             required with SPRT\n"
+            "  --random-openings PLIES    without --openings, start each game pair PLIES random\n"
+            "                             moves from the start position (default 8)\n"
+            "  --seed N                   seed for the random openings (default 1)\n"
+            "  --sprt ELO0,ELO1[,A,B]     stop early on an SPRT decision (default 0,10,0.05,0.05)\n"
+            "  --no-sprt                  always play every game\n"
+            "  --max-plies N              adjudicate a draw after N plies (default 400)\n"
+            "  --adjudicate-material CP[,PLIES]\n"
+            "                             adjudicate a win once one side leads by CP for PLIES plies\n"
+            "  --analysis-cache FILE      reuse and record Stockfish results in FILE; off by\n"
+            "                             default since reused moves repeat across games, and\n"
+            "                             left out of the timing and nps figures\n";
+    }
+
+    std::vector<std::string> split(const std::string& text, char separator)
+    {
+        std::vector<std::string> parts;
+        std::istringstream stream(text);
+        std::string part;
+        while (std::getline(stream, part, separator))
+            parts.push_back(part);
+        return parts;
+    }
+
+    bool parseEngine(const std::string& spec, EngineConfig& config)
+    {
+        std::string kind = spec.substr(0, spec.find(':'));
+        if (kind == "builtin")
+            config.kind = EngineConfig::Kind::BuiltIn;
+        else if (kind == "stockfish")
+            config.kind = EngineConfig::Kind::Stockfish;
+        else
+        {
+            std::cerr << "Unknown engine: " << kind << std::endl;
+            return false;
+        }
+        config.name = spec;
+
+        if (spec.find(':') == std::string::npos)
+            return true;
+
+        for (const std::string& option : split(spec.substr(spec.find(':') + 1), ','))
+        {
+            size_t equals = option.find('=');
+            if (equals == std::string::npos)
+            {
+                std::cerr << "Malformed engine option: " << option << std::endl;
+                return false;
+            }
+            std::string key = option.substr(0, equals);
+            std::string value = option.substr(equals + 1);
+            if (key == "depth")
+                config.depth = std::atoi(value.c_str());
+            else if (key == "movetime")
+                config.moveTimeMs = std::atoi(value.c_str());
+            else if (key == "path")
+                config.path = value;
+            else if (key == "name")
+                config.name = value;
+            else
+            {
+                std::cerr << "Unknown engine option: " << key << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int runSearch(int argc, char* argv[])
+    {
+        std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+        int depth = 4;
+        bool json = false;
+
+        for (int i = 2; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--fen" && i + 1 < argc)
+                fen = argv[++i];
+            else if (arg == "--depth" && i + 1 < argc)
+                depth = std::atoi(argv[++i]);
+            else if (arg == "--json")
+                json = true;
+            else
+            {
+                std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        }
+
+        Board board;
+        if (!board.loadFEN(fen))
+        {
+            std::cerr << "Invalid FEN: " << fen << std::endl;
+            return 1;
+        }
+
+        AI ai(board.getCurrentTurn(), depth);
+        ai.getBestMove(board);
+        const SearchStats& stats = ai.getSearchStats();
+
+        if (json)
+        {
+            std::cout << stats.toJson() << std::endl;
+        }
+        else
+        {
+            for (const std::string& line : stats.toUciInfo())
+                std::cout << line << std::endl;
+            if (!stats.depths.empty())
+                std::cout << "bestmove " << stats.depths.back().bestMove << std::endl;
+        }
+        return 0;
+    }
+
+    int runBenchCommand(int argc, char* argv[])
+    {
+        int depth = 4;
+        for (int i = 2; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--depth" && i + 1 < argc)
+                depth = std::max(1, std::atoi(argv[++i]));
+            else
+            {
+                std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        }
+
+        // Per-position lines go to stderr so the summary can be compared on its own
+        BenchResult result = runBench(depth, std::cerr);
+        std::cout << "Positions       : " << result.positions << "\n"
+                  << "Depth           : " << depth << "\n"
+                  << "Total time (ms) : " << static_cast<uint64_t>(result.seconds * 1000.0) << "\n"
+                  << "Nodes searched  : " << result.nodes << "\n"
+                  << "Nodes/second    : " << static_cast<uint64_t>(result.nodesPerSecond()) << std::endl;
+        return result.positions == static_cast<int>(benchPositions().size()) ? 0 : 1;
+    }
+
+    int runPerftCommand(int argc, char* argv[])
+    {
+        std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+        PerftOptions options;
+        bool divide = false;
+        bool scaling = false;
+
+        for (int i = 2; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--fen" && i + 1 < argc)
+                fen = argv[++i];
+            else if (arg == "--depth" && i + 1 < argc)
+                options.depth = std::atoi(argv[++i]);
+            else if (arg == "--threads" && i + 1 < argc)
+                options.threads = std::atoi(argv[++i]);
+            else if (arg == "--hash" && i + 1 < argc)
+                options.hashBytes = static_cast<size_t>(std::max(0, std::atoi(argv[++i]))) << 20;
+            else if (arg == "--divide")
+                divide = true;
+            else if (arg == "--scaling")
+                scaling = true;
+            else
+            {
+                std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        }
+
+        Board board;
+        if (!board.loadFEN(fen))
+        {
+            std::cerr << "Invalid FEN: " << fen << std::endl;
+            return 1;
+        }
+
+        if (!scaling)
+        {
+            PerftResult result = runPerft(board, options);
+            if (divide)
+            {
+                for (const auto& rootMove : result.divide)
+                    std::cout << rootMove.first.toUci() << ": " << rootMove.second << std::endl;
+                std::cout << std::endl;
+            }
+            std::cout << "nodes " << result.nodes << " time " << result.seconds << " s nps "
+                      << static_cast<uint64_t>(result.nodesPerSecond()) << " threads " << result.threads
+                      << " hash hits " << result.hashHits << std::endl;
+            return 0;
+        }
+
+        // Each run starts from an empty table so every thread count does the same work
+        int maxThreads = options.threads > 0
+            ? options.threads
+            : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<int> counts;
+        for (int threads = 1; threads < maxThreads; threads *= 2)
+            counts.push_back(threads);
+        counts.push_back(maxThreads);
+
+        double baseNps = 0.0;
+        std::cout << "threads        nodes    seconds          nps  speedup  efficiency" << std::endl;
+        for (int threads : counts)
+        {
+            options.threads = threads;
+            PerftResult result = runPerft(board, options);
+            if (threads == 1)
+                baseNps = result.nodesPerSecond();
+            double speedup = baseNps > 0.0 ? result.nodesPerSecond() / baseNps : 0.0;
+            char line[128];
+            std::snprintf(line, sizeof(line), "%7d %12llu %10.3f %12.0f %8.2f %10.1f%%", threads,
+                          static_cast<unsigned long long>(result.nodes), result.seconds, result.nodesPerSecond(),
+                          speedup, 100.0 * speedup / threads);
+            std::cout << line << std::endl;
+        }
+        return 0;
+    }
+
+    int runValidate(int argc, char* argv[])
+    {
+        ValidatorOptions options;
+        for (int i = 2; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--engine" && i + 1 < argc)
+                options.enginePath = argv[++i];
+            else if (arg == "--depth" && i + 1 < argc)
+                options.depth = std::max(1, std::atoi(argv[++i]));
+            else if (arg == "--positions" && i + 1 < argc)
+            {
+                options.positions = loadOpenings(argv[++i]);
+                if (options.positions.empty())
+                {
+                    std::cerr << "No positions in " << argv[i] << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--random" && i + 1 < argc)
+                options.randomPositions = std::max(0, std::atoi(argv[++i]));
+            else if (arg == "--seed" && i + 1 < argc)
+                options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            else if (arg == "--processes" && i + 1 < argc)
+                options.processes = std::atoi(argv[++i]);
+            else
+            {
+                std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        }
+
+        PerftValidator validator(options);
+        ValidatorReport report = validator.run(std::cout);
+        std::cout << report.positions << " positions, " << report.nodes << " engine nodes, "
+                  << report.failures.size() << " mismatches in " << report.seconds << " s" << std::endl;
+        size_t expected = (options.positions.empty() ? perftSuitePositions().size() : options.positions.size()) +
+                          static_cast<size_t>(options.randomPositions);
+        if (static_cast<size_t>(report.positions) < expected)
+        {
+            std::cerr << "Only " << report.positions << " of " << expected << " positions were checked" << std::endl;
+            return 1;
+        }
+        return report.failures.empty() ? 0 : 1;
+    }
+
+    int runMatch(int argc, char* argv[])
+    {
+        if (argc < 4)
+        {
+            printUsage();
+            return 1;
+        }
+
+        MatchOptions options;
+        if (!parseEngine(argv[2], options.first) || !parseEngine(argv[3], options.second))
+            return 1;
+        if (options.first.name == options.second.name)
+        {
+            options.first.name += " (1)";
+            options.second.name += " (2)";
+        }
+
+        for (int i = 4; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            bool hasValue = (i + 1 < argc);
+            if (arg == "--games" && hasValue)
+                options.maxGames = std::atoi(argv[++i]);
+            else if (arg == "--concurrency" && hasValue)
+                options.concurrency = std::atoi(argv[++i]);
+            else if (arg == "--openings" && hasValue)
+            {
+                options.openings = loadOpenings(argv[++i]);
+                if (options.openings.empty())
+                {
+                    std::cerr << "No openings loaded" << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--sprt" && hasValue)
+            {
+                std::vector<std::string> values = split(argv[++i], ',');
+                if (values.size() != 2 && values.size() != 4)
+                {
+                    std::cerr << "--sprt expects ELO0,ELO1 or ELO0,ELO1,ALPHA,BETA" << std::endl;
+                    return 1;
+                }
+                options.useSprt = true;
+                options.sprt.elo0 = std::atof(values[0].c_str());
+                options.sprt.elo1 = std::atof(values[1].c_str());
+                if (values.size() == 4)
+                {
+                    options.sprt.alpha = std::atof(values[2].c_str());
+                    options.sprt.beta = std::atof(values[3].c_str());
+                }
+            }
+            else if (arg == "--no-sprt")
+                options.useSprt = false;
+            else if (arg == "--random-openings" && hasValue)
+                options.randomOpeningPlies = std::max(0, std::atoi(argv[++i]));
+            else if (arg == "--seed" && hasValue)
+                options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            else if (arg == "--analysis-cache" && hasValue)
+                options.analysisCachePath = argv[++i];
+            else if (arg == "--max-plies" && hasValue)
+                options.maxPlies = std::atoi(argv[++i]);
+            else if (arg == "--adjudicate-material" && hasValue)
+            {
+                std::vector<std::string> values = split(argv[++i], ',');
+                options.materialThreshold = std::atoi(values[0].c_str());
+                if (values.size() > 1)
+                    options.materialPlies = std::atoi(values[1].c_str());
+            }
+            else
+            {
+                std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        }
+
+        if (options.maxGames <= 0)
+        {
+            std::cerr << "--games must be positive" << std::endl;
+            return 1;
+        }
+        if (options.useSprt && options.openings.empty())
+        {
+            std::cerr << "SPRT needs --openings FILE; pass --no-sprt to play random openings instead" << std::endl;
+            return 1;
+        }
+
+        MatchRunner runner(options);
+        MatchResult result = runner.run(std::cout);
+        return (result.decision == MatchResult::SprtDecision::AcceptH0) ? 2 : 0;
+    }
+    int runPgn(int argc, char* argv[])
+    {
+        if (argc < 3)
+        {
+            printUsage();
+            return 1;
+        }
+        std::string outPath;
+        for (int i = 3; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--out" && i + 1 < argc)
+                outPath = argv[++i];
+            else
+            {
+                std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        }
+
+        std::ifstream in(argv[2], std::ios::binary);
+        if (!in)
+        {
+            std::cerr << "Cannot open " << argv[2] << std::endl;
+            return 1;
+        }
+        std::ofstream out;
+        if (!outPath.empty())
+        {
+            out.open(outPath);
+            if (!out)
+            {
+                std::cerr << "Cannot create " << outPath << std::endl;
+                return 1;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        PgnReader reader(in);
+        PgnGame game;
+        uint64_t moves = 0;
+        uint64_t errors = 0;
+        while (reader.next(game))
+        {
+            moves += game.moves.size();
+            if (!game.error.empty())
+            {
+                // Only the first few; a broken export can fail on every game
+                if (errors < 10)
+                    std::cerr << "game " << reader.gamesRead() << ": " << game.error << std::endl;
+                errors++;
+            }
+            if (out.is_open())
+                writePgn(out, game);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << reader.gamesRead() << " games, " << moves << " moves, " << errors << " with errors in "
+                  << seconds << " s (" << static_cast<uint64_t>(reader.gamesRead() / std::max(seconds, 1e-9))
+                  << " games/s, " << reader.bytesRead() / std::max(seconds, 1e-9) / 1e6 << " MB/s)" << std::endl;
+        return errors ? 2 : 0;
+    }
+
+    int runDbImport(int argc, char* argv[])
+    {
+        if (argc < 5)
+        {
+            printUsage();
+            return 1;
+        }
+        int threads = 0;
+        size_t memoryMb = 1024;
+        for (int i = 5; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--threads" && i + 1 < argc)
+                threads = std::atoi(argv[++i]);
+            else if (arg == "--memory" && i + 1 < argc)
+                memoryMb = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+            else
+            {
+                std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        }
+
+        std::ifstream in(argv[3], std::ios::binary);
+        if (!in)
+        {
+            std::cerr << "Cannot open " << argv[3] << std::endl;
+            return 1;
+        }
+        GameDatabaseWriter writer;
+        if (!writer.create(argv[4]))
+            return 1;
+
+        auto start = std::chrono::steady_clock::now();
+        PgnReader reader(in);
+        PgnGame game;
+        uint64_t truncated = 0;
+        while (reader.next(game))
+        {
+            if (!game.error.empty())
+                truncated++;
+            if (!writer.add(game))
+                return 1;
+        }
+        if (!writer.finish())
+            return 1;
+        double importSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << writer.gameCount() << " games stored (" << truncated << " truncated at an illegal move) in "
+                  << importSeconds << " s" << std::endl;
+
+        start = std::chrono::steady_clock::now();
+        GameDatabase database;
+        if (!database.open(argv[4]) || !database.buildIndex(threads, memoryMb << 20))
+            return 1;
+        double indexSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << database.positionCount() << " positions indexed in " << indexSeconds << " s" << std::endl;
+
+        start = std::chrono::steady_clock::now();
+        std::string bookPath = OpeningExplorer::defaultPath(argv[4]);
+        OpeningExplorer explorer;
+        if (!OpeningExplorer::build(database, bookPath) || !explorer.open(bookPath))
+            return 1;
+        double bookSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << explorer.positionCount() << " opening positions in " << bookPath << " (" << bookSeconds << " s)"
+                  << std::endl;
+        return 0;
+    }
+
+    int runDbFind(int argc, char* argv[])
+    {
+        if (argc < 4)
+        {
+            printUsage();
+            return 1;
+        }
+        std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+        size_t limit = 20;
+        for (int i = 4; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--fen" && i + 1 < argc)
+                fen = argv[++i];
+            else if (arg == "--limit" && i + 1 < argc)
+                limit = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+            else
+            {
+                std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        }
+
+        Board board;
+        if (!board.loadFEN(fen))
+        {
+            std::cerr << "Invalid FEN: " << fen << std::endl;
+            return 1;
+        }
+        GameDatabase database;
+        if (!database.open(argv[3]))
+            return 1;
+        if (!database.hasIndex())
+        {
+            std::cerr << "No current position index for " << argv[3] << "; run db import again" << std::endl;
+            return 1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        GameDatabase::PositionRange hits = database.find(board.getZobristKey());
+        double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        std::cout << hits.size() << " occurrences (" << micros << " us)" << std::endl;
+
+        PgnGame game;
+        size_t shown = 0;
+        for (const PositionEntry& hit : hits)
+        {
+            if (shown++ == limit)
+                break;
+            database.readGame(hit.game, game);
+            const std::string* white = game.tag("White");
+            const std::string* black = game.tag("Black");
+            std::cout << "game " << hit.game << " ply " << hit.ply << ": " << (white ? *white : "?") << " - "
+                      << (black ? *black : "?") << " " << game.result << std::endl;
+        }
+        return 0;
+    }
+
+    int runDbExplore(int argc, char* argv[])
+    {
+        if (argc < 4)
+        {
+            printUsage();
+            return 1;
+        }
+        std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+        for (int i = 4; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--fen" && i + 1 < argc)
+                fen = argv[++i];
+            else
+            {
+                std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        }
+
+        Board board;
+        if (!board.loadFEN(fen))
+        {
+            std::cerr << "Invalid FEN: " << fen << std::endl;
+            return 1;
+        }
+        OpeningExplorer explorer;
+        std::string bookPath = OpeningExplorer::defaultPath(argv[3]);
+        if (!explorer.open(bookPath))
+        {
+            std::cerr << "No opening table at " << bookPath << "; run db import again" << std::endl;
+            return 1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        OpeningExplorer::MoveRange moves = explorer.find(board.getZobristKey());
+        double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        uint32_t total = moves.games();
+        std::cout << total << " games, " << moves.size() << " moves (" << micros << " us)" << std::endl;
+
+        char line[128];
+        for (const ExplorerMove& move : moves)
+        {
+            std::snprintf(line, sizeof(line), "%-8s %8u %5.1f%%  +%u =%u -%u  elo %u  last %04u.%02u.%02u (game %u)",
+                          moveToSan(board, Move::fromRaw(move.move)).c_str(), move.games, 100.0 * move.games / total,
+                          move.whiteWins, move.draws, move.blackWins, move.averageElo, move.lastDate / 10000,
+                          move.lastDate / 100 % 100, move.lastDate % 100, move.lastGame);
+            std::cout << line << std::endl;
+        }
+        return 0;
+    }
+
+    int runDb(int argc, char* argv[])
+    {
+        std::string action = argc > 2 ? argv[2] : "";
+        if (action == "import")
+            return runDbImport(argc, argv);
+        if (action == "find")
+            return runDbFind(argc, argv);
+        if (action == "explore")
+            return runDbExplore(argc, argv);
+        printUsage();
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::string command = argv[1];
+    if (command == "search")
+        return runSearch(argc, argv);
+    if (command == "bench")
+        return runBenchCommand(argc, argv);
+    if (command == "match")
+        return runMatch(argc, argv);
+    if (command == "perft")
+        return runPerftCommand(argc, argv);
+    if (command == "validate")
+        return runValidate(argc, argv);
+    if (command == "pgn")
+        return runPgn(argc, argv);
+    if (command == "db")
+        return runDb(argc, argv);
+
+    std::cerr << "Unknown command: " << command << std::endl;
+    printUsage();
+    return 1;
+}
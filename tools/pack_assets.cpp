@@ -0,0 +1,86 @@
+// Packs every BMP in a directory into the asset pack the game loads at startup
+#include "AssetPack.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // RGBA bytes with magenta keyed out, the same key Game has always used
+    bool loadKeyedPixels(const std::string& path, int& width, int& height, std::vector<uint32_t>& pixels)
+    {
+        SDL_Surface* loaded = SDL_LoadBMP(path.c_str());
+        if (!loaded)
+        {
+            std::cerr << "Failed to load image: " << path << std::endl;
+            return false;
+        }
+        SDL_Surface* surface = SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_RGBA32);
+        SDL_DestroySurface(loaded);
+        if (!surface)
+        {
+            std::cerr << "Failed to convert image: " << path << std::endl;
+            return false;
+        }
+
+        width = surface->w;
+        height = surface->h;
+        pixels.resize(static_cast<size_t>(width) * height);
+        for (int y = 0; y < height; y++)
+        {
+            const uint8_t* row = static_cast<const uint8_t*>(surface->pixels) + static_cast<size_t>(y) * surface->pitch;
+            for (int x = 0; x < width; x++)
+            {
+                uint8_t rgba[4];
+                std::memcpy(rgba, row + x * 4, 4);
+                if (rgba[0] == 255 && rgba[1] == 0 && rgba[2] == 255)
+                    std::memset(rgba, 0, 4);
+                std::memcpy(&pixels[static_cast<size_t>(y) * width + x], rgba, 4);
+            }
+        }
+        SDL_DestroySurface(surface);
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: pack_assets <image directory> <output pack>" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> files;
+    std::error_code error;
+    for (const auto& item : std::filesystem::directory_iterator(argv[1], error))
+    {
+        if (item.is_regular_file() && item.path().extension() == ".bmp")
+            files.push_back(item.path().filename().string());
+    }
+    if (error)
+    {
+        std::cerr << "Cannot read " << argv[1] << ": " << error.message() << std::endl;
+        return 1;
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<std::vector<uint32_t>> pixels(files.size());
+    std::vector<AssetImage> images(files.size());
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        std::string path = (std::filesystem::path(argv[1]) / files[i]).string();
+        if (!loadKeyedPixels(path, images[i].width, images[i].height, pixels[i]))
+            return 1;
+        images[i].name = files[i];
+        images[i].pixels = pixels[i].data();
+    }
+
+    if (!AssetPack::write(argv[2], images))
+        return 1;
+    std::cout << "Packed " << images.size() << " images into " << argv[2] << std::endl;
+    return 0;
+}